@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <ostream>
+#include <algorithm>
+
+/**
+ * @brief
+ * Small benchmark harness without any UI.
+ * A benchmark function is called in a loop until the minimum time is reached.
+ * This is repeated several times and the median time per operation is reported.
+ * The results can be written as JSON or CSV to track regressions between releases.
+ */
+class BenchmarkRunner
+{
+public:
+	struct Result
+	{
+		std::string group;
+		std::string name;
+		std::string parameter;
+		size_t repetitions = 0;
+		size_t iterationsPerRepetition = 0;
+		double operationsPerIteration = 1;
+		double medianNsPerOperation = 0;
+		double minNsPerOperation = 0;
+		double maxNsPerOperation = 0;
+	};
+
+	/**
+	 * @brief
+	 * Runs one iteration of a benchmark
+	 */
+	typedef std::function<void()> IterationFunc;
+
+	/**
+	 * @param minTime minimal duration of one repetition in seconds
+	 */
+	void setMinTime(double minTime) { m_minTime = minTime; }
+	double getMinTime() const { return m_minTime; }
+	void setRepetitions(size_t repetitions) { m_repetitions = std::max<size_t>(1, repetitions); }
+	size_t getRepetitions() const { return m_repetitions; }
+
+	/**
+	 * @brief
+	 * Only benchmarks whose "group/name/parameter" contains the filter are run
+	 */
+	void setFilter(const std::string& filter) { m_filter = filter; }
+	const std::string& getFilter() const { return m_filter; }
+
+	bool isEnabled(const std::string& group, const std::string& name, const std::string& parameter) const;
+
+	/**
+	 * @brief
+	 * Measures the function and stores the result.
+	 * @param operationsPerIteration number of operations one call of func does, the result is normalized to it
+	 */
+	void run(const std::string& group, const std::string& name, const std::string& parameter,
+		double operationsPerIteration, const IterationFunc& func);
+
+	const std::vector<Result>& getResults() const { return m_results; }
+
+	void writeJson(std::ostream& stream) const;
+	void writeCsv(std::ostream& stream) const;
+	void printSummary(std::ostream& stream) const;
+
+	/**
+	 * @brief
+	 * Keeps the compiler from removing a computation whose result is not used otherwise
+	 */
+	static void doNotOptimize(double value);
+
+private:
+	static std::string escapeJson(const std::string& str);
+
+	double m_minTime = 0.2;
+	size_t m_repetitions = 5;
+	std::string m_filter;
+	std::vector<Result> m_results;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "BenchmarkRunner.h"
+
+/**
+ * @brief
+ * PID, PIDBatch, the StatespaceSystem integration solvers and the FrequencyResponse methods
+ */
+void runSystemBenchmarks(BenchmarkRunner& runner);
+
+/**
+ * @brief
+ * One epoch (test + iterate) of the GeneticSolver, the DifferentialEvolutionSolver, the CMAESSolver and the NSGA2Solver at several population sizes
+ */
+void runSolverBenchmarks(BenchmarkRunner& runner);
+
+/**
+ * @brief
+ * Closed loop step response scoring of a PID controlled DC motor, like DCMotorProblem does per agent
+ */
+void runScoringBenchmarks(BenchmarkRunner& runner);
@@ -0,0 +1,135 @@
+#include "BenchmarkRunner.h"
+#include "AutoTuner.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+	volatile double s_sink = 0;
+}
+
+bool BenchmarkRunner::isEnabled(const std::string& group, const std::string& name, const std::string& parameter) const
+{
+	if (m_filter.empty())
+		return true;
+	std::string id = group + "/" + name + "/" + parameter;
+	return id.find(m_filter) != std::string::npos;
+}
+
+void BenchmarkRunner::run(const std::string& group, const std::string& name, const std::string& parameter,
+	double operationsPerIteration, const IterationFunc& func)
+{
+	if (!isEnabled(group, name, parameter))
+		return;
+	typedef std::chrono::steady_clock Clock;
+
+	auto measure = [&func](size_t iterations)
+		{
+			auto start = Clock::now();
+			for (size_t i = 0; i < iterations; ++i)
+				func();
+			return std::chrono::duration<double>(Clock::now() - start).count();
+		};
+
+	// Warm up and find the iteration count that takes at least the minimum time
+	size_t iterations = 1;
+	double elapsed = measure(iterations);
+	while (elapsed < m_minTime)
+	{
+		double factor = elapsed > 0 ? std::min(10.0, 1.2 * m_minTime / elapsed) : 10.0;
+		iterations = std::max(iterations + 1, static_cast<size_t>(iterations * factor));
+		elapsed = measure(iterations);
+	}
+
+	std::vector<double> nsPerOperation;
+	nsPerOperation.reserve(m_repetitions);
+	for (size_t r = 0; r < m_repetitions; ++r)
+		nsPerOperation.push_back(measure(iterations) * 1e9 / (iterations * operationsPerIteration));
+	std::sort(nsPerOperation.begin(), nsPerOperation.end());
+
+	Result result;
+	result.group = group;
+	result.name = name;
+	result.parameter = parameter;
+	result.repetitions = m_repetitions;
+	result.iterationsPerRepetition = iterations;
+	result.operationsPerIteration = operationsPerIteration;
+	result.medianNsPerOperation = nsPerOperation[nsPerOperation.size() / 2];
+	result.minNsPerOperation = nsPerOperation.front();
+	result.maxNsPerOperation = nsPerOperation.back();
+	m_results.push_back(result);
+
+	std::cout << std::left << std::setw(12) << group << std::setw(36) << name << std::setw(20) << parameter
+		<< std::right << std::setw(16) << std::fixed << std::setprecision(2) << result.medianNsPerOperation << " ns/op\n";
+}
+
+void BenchmarkRunner::writeJson(std::ostream& stream) const
+{
+	stream << "{\n";
+	stream << "  \"library\": \"" << AutoTuner::LibraryInfo::name << "\",\n";
+	stream << "  \"version\": \"" << AutoTuner::LibraryInfo::version.toString() << "\",\n";
+	stream << "  \"compiler\": \"" << escapeJson(std::string(AutoTuner::LibraryInfo::compiler) + " " + AutoTuner::LibraryInfo::compilerVersion) << "\",\n";
+	stream << "  \"buildType\": \"" << AutoTuner::LibraryInfo::buildTypeStr << "\",\n";
+	stream << "  \"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n";
+	stream << "  \"results\": [\n";
+	stream << std::setprecision(6);
+	for (size_t i = 0; i < m_results.size(); ++i)
+	{
+		const Result& result = m_results[i];
+		stream << "    { \"group\": \"" << escapeJson(result.group)
+			<< "\", \"name\": \"" << escapeJson(result.name)
+			<< "\", \"parameter\": \"" << escapeJson(result.parameter)
+			<< "\", \"repetitions\": " << result.repetitions
+			<< ", \"iterations\": " << result.iterationsPerRepetition
+			<< ", \"operationsPerIteration\": " << result.operationsPerIteration
+			<< ", \"medianNsPerOp\": " << result.medianNsPerOperation
+			<< ", \"minNsPerOp\": " << result.minNsPerOperation
+			<< ", \"maxNsPerOp\": " << result.maxNsPerOperation << " }"
+			<< (i + 1 < m_results.size() ? ",\n" : "\n");
+	}
+	stream << "  ]\n";
+	stream << "}\n";
+}
+
+void BenchmarkRunner::writeCsv(std::ostream& stream) const
+{
+	stream << "group;name;parameter;repetitions;iterations;operationsPerIteration;medianNsPerOp;minNsPerOp;maxNsPerOp\n";
+	stream << std::setprecision(6);
+	for (const Result& result : m_results)
+	{
+		stream << result.group << ";" << result.name << ";" << result.parameter << ";"
+			<< result.repetitions << ";" << result.iterationsPerRepetition << ";" << result.operationsPerIteration << ";"
+			<< result.medianNsPerOperation << ";" << result.minNsPerOperation << ";" << result.maxNsPerOperation << "\n";
+	}
+}
+
+void BenchmarkRunner::printSummary(std::ostream& stream) const
+{
+	stream << m_results.size() << " benchmarks, "
+		<< m_repetitions << " repetitions of at least " << m_minTime << " s each\n";
+}
+
+void BenchmarkRunner::doNotOptimize(double value)
+{
+	s_sink = value;
+}
+
+std::string BenchmarkRunner::escapeJson(const std::string& str)
+{
+	std::string escaped;
+	escaped.reserve(str.size());
+	for (char c : str)
+	{
+		switch (c)
+		{
+			case '"':  escaped += "\\\""; break;
+			case '\\': escaped += "\\\\"; break;
+			case '\n': escaped += "\\n"; break;
+			default:   escaped += c; break;
+		}
+	}
+	return escaped;
+}
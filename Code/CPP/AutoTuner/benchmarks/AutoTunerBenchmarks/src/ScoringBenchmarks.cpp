@@ -0,0 +1,159 @@
+#include "Benchmarks.h"
+#include "AutoTuner.h"
+#include <random>
+
+using namespace AutoTuner;
+
+namespace
+{
+	// DC motor from the SimpleMotorTuner example: K1 / (T*s + 1)
+	const double s_k1 = 1.0;
+	const double s_invTimeConstant = 1.0 / 0.14;
+	const double s_actuatorLimit = 10.0;
+
+	const double s_deltaTime = 0.001;
+	const double s_endTime = 2.0;
+	const size_t s_agentCount = 64;
+
+	double getSetpoint(double t)
+	{
+		return t < 1.0 ? 1.0 : 0.5;
+	}
+
+	struct Gains
+	{
+		double kp;
+		double ki;
+		double kd;
+	};
+
+	std::vector<Gains> getAgentGains()
+	{
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<double> dist(0, 1);
+		std::vector<Gains> gains(s_agentCount);
+		for (Gains& g : gains)
+			g = { 0.5 + dist(rng) * 5, dist(rng) * 20, dist(rng) * 0.05 };
+		return gains;
+	}
+
+	/**
+	 * @brief
+	 * Step response score of one agent: error integral, actuator effort and overshoot
+	 */
+	double scoreAgent(const Gains& gains)
+	{
+		PID pid(gains.kp, gains.ki, gains.kd, 100);
+		pid.setDerivativeType(PID::DerivativeType::Filtered);
+		pid.setAntiWindupMethod(PID::AntiWindupMethod::BackCalculation);
+		pid.setOutputSaturationLimits(0, s_actuatorLimit);
+
+		double integratorOutput = 0;
+		double lastPreIntegratorSignal = 0;
+		double lastPIDOutput = 0;
+		double lastSpeed = 0;
+		double errorSum = 0;
+		double effortSum = 0;
+		double overshootSum = 0;
+		for (double t = 0; t < s_endTime; t += s_deltaTime)
+		{
+			double r = getSetpoint(t);
+			pid.setInput(r - integratorOutput);
+			pid.update(s_deltaTime);
+			double u = pid.getOutput();
+
+			double preIntegratorSignal = (s_k1 * u - integratorOutput) * s_invTimeConstant;
+			integratorOutput = TimeBasedSystem::getIntegrated_Bilinear(lastPreIntegratorSignal, preIntegratorSignal, integratorOutput, s_deltaTime);
+			lastPreIntegratorSignal = preIntegratorSignal;
+
+			effortSum += std::abs(TimeBasedSystem::getDifferentiated_backwardEuler(lastPIDOutput, u, s_deltaTime));
+			lastPIDOutput = u;
+			errorSum += std::abs(r - integratorOutput);
+			if (integratorOutput > r && lastSpeed > r)
+				overshootSum += integratorOutput - r;
+			lastSpeed = integratorOutput;
+		}
+		double invUpdateCount = s_deltaTime / s_endTime;
+		return (errorSum + effortSum / s_actuatorLimit + overshootSum) * invUpdateCount;
+	}
+
+	/**
+	 * @brief
+	 * Same score for all agents in lockstep, using PIDBatch and plant state rows
+	 */
+	void scoreAgents(const std::vector<Gains>& gains, PIDBatch& pids, std::vector<double>& scores)
+	{
+		const size_t count = gains.size();
+		pids.resize(count);
+		pids.reset();
+		pids.setDerivativeType(PID::DerivativeType::Filtered);
+		pids.setAntiWindupMethod(PID::AntiWindupMethod::BackCalculation);
+		pids.setOutputSaturationLimits(0, s_actuatorLimit);
+		for (size_t i = 0; i < count; ++i)
+			pids.setParameters(i, gains[i].kp, gains[i].ki, gains[i].kd, 100);
+
+		std::vector<double> integratorOutput(count, 0.0);
+		std::vector<double> lastPreIntegratorSignal(count, 0.0);
+		std::vector<double> lastPIDOutput(count, 0.0);
+		std::vector<double> lastSpeed(count, 0.0);
+		std::vector<double> errorSum(count, 0.0);
+		std::vector<double> effortSum(count, 0.0);
+		std::vector<double> overshootSum(count, 0.0);
+		const double invDeltaTime = 1.0 / s_deltaTime;
+		for (double t = 0; t < s_endTime; t += s_deltaTime)
+		{
+			double r = getSetpoint(t);
+			double* inputs = pids.getInputs();
+			for (size_t i = 0; i < count; ++i)
+				inputs[i] = r - integratorOutput[i];
+			pids.update(s_deltaTime);
+			const double* outputs = pids.getOutputs();
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				double u = outputs[i];
+				double preIntegratorSignal = (s_k1 * u - integratorOutput[i]) * s_invTimeConstant;
+				double y = integratorOutput[i] + (lastPreIntegratorSignal[i] + preIntegratorSignal) * (s_deltaTime * 0.5);
+				lastPreIntegratorSignal[i] = preIntegratorSignal;
+				integratorOutput[i] = y;
+
+				effortSum[i] += std::abs(u - lastPIDOutput[i]) * invDeltaTime;
+				lastPIDOutput[i] = u;
+				errorSum[i] += std::abs(r - y);
+				overshootSum[i] += (y > r && lastSpeed[i] > r) ? y - r : 0.0;
+				lastSpeed[i] = y;
+			}
+		}
+		double invUpdateCount = s_deltaTime / s_endTime;
+		scores.resize(count);
+		for (size_t i = 0; i < count; ++i)
+			scores[i] = (errorSum[i] + effortSum[i] / s_actuatorLimit + overshootSum[i]) * invUpdateCount;
+	}
+}
+
+void runScoringBenchmarks(BenchmarkRunner& runner)
+{
+	std::vector<Gains> gains = getAgentGains();
+
+	// Time per scored agent
+	runner.run("scoring", "DCMotor step response", "scalar", static_cast<double>(gains.size()), [&]()
+		{
+			double sum = 0;
+			for (const Gains& g : gains)
+				sum += scoreAgent(g);
+			BenchmarkRunner::doNotOptimize(sum);
+		});
+
+	PIDBatch pids;
+	std::vector<double> scores;
+	for (PIDBatch::Precision precision : { PIDBatch::Precision::Strict, PIDBatch::Precision::Fast })
+	{
+		pids.setPrecision(precision);
+		std::string parameter = std::string("batch ") + (precision == PIDBatch::Precision::Strict ? "strict" : "fast");
+		runner.run("scoring", "DCMotor step response", parameter, static_cast<double>(gains.size()), [&]()
+			{
+				scoreAgents(gains, pids, scores);
+				BenchmarkRunner::doNotOptimize(scores[0]);
+			});
+	}
+}
@@ -0,0 +1,240 @@
+#include "Benchmarks.h"
+#include "AutoTuner.h"
+#include <random>
+#include <thread>
+#include <atomic>
+
+using namespace AutoTuner;
+
+namespace
+{
+	const size_t s_parameterCount = 4;
+	const size_t s_populationSizes[] = { 32, 128, 512 };
+	const size_t s_scalingPopulationSize = 4096;
+	const size_t s_scalingIslandCount = 64;
+	const size_t s_selectionPopulationSize = 10000;
+	const size_t s_unevenPopulationSize = 256;
+
+	/**
+	 * @brief
+	 * Cheap objective, so the epoch time is dominated by the solver itself
+	 */
+	std::vector<double> sphereScore(const std::vector<double>& parameters, size_t)
+	{
+		double sum = 0;
+		double spread = 0;
+		for (size_t i = 0; i < parameters.size(); ++i)
+		{
+			double offset = parameters[i] - 1.0;
+			sum += offset * offset;
+			spread += std::abs(offset);
+		}
+		return { sum, spread * 0.01 };
+	}
+
+	/**
+	 * @brief
+	 * Objective whose evaluation time varies by two orders of magnitude between the calls.
+	 * The time does not depend on the parameters, so both solver modes get the same mix of slow and fast calls.
+	 */
+	std::vector<double> unevenScore(const std::vector<double>& parameters, size_t agentIndex)
+	{
+		static std::atomic<size_t> callCount{ 0 };
+		double fraction = std::fmod(static_cast<double>(callCount.fetch_add(1)) * 0.6180339887, 1.0);
+		size_t iterations = static_cast<size_t>(100.0 * std::pow(100.0, fraction));
+		double work = 0;
+		for (size_t i = 0; i < iterations; ++i)
+			work += std::sin(static_cast<double>(i + agentIndex));
+		BenchmarkRunner::doNotOptimize(work);
+		return sphereScore(parameters, agentIndex);
+	}
+
+	std::vector<std::vector<double>> getInitialParameters(size_t count)
+	{
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<double> dist(-5, 5);
+		std::vector<std::vector<double>> parameters(count, std::vector<double>(s_parameterCount));
+		for (auto& agent : parameters)
+			for (double& value : agent)
+				value = dist(rng);
+		return parameters;
+	}
+
+	void setupSolver(Solver& solver, size_t populationSize)
+	{
+		solver.setSeed(1);
+		solver.setOptimizingDirection(Solver::OptimizingDirection::Minimize);
+		solver.setScorePartsLabels({ "Sum", "Spread" });
+		solver.setParametersTestFunc(&sphereScore);
+		solver.setInitialParameters(getInitialParameters(populationSize));
+	}
+
+	/**
+	 * @brief
+	 * Building the table and drawing the parents of one generation, time per drawn parent
+	 */
+	void runSelectionBenchmarks(BenchmarkRunner& runner)
+	{
+		std::vector<double> scores(s_selectionPopulationSize);
+		RandomStream scoreRandom(42);
+		scoreRandom.fillUniform(scores.data(), scores.size(), 0, 1);
+
+		for (SelectionTable::Method method : { SelectionTable::Method::PrefixSum, SelectionTable::Method::Alias,
+											   SelectionTable::Method::Tournament, SelectionTable::Method::StochasticUniversal })
+		{
+			SelectionTable table;
+			table.setMethod(method);
+			RandomStream random(1);
+			const size_t drawCount = scores.size();
+			runner.run("solver", "SelectionTable", SelectionTable::methodToString(method) + ", " + std::to_string(scores.size()),
+				static_cast<double>(drawCount), [&]()
+				{
+					table.build(scores.data(), scores.size(), drawCount, random);
+					size_t sum = 0;
+					for (size_t i = 0; i < drawCount; ++i)
+						sum += table.draw(i, random);
+					BenchmarkRunner::doNotOptimize(static_cast<double>(sum));
+				});
+		}
+	}
+
+	/**
+	 * @brief
+	 * Epoch time of a large population on 1 to N worker threads, as one population and split into islands.
+	 * Testing and breeding both run on the scheduler, the results are identical for every thread count.
+	 */
+	void runScalingBenchmarks(BenchmarkRunner& runner)
+	{
+		size_t maxThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+		std::vector<size_t> threadCounts;
+		for (size_t threads = 1; threads < maxThreads; threads *= 2)
+			threadCounts.push_back(threads);
+		threadCounts.push_back(maxThreads);
+
+		for (size_t threads : threadCounts)
+		{
+			std::string parameter = std::to_string(s_scalingPopulationSize) + " agents, " + std::to_string(threads) + " threads";
+			if (!runner.isEnabled("solver", "GeneticSolver epoch scaling", parameter))
+				continue;
+			TaskScheduler scheduler(threads);
+			GeneticSolver solver;
+			solver.setTaskScheduler(&scheduler);
+			setupSolver(solver, s_scalingPopulationSize);
+			runner.run("solver", "GeneticSolver epoch scaling", parameter, 1, [&]()
+				{
+					solver.test();
+					solver.iterate();
+				});
+		}
+
+		// Same population split into islands, one scheduler task per island and call
+		for (size_t threads : threadCounts)
+		{
+			std::string parameter = std::to_string(s_scalingPopulationSize) + " agents, " + std::to_string(s_scalingIslandCount) +
+				" islands, " + std::to_string(threads) + " threads";
+			if (!runner.isEnabled("solver", "GeneticSolver island scaling", parameter))
+				continue;
+			TaskScheduler scheduler(threads);
+			GeneticSolver solver;
+			solver.setTaskScheduler(&scheduler);
+			solver.setIslandCount(s_scalingIslandCount);
+			setupSolver(solver, s_scalingPopulationSize);
+			runner.run("solver", "GeneticSolver island scaling", parameter, 1, [&]()
+				{
+					solver.test();
+					solver.iterate();
+				});
+		}
+	}
+
+	/**
+	 * @brief
+	 * Epoch time with uneven evaluation times on all threads, with and without the generation barrier.
+	 * Both modes test one population size of children per epoch.
+	 */
+	void runSteadyStateBenchmarks(BenchmarkRunner& runner)
+	{
+		for (bool steadyState : { false, true })
+		{
+			std::string parameter = std::to_string(s_unevenPopulationSize) + (steadyState ? " agents, steady-state" : " agents, generational");
+			if (!runner.isEnabled("solver", "GeneticSolver uneven epoch", parameter))
+				continue;
+			GeneticSolver solver;
+			solver.setSteadyStateEnabled(steadyState);
+			setupSolver(solver, s_unevenPopulationSize);
+			solver.setParametersTestFunc(&unevenScore);
+			runner.run("solver", "GeneticSolver uneven epoch", parameter, 1, [&]()
+				{
+					solver.test();
+					solver.iterate();
+				});
+		}
+	}
+}
+
+void runSolverBenchmarks(BenchmarkRunner& runner)
+{
+	for (size_t populationSize : s_populationSizes)
+	{
+		std::string parameter = std::to_string(populationSize);
+		if (runner.isEnabled("solver", "GeneticSolver epoch", parameter))
+		{
+			GeneticSolver solver;
+			setupSolver(solver, populationSize);
+			runner.run("solver", "GeneticSolver epoch", parameter, 1, [&]()
+				{
+					solver.test();
+					solver.iterate();
+				});
+		}
+		if (runner.isEnabled("solver", "DifferentialEvolution epoch", parameter))
+		{
+			DifferentialEvolutionSolver solver;
+			setupSolver(solver, populationSize);
+			runner.run("solver", "DifferentialEvolution epoch", parameter, 1, [&]()
+				{
+					solver.test();
+					solver.iterate();
+				});
+		}
+		if (runner.isEnabled("solver", "CMAES epoch", parameter))
+		{
+			CMAESSolver solver;
+			// Restarts would grow the population during the measurement
+			solver.setRestartStrategy(CMAESSolver::RestartStrategy::None);
+			solver.setPopulationSize(populationSize);
+			setupSolver(solver, populationSize);
+			runner.run("solver", "CMAES epoch", parameter, 1, [&]()
+				{
+					solver.test();
+					solver.iterate();
+				});
+		}
+		if (runner.isEnabled("solver", "NSGA2 epoch", parameter))
+		{
+			NSGA2Solver solver;
+			setupSolver(solver, populationSize);
+			runner.run("solver", "NSGA2 epoch", parameter, 1, [&]()
+				{
+					solver.test();
+					solver.iterate();
+				});
+		}
+		if (runner.isEnabled("solver", "GeneticSolver surrogate epoch", parameter))
+		{
+			// Training, fitting and screening a pool of 4 candidates per agent
+			GeneticSolver solver;
+			solver.setSurrogatePoolSize(4);
+			setupSolver(solver, populationSize);
+			runner.run("solver", "GeneticSolver surrogate epoch", parameter, 1, [&]()
+				{
+					solver.test();
+					solver.iterate();
+				});
+		}
+	}
+
+	runSelectionBenchmarks(runner);
+	runScalingBenchmarks(runner);
+	runSteadyStateBenchmarks(runner);
+}
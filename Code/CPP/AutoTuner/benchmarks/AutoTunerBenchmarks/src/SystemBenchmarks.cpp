@@ -0,0 +1,225 @@
+#include "Benchmarks.h"
+#include "AutoTuner.h"
+
+using namespace AutoTuner;
+
+namespace
+{
+	const size_t s_stepsPerIteration = 1000;
+	const double s_deltaTime = 0.001;
+
+	/**
+	 * @brief
+	 * Third order plant 60 * (1 + 0.2 s) / ((s + 3)(s + 4)(s + 5)) in controllable canonical form
+	 */
+	void getTestPlant(MatlabAPI::Matrix& A, MatlabAPI::Matrix& B, MatlabAPI::Matrix& C, MatlabAPI::Matrix& D)
+	{
+		A = MatlabAPI::Matrix(3, 3);
+		B = MatlabAPI::Matrix(3, 1);
+		C = MatlabAPI::Matrix(1, 3);
+		D = MatlabAPI::Matrix(1, 1);
+		A(0, 1) = 1;
+		A(1, 2) = 1;
+		A(2, 0) = -60;
+		A(2, 1) = -47;
+		A(2, 2) = -12;
+		B(2, 0) = 60;
+		C(0, 0) = 1;
+		C(0, 1) = 0.2;
+	}
+
+	void runPIDBenchmarks(BenchmarkRunner& runner)
+	{
+		struct Config
+		{
+			const char* name;
+			PID::DerivativeType derivativeType;
+			PID::AntiWindupMethod antiWindupMethod;
+		};
+		const Config configs[] = {
+			{ "unfiltered", PID::DerivativeType::Unfiltered, PID::AntiWindupMethod::None },
+			{ "filtered", PID::DerivativeType::Filtered, PID::AntiWindupMethod::None },
+			{ "filtered+backCalc", PID::DerivativeType::Filtered, PID::AntiWindupMethod::BackCalculation },
+		};
+
+		for (const Config& config : configs)
+		{
+			PID pid(2, 5, 0.1, 50);
+			pid.setDerivativeType(config.derivativeType);
+			pid.setAntiWindupMethod(config.antiWindupMethod);
+			pid.setOutputSaturationLimits(-10, 10);
+			double input = 0;
+			runner.run("system", "PID::update", config.name, s_stepsPerIteration, [&]()
+				{
+					for (size_t i = 0; i < s_stepsPerIteration; ++i)
+					{
+						input = input > 1 ? -1 : input + 0.01;
+						pid.setInput(input);
+						pid.update(s_deltaTime);
+					}
+					BenchmarkRunner::doNotOptimize(pid.getOutput());
+				});
+		}
+
+		// Time per controller and step
+		for (size_t count : { 64, 1024 })
+		{
+			PIDBatch batch(count);
+			batch.setDerivativeType(PID::DerivativeType::Filtered);
+			batch.setAntiWindupMethod(PID::AntiWindupMethod::BackCalculation);
+			batch.setOutputSaturationLimits(-10, 10);
+			for (size_t i = 0; i < count; ++i)
+				batch.setParameters(i, 2 + i * 0.001, 5, 0.1, 50);
+
+			for (PIDBatch::Precision precision : { PIDBatch::Precision::Strict, PIDBatch::Precision::Fast })
+			{
+				batch.setPrecision(precision);
+				std::string parameter = std::to_string(count) + (precision == PIDBatch::Precision::Strict ? " strict" : " fast");
+				double input = 0;
+				const size_t steps = 100;
+				runner.run("system", "PIDBatch::update", parameter, static_cast<double>(steps * count), [&]()
+					{
+						double* inputs = batch.getInputs();
+						for (size_t step = 0; step < steps; ++step)
+						{
+							input = input > 1 ? -1 : input + 0.01;
+							for (size_t i = 0; i < count; ++i)
+								inputs[i] = input;
+							batch.update(s_deltaTime);
+						}
+						BenchmarkRunner::doNotOptimize(batch.getOutput(0));
+					});
+			}
+		}
+	}
+
+	void runStatespaceBenchmarks(BenchmarkRunner& runner)
+	{
+		MatlabAPI::Matrix A, B, C, D;
+		getTestPlant(A, B, C, D);
+
+		struct Config
+		{
+			const char* name;
+			TimeBasedSystem::IntegrationSolver solver;
+			TimeBasedSystem::C2DMethod c2dMethod;
+		};
+		const Config configs[] = {
+			{ "ForwardEuler", TimeBasedSystem::IntegrationSolver::ForwardEuler, TimeBasedSystem::C2DMethod::None },
+			{ "Bilinear", TimeBasedSystem::IntegrationSolver::Bilinear, TimeBasedSystem::C2DMethod::None },
+			{ "Rk4", TimeBasedSystem::IntegrationSolver::Rk4, TimeBasedSystem::C2DMethod::None },
+			{ "Discretized", TimeBasedSystem::IntegrationSolver::Discretized, TimeBasedSystem::C2DMethod::None },
+			{ "Discretized ZOH", TimeBasedSystem::IntegrationSolver::Discretized, TimeBasedSystem::C2DMethod::ZeroOrderHold },
+			{ "Discretized Tustin", TimeBasedSystem::IntegrationSolver::Discretized, TimeBasedSystem::C2DMethod::Tustin },
+		};
+
+		for (const Config& config : configs)
+		{
+			StatespaceSystem system;
+			system.setStateSpaceMatrices(A, B, C, D);
+			system.setIntegrationSolver(config.solver);
+			system.setC2DMethod(config.c2dMethod);
+			if (config.solver == TimeBasedSystem::IntegrationSolver::Discretized && config.c2dMethod == TimeBasedSystem::C2DMethod::None)
+			{
+				// Without a C2DMethod the matrices have to be discrete already
+				MatlabAPI::Matrix Ad, Bd;
+				StatespaceSystem zoh(system);
+				zoh.setC2DMethod(TimeBasedSystem::C2DMethod::ZeroOrderHold);
+				zoh.getDiscretizedMatrices(s_deltaTime, Ad, Bd);
+				system.setMatrixA(Ad);
+				system.setMatrixB(Bd);
+			}
+
+			double input = 0;
+			runner.run("system", "StatespaceSystem::update", config.name, s_stepsPerIteration, [&]()
+				{
+					for (size_t i = 0; i < s_stepsPerIteration; ++i)
+					{
+						input = input > 1 ? -1 : input + 0.01;
+						system.setInputSignals(input);
+						system.update(s_deltaTime);
+					}
+					BenchmarkRunner::doNotOptimize(system.getOutput(0));
+				});
+		}
+
+		for (TimeBasedSystem::IntegrationSolver solver : { TimeBasedSystem::IntegrationSolver::Rk4, TimeBasedSystem::IntegrationSolver::BackwardEuler })
+		{
+			StaticStatespaceSystem<3, 1, 1> system;
+			system.setStateSpaceMatrices(A, B, C, D);
+			system.setIntegrationSolver(solver);
+			double input = 0;
+			runner.run("system", "StaticStatespaceSystem::update", TimeBasedSystem::integrationSolverToString(solver), s_stepsPerIteration, [&]()
+				{
+					for (size_t i = 0; i < s_stepsPerIteration; ++i)
+					{
+						input = input > 1 ? -1 : input + 0.01;
+						system.setInputSignals(input);
+						system.update(s_deltaTime);
+					}
+					BenchmarkRunner::doNotOptimize(system.getOutput(0));
+				});
+		}
+	}
+
+	void runFrequencyResponseBenchmarks(BenchmarkRunner& runner)
+	{
+		MatlabAPI::Matrix A, B, C, D;
+		getTestPlant(A, B, C, D);
+		StatespaceSystem system;
+		system.setStateSpaceMatrices(A, B, C, D);
+		system.setIntegrationSolver(TimeBasedSystem::IntegrationSolver::Rk4);
+
+		struct Config
+		{
+			const char* name;
+			FrequencyResponse::Method method;
+			size_t workerCount;	// 0 uses the default scheduler
+		};
+		const Config configs[] = {
+			{ "Analytic", FrequencyResponse::Method::Analytic, 0 },
+			{ "TimeDomainSweep", FrequencyResponse::Method::TimeDomainSweep, 0 },
+			{ "ParallelSweep", FrequencyResponse::Method::ParallelSweep, 0 },
+			{ "ParallelSweep 1 worker", FrequencyResponse::Method::ParallelSweep, 1 },
+			{ "Multisine", FrequencyResponse::Method::Multisine, 0 },
+			{ "Chirp", FrequencyResponse::Method::Chirp, 0 },
+		};
+
+		// 0.1 Hz to 1000 Hz is the default Nyquist range of the tuning problems
+		struct Range
+		{
+			const char* name;
+			double startFrequency;
+			double endFrequency;
+		};
+		const Range ranges[] = {
+			{ "1-100 Hz", 1, 100 },
+			{ "0.1-1000 Hz", 0.1, 1000 },
+		};
+
+		for (const Range& range : ranges)
+		{
+			for (const Config& config : configs)
+			{
+				std::unique_ptr<TaskScheduler> scheduler;
+				if (config.workerCount > 0)
+					scheduler = std::make_unique<TaskScheduler>(config.workerCount);
+				FrequencyResponse response;
+				response.setMethod(config.method);
+				response.setTaskScheduler(scheduler.get());
+				runner.run("system", "FrequencyResponse::getResponse", std::string(config.name) + " " + range.name, 1, [&]()
+					{
+						FrequencyResponse::FrequencyResponseData data = response.getResponse(system, range.startFrequency, range.endFrequency);
+						BenchmarkRunner::doNotOptimize(data.phaseMargin);
+					});
+			}
+		}
+	}
+}
+
+void runSystemBenchmarks(BenchmarkRunner& runner)
+{
+	runPIDBenchmarks(runner);
+	runStatespaceBenchmarks(runner);
+	runFrequencyResponseBenchmarks(runner);
+}
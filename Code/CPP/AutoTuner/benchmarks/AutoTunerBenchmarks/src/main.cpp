@@ -0,0 +1,74 @@
+#include "AutoTuner.h"
+#include "Benchmarks.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+	void printUsage()
+	{
+		std::cout << "Usage: AutoTunerBenchmarks [options]\n"
+			<< "  --json <file>      write the results as JSON\n"
+			<< "  --csv <file>       write the results as CSV\n"
+			<< "  --filter <text>    only run benchmarks whose \"group/name/parameter\" contains the text\n"
+			<< "  --min-time <s>     minimal duration of one repetition, default 0.2\n"
+			<< "  --repetitions <n>  repetitions per benchmark, the median is reported, default 5\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	AutoTuner::LibraryInfo::printInfo();
+
+	BenchmarkRunner runner;
+	std::string jsonPath;
+	std::string csvPath;
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (std::strcmp(arg, "--json") == 0 && hasValue)
+			jsonPath = argv[++i];
+		else if (std::strcmp(arg, "--csv") == 0 && hasValue)
+			csvPath = argv[++i];
+		else if (std::strcmp(arg, "--filter") == 0 && hasValue)
+			runner.setFilter(argv[++i]);
+		else if (std::strcmp(arg, "--min-time") == 0 && hasValue)
+			runner.setMinTime(std::atof(argv[++i]));
+		else if (std::strcmp(arg, "--repetitions") == 0 && hasValue)
+			runner.setRepetitions(static_cast<size_t>(std::atoi(argv[++i])));
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	runSystemBenchmarks(runner);
+	runSolverBenchmarks(runner);
+	runScoringBenchmarks(runner);
+	runner.printSummary(std::cout);
+
+	if (!jsonPath.empty())
+	{
+		std::ofstream file(jsonPath);
+		if (!file)
+		{
+			std::cerr << "Can't open " << jsonPath << "\n";
+			return 1;
+		}
+		runner.writeJson(file);
+	}
+	if (!csvPath.empty())
+	{
+		std::ofstream file(csvPath);
+		if (!file)
+		{
+			std::cerr << "Can't open " << csvPath << "\n";
+			return 1;
+		}
+		runner.writeCsv(file);
+	}
+	return 0;
+}
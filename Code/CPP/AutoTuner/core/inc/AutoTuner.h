@@ -12,6 +12,8 @@
 #include "MatlabAPI.h"
 #include "QSFML_EditorWidget.h"
 
+#include "AutoTunerEngine.h"
+
 #include "Experiment/Experiment.h"
 #include "Experiment/Scope.h"
 
@@ -19,16 +21,39 @@
 #include "Components/ZieglerNichols.h"
 #include "Components/ChartViewComponent.h"
 #include "Components/NyquistPlotComponent.h"
-
-#include "GameObjects/Solver.h"
-#include "GameObjects/GeneticSolver.h"
-#include "GameObjects/DifferentialEvolutionSolver.h"
+#include "Components/SolverPainter.h"
+#include "Components/GeneticSolverPainter.h"
+#include "Components/DifferentialEvolutionSolverPainter.h"
+#include "Components/CMAESSolverPainter.h"
+#include "Components/NSGA2SolverPainter.h"
+
+#include "GameObjects/SolverObject.h"
+
+#include "Solvers/Solver.h"
+#include "Solvers/GeneticSolver.h"
+#include "Solvers/DifferentialEvolutionSolver.h"
+#include "Solvers/CMAESSolver.h"
+#include "Solvers/NSGA2Solver.h"
+#include "Solvers/SolverSnapshot.h"
+#include "Solvers/SolverWorker.h"
 
 #include "Utilities/TimeBasedSystem.h"
 #include "Utilities/TunableTimeBasedSystem.h"
+#include "Utilities/LinearAlgebra.h"
 #include "Utilities/StatespaceSystem.h"
+#include "Utilities/StaticStatespaceSystem.h"
 #include "Utilities/PID.h"
 #include "Utilities/CSVExport.h"
 #include "Utilities/FrequencyResponse.h"
+#include "Utilities/PopulationStore.h"
+#include "Utilities/TaskScheduler.h"
+#include "Utilities/PIDBatch.h"
+#include "Utilities/RandomStream.h"
+#include "Utilities/SelectionTable.h"
+#include "Utilities/FitnessCache.h"
+#include "Utilities/SpscQueue.h"
+#include "Utilities/RBFSurrogate.h"
+#include "Utilities/TripleBuffer.h"
+#include "Utilities/ObjectPool.h"
 
 /// USER_SECTION_END
\ No newline at end of file
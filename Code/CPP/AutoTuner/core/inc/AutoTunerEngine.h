@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+ * @brief
+ * Headless part of the library, the solvers and the utilities they need.
+ * Usable without QSFML and Qt, see the AutoTunerEngine target.
+ */
+#include "AutoTunerEngine_base.h"
+
+#include "Solvers/Solver.h"
+#include "Solvers/GeneticSolver.h"
+#include "Solvers/DifferentialEvolutionSolver.h"
+#include "Solvers/CMAESSolver.h"
+#include "Solvers/NSGA2Solver.h"
+#include "Solvers/SolverSnapshot.h"
+#include "Solvers/SolverWorker.h"
+
+#include "Utilities/PopulationStore.h"
+#include "Utilities/TaskScheduler.h"
+#include "Utilities/RandomStream.h"
+#include "Utilities/SelectionTable.h"
+#include "Utilities/FitnessCache.h"
+#include "Utilities/SpscQueue.h"
+#include "Utilities/RBFSurrogate.h"
+#include "Utilities/TripleBuffer.h"
+#include "Utilities/ObjectPool.h"
+#include "Utilities/LinearAlgebra.h"
@@ -0,0 +1,21 @@
+#pragma once
+
+/**
+ * @brief
+ * Base include of the solver engine.
+ * Unlike AutoTuner_base.h, it does not pull in QSFML or Qt,
+ * so the solvers and their utilities can be built into a headless library.
+ */
+#include "AutoTuner_global.h"
+#include "AutoTuner_debug.h"
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <cstdint>
+#include <cstring>
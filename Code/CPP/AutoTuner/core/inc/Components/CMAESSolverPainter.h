@@ -0,0 +1,25 @@
+#pragma once
+
+#include "AutoTuner_base.h"
+#include "Components/SolverPainter.h"
+#include "Solvers/CMAESSolver.h"
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Shows the samples, the score and step size history and the score parts of a CMAESSolver
+	 */
+	class AUTO_TUNER_API CMAESSolverPainter : public SolverPainter
+	{
+	public:
+		CMAESSolverPainter(const std::string& name = "CMAESSolverPainter");
+
+	protected:
+		void onSnapshotChanged(const SolverSnapshot& snapshot) const override;
+		void drawComponent(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+	private:
+		mutable std::vector<double> m_sigmaHistory;
+	};
+}
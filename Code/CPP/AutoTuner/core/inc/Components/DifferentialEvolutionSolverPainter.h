@@ -0,0 +1,21 @@
+#pragma once
+
+#include "AutoTuner_base.h"
+#include "Components/SolverPainter.h"
+#include "Solvers/DifferentialEvolutionSolver.h"
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Shows the population, the score history and the score parts of a DifferentialEvolutionSolver
+	 */
+	class AUTO_TUNER_API DifferentialEvolutionSolverPainter : public SolverPainter
+	{
+	public:
+		DifferentialEvolutionSolverPainter(const std::string& name = "DifferentialEvolutionSolverPainter");
+
+	protected:
+		void drawComponent(sf::RenderTarget& target, sf::RenderStates states) const override;
+	};
+}
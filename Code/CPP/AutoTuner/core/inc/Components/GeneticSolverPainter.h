@@ -0,0 +1,27 @@
+#pragma once
+
+#include "AutoTuner_base.h"
+#include "Components/SolverPainter.h"
+#include "Solvers/GeneticSolver.h"
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Shows the population, the score history and the score parts of a GeneticSolver
+	 */
+	class AUTO_TUNER_API GeneticSolverPainter : public SolverPainter
+	{
+	public:
+		GeneticSolverPainter(const std::string& name = "GeneticSolverPainter");
+
+	protected:
+		void onSnapshotChanged(const SolverSnapshot& snapshot) const override;
+		void drawComponent(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+	private:
+		mutable std::vector<std::string> m_piChartLabelStrings;
+		mutable std::vector<const char*> m_piChartLabels;
+		mutable std::vector<float> m_piChartData;
+	};
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "AutoTuner_base.h"
+#include "Components/SolverPainter.h"
+#include "Solvers/NSGA2Solver.h"
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Shows the population, the score history, the Pareto front and the score parts of a NSGA2Solver
+	 */
+	class AUTO_TUNER_API NSGA2SolverPainter : public SolverPainter
+	{
+	public:
+		NSGA2SolverPainter(const std::string& name = "NSGA2SolverPainter");
+
+	protected:
+		void onSnapshotChanged(const SolverSnapshot& snapshot) const override;
+		void drawComponent(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+	private:
+		// First two score parts of the Pareto front
+		mutable std::vector<double> m_frontX;
+		mutable std::vector<double> m_frontY;
+	};
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "AutoTuner_base.h"
+#include "Solvers/Solver.h"
+#include "Solvers/SolverSnapshot.h"
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Base of the components that visualize a solver, the solver itself does not know about QSFML.
+	 * The painter only holds a handle to the newest SolverSnapshot, setting a snapshot copies nothing.
+	 * The plot data is rebuilt from the snapshot when a frame gets drawn and the snapshot version changed.
+	 */
+	class AUTO_TUNER_API SolverPainter : public QSFML::Components::Drawable
+	{
+	public:
+		typedef std::function<sf::Color(const std::vector<double>&)> ParametersToColorFunc;
+
+		SolverPainter(const std::string& name = "SolverPainter");
+		~SolverPainter();
+
+		/**
+		 * @brief
+		 * Sets the color of an agent in the population grid, nullptr hides the grid
+		 */
+		void setParametersToColorFunc(ParametersToColorFunc func) { m_agentToColorFunc = func; }
+
+		/**
+		 * @brief
+		 * Sets the snapshot to draw, the painter keeps the handle until the next one arrives
+		 */
+		void setSnapshot(const SolverSnapshot::Handle& snapshot) { m_snapshot = snapshot; }
+		const SolverSnapshot::Handle& getSnapshot() const { return m_snapshot; }
+
+	protected:
+		/**
+		 * @brief
+		 * Rebuilds the plot data if the snapshot changed since the last frame, call it first in drawComponent()
+		 * @return the snapshot to draw, nullptr if there is none yet
+		 */
+		const SolverSnapshot* updatePlotData() const;
+
+		/**
+		 * @brief
+		 * Rebuilds the plot data of the subclass from a new snapshot
+		 */
+		virtual void onSnapshotChanged(const SolverSnapshot& snapshot) const { AT_UNUSED(snapshot); }
+
+		/**
+		 * @brief
+		 * Draws one square per agent of the generation, colored by the ParametersToColorFunc
+		 */
+		void drawAgentGrid(sf::RenderTarget& target, sf::RenderStates states, const PopulationStore::Generation& generation) const;
+
+		size_t m_historySize = 1000;
+		mutable std::vector<double> m_averageScoresHistory;
+		mutable std::vector<double> m_averageScoresHistoryTimeline;
+
+		mutable std::vector<double> m_scoreParts;
+		mutable std::vector<const char*> m_scorePartsLabels;	// ImPlot needs the labels as C strings
+
+		ParametersToColorFunc m_agentToColorFunc = nullptr;
+
+	private:
+		void updateScorePartsLabels(const std::vector<std::string>& labels) const;
+		void collectScoreParts(const PopulationStore::Generation& generation) const;
+		void collectHistory(const SolverSnapshot& snapshot) const;
+		void clearScorePartsLabels() const;
+
+		SolverSnapshot::Handle m_snapshot;
+		mutable size_t m_plottedVersion = 0;
+		mutable std::vector<std::string> m_labels;
+		mutable std::vector<double> m_agentParameters;
+	};
+}
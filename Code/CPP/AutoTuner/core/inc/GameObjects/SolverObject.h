@@ -0,0 +1,69 @@
+#pragma once
+
+#include "AutoTuner_base.h"
+#include "Solvers/Solver.h"
+#include "Solvers/SolverWorker.h"
+#include "Components/SolverPainter.h"
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Shows a solver in a QSFML scene.
+	 * Takes the ownership of the solver and adds the painter that matches its type.
+	 * The solver either runs on the worker of this object, see getWorker(),
+	 * or by the owner of this object calling test() and iterate().
+	 * In both cases the painter draws from the newest snapshot once per frame.
+	 */
+	class AUTO_TUNER_API SolverObject : public QSFML::Objects::GameObject
+	{
+	public:
+		/**
+		 * @param solver gets deleted with this object
+		 * @param name empty uses the name of the solver
+		 */
+		SolverObject(Solver* solver,
+			const std::string& name = "",
+			GameObject* parent = nullptr);
+		~SolverObject();
+
+		Solver* getSolver() const { return m_solver; }
+
+		/**
+		 * @brief
+		 * Gets the worker that observes the solver and can run its epochs on its own thread
+		 */
+		SolverWorker& getWorker() { return m_worker; }
+		const SolverWorker& getWorker() const { return m_worker; }
+
+		/**
+		 * @brief
+		 * Gets the snapshot the painter draws, nullptr before the first generation
+		 */
+		const SolverSnapshot::Handle& getSnapshot() const { return m_worker.getSnapshot(); }
+
+		/**
+		 * @return the painter observing the solver, nullptr if the solver type has no painter
+		 */
+		SolverPainter* getPainter() const { return m_painter; }
+
+		void setParametersToColorFunc(SolverPainter::ParametersToColorFunc func)
+		{
+			if (m_painter)
+				m_painter->setParametersToColorFunc(func);
+		}
+
+		/**
+		 * @brief
+		 * Takes the newest snapshot of the worker and hands it to the painter
+		 */
+		void update() override;
+
+	private:
+		static SolverPainter* createPainter(const Solver* solver);
+
+		Solver* m_solver = nullptr;
+		SolverPainter* m_painter = nullptr;
+		SolverWorker m_worker;
+	};
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include "Solvers/Solver.h"
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Covariance matrix adaptation evolution strategy (CMA-ES) with rank-one and rank-mu update.
+	 * Each generation samples lambda agents from the normal distribution N(m, sigma^2 * C).
+	 * test() evaluates the generation, iterate() moves the mean towards the best mu agents,
+	 * adapts the step size sigma and the covariance matrix C and samples the next generation.
+	 *
+	 * The initial mean is the mean of the initial parameters, the initial distribution has their spread per parameter.
+	 * When the run converged or got stuck, the solver restarts from a new random mean
+	 * in the region of the initial parameters (IPOP / BIPOP).
+	 *
+	 * The samples are stored per parameter like the PopulationStore,
+	 * so sampling and the covariance update run over contiguous rows.
+	 */
+	class AUTO_TUNER_API CMAESSolver : public Solver
+	{
+	public:
+		struct Individual
+		{
+			std::vector<double> parameters;
+			double fitness = 0.0;
+		};
+
+		enum class RestartStrategy
+		{
+			None,	// Keeps adapting the converged distribution
+			IPOP,	// Doubles the population size on every restart
+			BIPOP	// Alternates between doubled populations and small populations with a small step size
+		};
+
+		CMAESSolver();
+		~CMAESSolver();
+
+		void setInitialParameters(const std::vector<std::vector<double>>& parameterList) override;
+		void iterate() override;
+		void test() override;
+
+		/**
+		 * @brief
+		 * Sets the initial step size relative to the spread of the initial parameters.
+		 * The step size adapts itself during the run, this only affects the start and the restarts.
+		 */
+		void setMutationAmount(double amount) override;
+		double getMutationAmount() const override;
+
+		/**
+		 * @brief
+		 * Sets the number of agents of a generation (lambda).
+		 * @param size 0 uses the default 4 + 3 * ln(parameterCount)
+		 *             Takes effect with the next setInitialParameters().
+		 */
+		void setPopulationSize(size_t size) { m_requestedPopulationSize = size; }
+		size_t getPopulationSize() const { return m_lambda; }
+
+		void setRestartStrategy(RestartStrategy strategy) { m_restartStrategy = strategy; }
+		RestartStrategy getRestartStrategy() const { return m_restartStrategy; }
+		size_t getRestartCount() const { return m_restartCount; }
+
+		/**
+		 * @return the current step size sigma
+		 */
+		double getStepSize() const override { return m_sigma; }
+		const std::vector<double>& getMean() const { return m_mean; }
+
+		/**
+		 * @return number of tested agents since the last setInitialParameters(), over all restarts
+		 */
+		size_t getEvaluationCount() const { return m_evaluationCount; }
+
+		void setScorePartsLabels(const std::vector<std::string>& labels) override;
+
+		const std::vector<double>& getAlltimeBestParameters() const override;
+		const std::vector<double>& getBestParameters() const override;
+
+		const PopulationStore& getPopulation() const { return m_population; }
+
+		std::vector<double> getScores() override
+		{
+			const PopulationStore::Generation& population = m_population.getCurrent();
+			return std::vector<double>(population.getScores(), population.getScores() + population.getAgentCount());
+		}
+
+		void clearAlltimeBestParameters() override;
+	private:
+		bool isBetter(double score, double reference) const
+		{
+			if (m_optimizingDirection == OptimizingDirection::Minimize)
+				return score < reference;
+			return score > reference;
+		}
+
+		/**
+		 * @brief
+		 * Resets the distribution to N(mean, sigma^2 * C0) and sets the strategy parameters for lambda agents
+		 */
+		void startRun(const std::vector<double>& mean, double sigma, size_t lambda);
+
+		/**
+		 * @brief
+		 * Samples x = m + sigma * B * D * z into the current generation
+		 */
+		void samplePopulation();
+
+		/**
+		 * @brief
+		 * Updates mean, evolution paths, C and sigma from the ranked tested generation
+		 */
+		void updateDistribution();
+		void updateEigenDecomposition();
+
+		bool shouldRestart() const;
+		void restart();
+		void updateBestIndividuals();
+
+		PopulationStore m_population;
+		bool m_populationSampled = false;
+		bool m_populationTested = false;
+		size_t m_scorePartCount = 0;
+
+		// Region of the initial parameters, used for the restarts
+		std::vector<double> m_initialMean;
+		std::vector<double> m_initialScale;
+		double m_initialSigma = 1.0;
+		double m_stepSizeFactor = 1.0;
+
+		// Distribution
+		size_t m_parameterCount = 0;
+		std::vector<double> m_mean;
+		double m_sigma = 1.0;
+		std::vector<double> m_covariance;		// C, n x n row major
+		std::vector<double> m_eigenVectors;		// B, column i belongs to m_eigenValuesSqrt[i]
+		std::vector<double> m_eigenValuesSqrt;	// D
+		std::vector<double> m_transform;		// B * D
+		std::vector<double> m_pathSigma;
+		std::vector<double> m_pathC;
+
+		// Strategy parameters, set by startRun()
+		size_t m_requestedPopulationSize = 0;
+		size_t m_defaultLambda = 0;
+		size_t m_lambda = 0;
+		size_t m_mu = 0;
+		std::vector<double> m_weights;
+		double m_muEff = 0;
+		double m_cSigma = 0;
+		double m_dSigma = 0;
+		double m_cC = 0;
+		double m_c1 = 0;
+		double m_cMu = 0;
+		double m_chiN = 0;
+
+		// Samples of the current generation, one row of lambda values per parameter
+		std::vector<double> m_z;
+		std::vector<double> m_y;
+		std::vector<double> m_selectedY;		// y of the best mu agents in rank order, one row per parameter
+		std::vector<size_t> m_ranking;
+		std::vector<double> m_meanStep;			// Weighted mean of the selected y, (m_new - m_old) / sigma
+		std::vector<double> m_tmpVector;
+
+		// Restarts
+		RestartStrategy m_restartStrategy = RestartStrategy::BIPOP;
+		size_t m_generation = 0;			// Generation of the current run
+		size_t m_eigenGeneration = 0;
+		size_t m_restartCount = 0;
+		size_t m_evaluationCount = 0;
+		size_t m_largeLambda = 0;			// Population size of the last large BIPOP / IPOP run
+		bool m_smallRegimeRun = false;
+		size_t m_largeRegimeEvaluations = 0;
+		size_t m_smallRegimeEvaluations = 0;
+		std::vector<double> m_bestScoreHistory;	// Best score of each generation of the current run
+
+		Individual m_alltimeBestIndividual;
+		Individual m_lastRoundBestIndividual;
+
+		static constexpr double s_tolFun = 1e-12;
+		static constexpr double s_tolX = 1e-12;
+		static constexpr double s_maxCondition = 1e14;
+		static constexpr size_t s_maxLambdaFactor = 512;
+	};
+}
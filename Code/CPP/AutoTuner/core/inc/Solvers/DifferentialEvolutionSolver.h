@@ -0,0 +1,94 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include "Solvers/Solver.h"
+
+#define DIFFERENTIAL_SOLVER_USE_THREAD_POOL
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Differential evolution (DE/rand/1/bin).
+	 * test() evaluates the initial population once and afterwards the trial vectors of each generation.
+	 * iterate() replaces every individual whose trial scored better and creates the next trial vectors.
+	 *
+	 * With surrogate pre-screening, each individual gets a pool of trial candidates
+	 * and only the one with the best predicted score is tested.
+	 * A surrogate hit is a screened trial that scored better than the individual it competes with.
+	 */
+	class AUTO_TUNER_API DifferentialEvolutionSolver : public Solver
+	{
+	public:
+		struct Individual
+		{
+			std::vector<double> parameters;
+			double fitness = 0.0;
+		};
+
+		DifferentialEvolutionSolver();
+		~DifferentialEvolutionSolver();
+
+		void setInitialParameters(const std::vector<std::vector<double>>& parameterList) override;
+		void iterate() override;
+		void test() override;
+
+
+		void setMutationAmount(double amount) override;
+		double getMutationAmount() const override;
+		void setCrossoverPropability(double propability) { m_crossoverPropability = propability; }
+		double getCrossoverPropability() const { return m_crossoverPropability; }
+
+		void setScorePartsLabels(const std::vector<std::string>& labels) override;
+
+		const std::vector<double>& getAlltimeBestParameters() const override;
+		const std::vector<double>& getBestParameters() const override;
+
+		const PopulationStore& getPopulation() const { return m_population; }
+
+		std::vector<double> getScores() override
+		{
+			const PopulationStore::Generation& population = m_population.getCurrent();
+			return std::vector<double>(population.getScores(), population.getScores() + population.getAgentCount());
+		}
+
+		void clearAlltimeBestParameters() override;
+	private:
+		bool isBetter(double score, double reference) const
+		{
+			if (m_optimizingDirection == OptimizingDirection::Minimize)
+				return score < reference;
+			return score > reference;
+		}
+
+		/**
+		 * @brief
+		 * Replaces each individual by its trial vector if the trial scored at least as good
+		 */
+		void selectTrials();
+
+		/**
+		 * @brief
+		 * Creates the trial vectors v = x_r1 + F * (x_r2 - x_r3) with binomial crossover
+		 */
+		void createTrials();
+		void createTrial(size_t agent);
+		void updateBestIndividuals();
+
+		// Current individuals and the trial vectors of the running generation
+		PopulationStore m_population;
+		PopulationStore m_trials;
+		bool m_populationTested = false;
+		bool m_trialsCreated = false;
+		bool m_trialsTested = false;
+		bool m_trialsScreened = false;
+		std::vector<double> m_bestCandidate;
+
+		double m_mutationFactor = 0.5;
+		double m_crossoverPropability = 0.9;
+		size_t m_scorePartCount = 0;
+
+		Individual m_alltimeBestIndividual;
+		Individual m_lastRoundBestIndividual;
+
+	};
+}
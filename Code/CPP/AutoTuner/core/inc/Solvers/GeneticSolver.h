@@ -0,0 +1,393 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include "Solvers/Solver.h"
+#include "Utilities/SelectionTable.h"
+#include "Utilities/SpscQueue.h"
+#include <mutex>
+
+#define GENETIC_SOLVER_USE_THREAD_POOL
+#define GENETIC_SOLVER_USE_INDIVIDUAL_PARAMETER_MUTATION_RATE
+
+namespace AutoTuner
+{
+	
+	class AUTO_TUNER_API GeneticSolver : public Solver
+	{
+	public:
+		
+		struct Agent
+		{
+			//size_t ID = 0;
+			double score = 0.0;
+			std::vector<double> scoreParts;
+			std::vector<double> parameters;
+
+			std::vector<double> mutationFactors;
+		};
+
+		enum class IslandTopology
+		{
+			Ring,				// Island i sends its migrants to island i + 1
+			BidirectionalRing,	// Island i sends its migrants to island i - 1 and i + 1
+			FullyConnected		// Every island sends its migrants to all other islands
+		};
+		
+
+		GeneticSolver(const std::string& name = "GeneticSolver");
+		~GeneticSolver();
+
+		/**
+		 * @brief
+		 * Gets the population, in island mode all islands one after the other as of the last test()
+		 */
+		const PopulationStore& getPopulation() const
+		{
+			if (m_islands.size() > 1)
+				return m_islandAggregate;
+			return m_islands[0].population;
+		}
+		//void setPopulation(const std::vector<Agent>& population);
+		void setInitialParameters(const std::vector<std::vector<double>>& parameterList) override;
+		void clearAlltimeBestParameters() override
+		{
+			m_alltimeBestAgent = Agent(); 
+			// A minimizing run starts at the worst score, 0 could never be beaten
+			if (m_optimizingDirection == OptimizingDirection::Minimize)
+				m_alltimeBestAgent.score = std::numeric_limits<double>::infinity();
+			for (Island& island : m_islands)
+				island.alltimeBestAgent = m_alltimeBestAgent;
+			notifyReset();
+		}
+		void setScorePartsLabels(const std::vector<std::string>& labels) override
+		{
+			Solver::setScorePartsLabels(labels);
+			m_scorePartCount = labels.size();
+			for (Island& island : m_islands)
+				island.population.setScorePartCount(m_scorePartCount);
+			m_islandAggregate.setScorePartCount(m_scorePartCount);
+		}
+
+		const std::vector<double>& getAlltimeBestParameters() const override { return m_alltimeBestAgent.parameters; }
+		const std::vector<double>& getBestParameters() const override {
+			return  m_bestLastRoundAgent.parameters;
+		}
+		void setMutationAmount(double amount) override { m_mutationAmount = amount; }
+		double getMutationAmount() const override { return m_mutationAmount; }
+		void setMutationPropability(double rate) { m_mutationPropability = rate; }
+		double getMutationPropability() const { return m_mutationPropability; }
+
+		void setOptimizingDirection(OptimizingDirection direction) override
+		{
+			m_optimizingDirection = direction;
+		}
+		OptimizingDirection getOptimizingDirection() const
+		{
+			return m_optimizingDirection;
+		}
+		void setMinimizingStaticOffset(double offset)
+		{
+			m_minimizingStaticOffset = offset;
+		}
+		double getMinimizingStaticOffset() const
+		{
+			return m_minimizingStaticOffset;
+		}
+
+		std::vector<double> getScores() override
+		{
+			return m_lastPopulationScores;
+		}
+
+		/**
+		 * @brief
+		 * Changes the parameters of the system being tested.
+		 */
+		void iterate() override;
+
+		/**
+		 * @brief
+		 * Tests the current parameters of the system.
+		 */
+		void test() override;
+
+
+
+		/**
+		 * @brief
+		 * Sorts the current generation by score, best agent first.
+		 * In island mode each island gets sorted on its own.
+		 */
+		void sortPopulation();
+
+		/**
+		 * @brief
+		 * Splits the population into islands that evolve independently.
+		 * In island mode one test() call runs one scheduler task per island, which breeds and tests
+		 * the agents of its island on its worker. The islands don't wait for each other within a call.
+		 * The best agents of an island migrate to its neighbours over lock-free queues.
+		 * Migrants sent during a test() call arrive at the start of the next call,
+		 * so the run does not depend on the thread count or the timing of the islands.
+		 * In island mode iterate() only collects the statistics, the breeding happens in test().
+		 *
+		 * The island settings take effect with the next setInitialParameters().
+		 * @param count 1 keeps a single population. Each island gets at least 2 agents.
+		 */
+		void setIslandCount(size_t count) { m_requestedIslandCount = std::max<size_t>(1, count); }
+		size_t getIslandCount() const { return m_islands.size(); }
+		void setIslandTopology(IslandTopology topology) { m_islandTopology = topology; }
+		IslandTopology getIslandTopology() const { return m_islandTopology; }
+
+		/**
+		 * @param generations island generations between two emigrations, 0 disables the migration
+		 */
+		void setMigrationInterval(size_t generations) { m_migrationInterval = generations; }
+		size_t getMigrationInterval() const { return m_migrationInterval; }
+
+		/**
+		 * @brief
+		 * Sets how many of the best agents emigrate to each neighbour. They replace the worst agents there.
+		 */
+		void setMigrantCount(size_t count) { m_migrantCount = count; }
+		size_t getMigrantCount() const { return m_migrantCount; }
+
+		/**
+		 * @brief
+		 * Sets how many generations each island runs in one test() call.
+		 * More generations per call make the join at the end of the call less frequent.
+		 */
+		void setIslandGenerationsPerStep(size_t generations) { m_islandGenerationsPerStep = std::max<size_t>(1, generations); }
+		size_t getIslandGenerationsPerStep() const { return m_islandGenerationsPerStep; }
+
+		/**
+		 * @return number of migrants that replaced an agent since the last setInitialParameters()
+		 */
+		size_t getMigrationCount() const { return m_migrationCount.load(); }
+
+		/**
+		 * @brief
+		 * Sets the number of offspring pairs bred in one scheduler task.
+		 * @param grainSize 0 lets the scheduler decide
+		 */
+		void setBreedingGrainSize(size_t grainSize) { m_breedingGrainSize = grainSize; }
+		size_t getBreedingGrainSize() const { return m_breedingGrainSize; }
+
+		void setSeed(uint64_t seed) override
+		{
+			Solver::setSeed(seed);
+			for (Island& island : m_islands)
+			{
+				island.generation = 0;
+				island.random = createRandomStream(s_islandStream, static_cast<uint32_t>(island.index));
+			}
+		}
+
+		/**
+		 * @brief
+		 * Sets how the parents get selected.
+		 * The selection table is built once per generation, PrefixSum selects the same parents as a linear scan.
+		 */
+		void setSelectionMethod(SelectionTable::Method method) { m_selectionMethod = method; }
+		SelectionTable::Method getSelectionMethod() const { return m_selectionMethod; }
+		void setTournamentSize(size_t size) { m_tournamentSize = std::max<size_t>(1, size); }
+		size_t getTournamentSize() const { return m_tournamentSize; }
+
+		/**
+		 * @brief
+		 * Replaces the generations by a steady-state population without barriers between the evaluations.
+		 * In one test() call each worker repeatedly selects two parents by tournament, breeds and tests one child
+		 * and inserts it by a reverse tournament: it replaces the worst of the drawn agents if it is better.
+		 * Only the agents being read or replaced are locked, so a slow evaluation never blocks the other workers.
+		 * test() returns once the evaluation budget of the call is used up, it only waits for the evaluations still running.
+		 * In steady-state mode iterate() only collects the statistics.
+		 *
+		 * The order of the insertions depends on the timing of the workers, so runs are not reproducible.
+		 * The mode takes effect with the next setInitialParameters() and uses a single population without surrogate screening.
+		 */
+		void setSteadyStateEnabled(bool enabled) { m_steadyStateRequested = enabled; }
+		bool isSteadyStateEnabled() const { return m_steadyStateRequested; }
+		bool isSteadyStateRunning() const { return m_steadyState; }
+
+		/**
+		 * @param evaluations number of children tested in one test() call, 0 uses the population size
+		 */
+		void setSteadyStateEvaluationsPerStep(size_t evaluations) { m_steadyStateEvaluationsPerStep = evaluations; }
+		size_t getSteadyStateEvaluationsPerStep() const { return m_steadyStateEvaluationsPerStep; }
+
+		/**
+		 * @return number of children that replaced an agent since the last setInitialParameters()
+		 */
+		size_t getSteadyStateReplacementCount() const { return m_steadyStateReplacementCount.load(); }
+
+		bool isThreadsBusy() const
+		{
+			return m_threadsBusy.load();
+		}
+	private:
+		struct Migrant
+		{
+			Agent agent;
+			size_t step = 0;	// test() call in which the migrant left its island
+		};
+		typedef SpscQueue<Migrant> MigrantQueue;
+
+		/**
+		 * @brief
+		 * Sub-population with its own selection table and random stream.
+		 * Without island mode the solver has exactly one island.
+		 */
+		struct Island
+		{
+			size_t index = 0;
+			size_t agentOffset = 0;		// Index of the first agent in the whole population
+			PopulationStore population;
+			SelectionTable selectionTable;
+			std::vector<size_t> sortOrder;
+			RandomStream random;		// Sequential parts of an island generation, only used in island mode
+			double globalNoise = 0.0;
+			size_t generation = 0;
+			bool tested = false;
+			Agent alltimeBestAgent;
+			Agent bestLastRoundAgent;
+
+			std::vector<MigrantQueue*> inbound;
+			std::vector<MigrantQueue*> outbound;
+			std::vector<Agent> arrivedMigrants;
+		};
+
+		bool isBetter(double score, double reference) const
+		{
+			if (m_optimizingDirection == OptimizingDirection::Minimize)
+				return score < reference;
+			return score > reference;
+		}
+
+		/**
+		 * @brief
+		 * Selects two parents of the current generation, using the selection table of this generation
+		 * @param pair index of the offspring pair
+		 * @return indices of the parents
+		 */
+		std::pair<size_t,size_t> selectParents(const Island& island, size_t pair, RandomStream& random) const;
+
+		/**
+		 * @brief
+		 * Mutates an agent of the offspring
+		 * @param globalNoise shared part of the mutation factor change, drawn once per generation
+		 */
+		void mutate(PopulationStore::Generation& offsprings, size_t offspring, double globalNoise, RandomStream& random);
+
+		/**
+		 * @brief
+		 * Creates two offspring agents from two parent agents.
+		 * If both offspring indices are equal, only the second child is kept.
+		 */
+		void crossover(const PopulationStore::Generation& parents, size_t parent1, size_t parent2,
+			PopulationStore::Generation& offsprings, size_t offspring1, size_t offspring2, RandomStream& random);
+
+
+		Agent getAgent(const Island& island, size_t index) const;
+
+		void sortIsland(Island& island);
+
+		/**
+		 * @brief
+		 * Finds the best agent of the tested current generation, turns the scores into selection weights
+		 * and builds the selection table
+		 */
+		void prepareSelection(Island& island, RandomStream& random);
+
+		/**
+		 * @brief
+		 * Breeds the offspring pairs [begin, end) into their slots of the next generation.
+		 * Pair i writes the agents 2i and 2i+1, so the pairs can be bred concurrently.
+		 * With surrogate screening, each pair is bred pool size times
+		 * and each slot keeps the child with the best predicted score.
+		 */
+		void breedPairs(Island& island, size_t begin, size_t end);
+		void keepBestCandidates(Island& island, size_t offspring1, size_t offspring2, size_t candidate);
+		void restoreBestCandidates(Island& island, size_t offspring1, size_t offspring2);
+
+		void updateAlltimeBest(Island& island);
+
+		// Island mode
+		void setupIslands(const std::vector<std::vector<double>>& parameterList);
+		void runIslandStep(Island& island, size_t step);
+		void receiveMigrants(Island& island, size_t step);
+		void insertMigrants(Island& island);
+		void sendMigrants(Island& island, size_t step);
+		void aggregateIslands();
+
+		// Steady-state mode
+		void runSteadyState(Island& island);
+		void breedSteadyState(Island& island, size_t child, size_t task);
+
+		/**
+		 * @brief
+		 * Tournament on the locked scores of the population
+		 * @param worst true selects the worst of the drawn agents instead of the best
+		 */
+		size_t drawSteadyStateTournament(const PopulationStore::Generation& population, bool worst, RandomStream& random) const;
+
+		/**
+		 * @brief
+		 * Replaces the loser of a reverse tournament by the child, if the child is better
+		 * @return true if the child was inserted
+		 */
+		bool insertSteadyStateChild(PopulationStore::Generation& population, const PopulationStore::Generation& children, size_t child, RandomStream& random);
+
+
+		std::vector<double> m_lastPopulationScores;
+		std::vector<Island> m_islands;
+		size_t m_scorePartCount = 0;
+		Agent m_alltimeBestAgent;
+		Agent m_bestLastRoundAgent;
+		//std::vector<Agent> m_nextGeneration;
+
+
+		// Selection parameters
+		size_t m_maxSelectionTryCount = 10;
+		SelectionTable::Method m_selectionMethod = SelectionTable::Method::PrefixSum;
+		size_t m_tournamentSize = 2;
+
+		// Crossover parameters
+		//size_t m_crossoverPoints = 1;
+
+
+		// Mutatuion parameters
+		double m_mutationPropability = 0.05;
+		double m_mutationAmount = 0.01;
+
+		bool m_useAdaptiveMutation = false;
+		double m_tauPrime = 0.0;
+		double m_tau = 0.0;
+		double m_minimizingStaticOffset = 1e-6;
+
+		size_t m_breedingGrainSize = 0;
+
+		// Island parameters
+		size_t m_requestedIslandCount = 1;
+		IslandTopology m_islandTopology = IslandTopology::Ring;
+		size_t m_migrationInterval = 5;
+		size_t m_migrantCount = 1;
+		size_t m_islandGenerationsPerStep = 1;
+		size_t m_islandStep = 0;
+		std::vector<std::unique_ptr<MigrantQueue>> m_migrationQueues;
+		PopulationStore m_islandAggregate;
+		std::atomic<size_t> m_migrationCount{ 0 };
+
+		// Steady-state parameters
+		bool m_steadyStateRequested = false;
+		bool m_steadyState = false;
+		size_t m_steadyStateEvaluationsPerStep = 0;
+		std::unique_ptr<std::mutex[]> m_agentLocks;				// One per agent of the steady-state population
+		std::atomic<size_t> m_steadyStateChildCount{ 0 };		// Children bred so far, each child has its own random stream
+		std::atomic<size_t> m_steadyStateReplacementCount{ 0 };
+
+		std::atomic<bool> m_threadsBusy{ false };
+
+		// Surrogate screening of the single population, the islands don't screen
+		bool m_offspringScreened = false;
+		double m_surrogateReferenceScore = 0;
+	};
+}
\ No newline at end of file
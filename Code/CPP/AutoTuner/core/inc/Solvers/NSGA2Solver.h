@@ -0,0 +1,184 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include "Solvers/Solver.h"
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Multi-objective genetic algorithm (NSGA-II).
+	 * Each score part returned by the test function is an objective of its own,
+	 * all objectives use the optimizing direction of the solver.
+	 * test() evaluates the initial population once and afterwards the offspring of each generation.
+	 * iterate() ranks parents and offspring together by fast non-dominated sorting and crowding distance,
+	 * keeps the best half and breeds the next offspring.
+	 *
+	 * The solver keeps the whole Pareto front instead of a single best agent,
+	 * so a weighting of the score parts can be picked after the run with getWeightedBestParameters().
+	 * getBestParameters() and getAlltimeBestParameters() use the sum of the score parts like the other solvers.
+	 *
+	 * Racing is not used, a scalar threshold can't tell if an agent is dominated.
+	 */
+	class AUTO_TUNER_API NSGA2Solver : public Solver
+	{
+	public:
+		struct Individual
+		{
+			std::vector<double> parameters;
+			double fitness = 0.0;
+		};
+		struct ParetoSolution
+		{
+			std::vector<double> parameters;
+			std::vector<double> scoreParts;
+			double score = 0.0;
+		};
+
+		NSGA2Solver();
+		~NSGA2Solver();
+
+		void setInitialParameters(const std::vector<std::vector<double>>& parameterList) override;
+		void iterate() override;
+		void test() override;
+
+		/**
+		 * @brief
+		 * Sets the maximal change of a mutated parameter
+		 */
+		void setMutationAmount(double amount) override;
+		double getMutationAmount() const override;
+
+		/**
+		 * @param propability of each parameter to get mutated, 0 uses 1 / parameter count
+		 */
+		void setMutationPropability(double propability) { m_mutationPropability = propability; }
+		double getMutationPropability() const { return m_mutationPropability; }
+		void setCrossoverPropability(double propability) { m_crossoverPropability = propability; }
+		double getCrossoverPropability() const { return m_crossoverPropability; }
+
+		/**
+		 * @brief
+		 * Sets the distribution index of the simulated binary crossover.
+		 * Large values create offspring close to their parents.
+		 */
+		void setCrossoverDistributionIndex(double index) { m_crossoverDistributionIndex = index; }
+		double getCrossoverDistributionIndex() const { return m_crossoverDistributionIndex; }
+
+		/**
+		 * @brief
+		 * Selects the score parts used as objectives.
+		 * Fronts of many objectives contain most of the population, so fewer objectives give more selection pressure.
+		 * @param scoreParts indices of the score parts, empty uses all of them
+		 */
+		void setObjectiveScoreParts(const std::vector<size_t>& scoreParts) { m_objectiveScoreParts = scoreParts; }
+		const std::vector<size_t>& getObjectiveScoreParts() const { return m_objectiveScoreParts; }
+
+		void setScorePartsLabels(const std::vector<std::string>& labels) override;
+
+		const std::vector<double>& getAlltimeBestParameters() const override;
+		const std::vector<double>& getBestParameters() const override;
+
+		/**
+		 * @return the non-dominated agents of the current population, updated by iterate()
+		 */
+		const std::vector<ParetoSolution>& getParetoFront() const { return m_paretoFront; }
+
+		/**
+		 * @brief
+		 * Picks the agent of the Pareto front with the best weighted sum of its score parts
+		 * @param weights one weight per score part, missing weights are 0
+		 * @return empty if the front is empty
+		 */
+		std::vector<double> getWeightedBestParameters(const std::vector<double>& weights) const;
+
+		const PopulationStore& getPopulation() const { return m_population; }
+
+		std::vector<double> getScores() override
+		{
+			const PopulationStore::Generation& population = m_population.getCurrent();
+			return std::vector<double>(population.getScores(), population.getScores() + population.getAgentCount());
+		}
+
+		void clearAlltimeBestParameters() override;
+		void writeSnapshot(SolverSnapshot& snapshot) const override;
+	private:
+		bool isBetter(double score, double reference) const
+		{
+			if (m_optimizingDirection == OptimizingDirection::Minimize)
+				return score < reference;
+			return score > reference;
+		}
+
+		/**
+		 * @brief
+		 * Copies the objectives of the generation to m_objectives, starting at the column offset.
+		 * The values get negated when maximizing, so the sorting always minimizes.
+		 */
+		void loadObjectives(const PopulationStore::Generation& generation, size_t offset);
+
+		/**
+		 * @brief
+		 * Fast non-dominated sort of the first count columns of m_objectives.
+		 * Fills m_rank and m_fronts, the domination counts are computed in parallel.
+		 */
+		void sortNonDominated(size_t count);
+		void computeCrowdingDistances(size_t count);
+
+		/**
+		 * @brief
+		 * Ranks the tested initial population, so the first tournaments have ranks to compare
+		 */
+		void rankParents();
+
+		/**
+		 * @brief
+		 * Keeps the best half of parents and offspring as the next population
+		 */
+		void selectSurvivors();
+
+		/**
+		 * @brief
+		 * Breeds the offspring by binary tournaments, simulated binary crossover and mutation
+		 */
+		void createOffspring();
+		size_t selectParent(RandomStream& random) const;
+		void updateBestIndividuals();
+		void updateParetoFront();
+
+		// Current parents and the offspring of the running generation
+		PopulationStore m_population;
+		PopulationStore m_offspring;
+		bool m_populationTested = false;
+		bool m_offspringCreated = false;
+		bool m_offspringTested = false;
+		bool m_parentsRanked = false;
+		size_t m_generation = 0;
+
+		double m_mutationAmount = 0.1;
+		double m_mutationPropability = 0;
+		double m_crossoverPropability = 0.9;
+		double m_crossoverDistributionIndex = 15;
+		std::vector<size_t> m_objectiveScoreParts;
+		size_t m_scorePartCount = 0;
+
+		// Rank and crowding distance of the parents, used by the tournaments
+		std::vector<size_t> m_parentRank;
+		std::vector<double> m_parentCrowding;
+
+		// Sorting buffers of parents and offspring together
+		size_t m_objectiveCount = 0;
+		size_t m_objectiveStride = 0;
+		std::vector<double> m_objectives;					// One row per objective, one column per agent
+		std::vector<size_t> m_rank;
+		std::vector<double> m_crowding;
+		std::vector<size_t> m_dominationCount;
+		std::vector<std::vector<size_t>> m_dominatedAgents;
+		std::vector<std::vector<size_t>> m_fronts;
+		std::vector<size_t> m_survivors;
+
+		std::vector<ParetoSolution> m_paretoFront;
+		Individual m_alltimeBestIndividual;
+		Individual m_lastRoundBestIndividual;
+	};
+}
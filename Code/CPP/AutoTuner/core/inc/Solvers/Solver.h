@@ -0,0 +1,466 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include "Utilities/PopulationStore.h"
+#include "Utilities/TaskScheduler.h"
+#include "Utilities/RandomStream.h"
+#include "Utilities/FitnessCache.h"
+#include "Utilities/RBFSurrogate.h"
+
+
+namespace AutoTuner
+{
+	struct SolverSnapshot;
+
+	/**
+	 * @brief
+	 * Base of the solvers. It does not depend on QSFML, the solvers can run headless.
+	 * Visualizations observe the solver, see SolverObject to show a solver in a scene.
+	 */
+	class AUTO_TUNER_API Solver
+	{
+	public:
+		enum class OptimizingDirection
+		{
+			Minimize,
+			Maximize
+		};
+
+		struct SurrogateStatistics
+		{
+			size_t candidates = 0;		// Bred candidates ranked by the surrogate
+			size_t evaluations = 0;		// Candidates sent to the test function
+			size_t hits = 0;			// Evaluated candidates that beat their reference, see the solver
+
+			double getHitRate() const { return evaluations > 0 ? static_cast<double>(hits) / static_cast<double>(evaluations) : 0.0; }
+
+			/**
+			 * @return tests saved compared to testing every candidate
+			 */
+			size_t getSavedEvaluations() const { return candidates - evaluations; }
+		};
+
+		/**
+		 * @brief
+		 * Gets notified on the thread that calls iterate().
+		 */
+		class AUTO_TUNER_API Observer
+		{
+		public:
+			virtual ~Observer() = default;
+
+			/**
+			 * @brief
+			 * Called once per iteration with the tested generation, before the solver breeds the next one
+			 */
+			virtual void onGeneration(const Solver& solver, const PopulationStore::Generation& generation) = 0;
+
+			/**
+			 * @brief
+			 * Called when the solver forgets its history, see clearAlltimeBestParameters()
+			 */
+			virtual void onReset(const Solver& solver) { AT_UNUSED(solver); }
+		};
+
+		typedef std::function<std::vector<double>(const std::vector<double>&, size_t)> ParametersTestFunc;
+
+		/**
+		 * @brief
+		 * Scores a whole block of agents at once.
+		 * The function has to write every score part of every agent in the block.
+		 */
+		typedef std::function<void(const PopulationStore::AgentBlock&)> ParametersBatchTestFunc;
+
+		Solver(const std::string& name = "Solver");
+		virtual ~Solver() = default;
+
+		const std::string& getName() const { return m_name; }
+
+		/**
+		 * @brief
+		 * Sets the observer of the solver, it is not owned
+		 */
+		void setObserver(Observer* observer) { m_observer = observer; }
+		Observer* getObserver() const { return m_observer; }
+
+		virtual void setOptimizingDirection(OptimizingDirection direction)
+		{
+			m_optimizingDirection = direction;
+		}
+		OptimizingDirection getOptimizingDirection() const
+		{
+			return m_optimizingDirection;
+		}
+
+
+		virtual void setInitialParameters(const std::vector<std::vector<double>>& parameterList) = 0;
+
+		/**
+		 * @brief 
+		 * Changes the parameters of the system being tested.
+		 */
+		virtual void iterate() = 0;
+
+		/**
+		 * @brief
+		 * Tests the current parameters of the system.
+		 */
+		virtual void test() = 0;
+
+		/**
+		 * @brief
+		 * Runs test() and iterate() without a frame loop
+		 * @param epochCount maximal number of epochs
+		 * @param callback called after each epoch with the epoch index, returning false stops the run
+		 * @return the number of epochs run
+		 */
+		size_t run(size_t epochCount, const std::function<bool(size_t)>& callback = nullptr);
+
+		virtual void setMutationAmount(double amount) = 0;
+		virtual double getMutationAmount() const = 0;
+
+		virtual void setParametersTestFunc(ParametersTestFunc func)
+		{
+			m_parametersTestFunc = func;
+		}
+
+		/**
+		 * @brief
+		 * Sets a test function that scores blocks of agents.
+		 * If set, it is used instead of the ParametersTestFunc.
+		 * The score of an agent is the sum of the score parts the function writes,
+		 * so the score parts labels must be set, without them the batch function is not used.
+		 */
+		virtual void setParametersBatchTestFunc(ParametersBatchTestFunc func)
+		{
+			m_parametersBatchTestFunc = func;
+		}
+
+		/**
+		 * @brief
+		 * Sets the scheduler on which the agents get tested.
+		 * @param scheduler nullptr uses TaskScheduler::getDefault()
+		 */
+		void setTaskScheduler(TaskScheduler* scheduler) { m_taskScheduler = scheduler; }
+		TaskScheduler& getTaskScheduler() const
+		{
+			if (m_taskScheduler)
+				return *m_taskScheduler;
+			return TaskScheduler::getDefault();
+		}
+
+		/**
+		 * @brief
+		 * Sets the priority of the jobs of this solver against other solvers on the same scheduler.
+		 * Free workers serve the solver with the highest priority first, equal priorities take turns.
+		 */
+		void setTaskPriority(int priority) { m_taskGroup.setPriority(priority); }
+		int getTaskPriority() const { return m_taskGroup.getPriority(); }
+
+		/**
+		 * @brief
+		 * Limits the number of workers that test and breed for this solver at the same time.
+		 * @param maxConcurrency 0 uses all workers of the scheduler
+		 */
+		void setMaxConcurrency(size_t maxConcurrency) { m_taskGroup.setMaxConcurrency(maxConcurrency); }
+		size_t getMaxConcurrency() const { return m_taskGroup.getMaxConcurrency(); }
+
+		/**
+		 * @return number of workers that may run tasks of this solver at the same time
+		 */
+		size_t getConcurrency() const { return getTaskScheduler().getConcurrency(&m_taskGroup); }
+
+		/**
+		 * @brief
+		 * Gets the group of the jobs of this solver, so helpers that run their own jobs can share its priority and limit
+		 */
+		TaskScheduler::Group& getTaskGroup() { return m_taskGroup; }
+
+		/**
+		 * @brief
+		 * Sets the number of agents tested in one scheduler task.
+		 * @param grainSize 0 lets the scheduler decide, a batch test function gets one block per worker
+		 */
+		void setTestGrainSize(size_t grainSize) { m_testGrainSize = grainSize; }
+		size_t getTestGrainSize() const { return m_testGrainSize; }
+
+		/**
+		 * @brief
+		 * Caches the score parts of tested parameter vectors.
+		 * An agent whose exact parameters are cached skips the test function.
+		 * A batch test function then only gets the missed agents, compacted into a block of their own,
+		 * so AgentBlock::getAgentIndex() is not the index in the population in that case.
+		 * @param capacity maximal number of cached agents, 0 disables the cache
+		 */
+		void setFitnessCacheCapacity(size_t capacity) { m_fitnessCache.setCapacity(capacity); }
+		size_t getFitnessCacheCapacity() const { return m_fitnessCache.getCapacity(); }
+
+		/**
+		 * @brief
+		 * Has to be changed whenever the test function scores the same parameters differently,
+		 * for example after a new step sequence got generated.
+		 */
+		void setFitnessContextVersion(uint64_t version) { m_fitnessCache.setContextVersion(version); }
+		uint64_t getFitnessContextVersion() const { return m_fitnessCache.getContextVersion(); }
+
+		/**
+		 * @brief
+		 * Gives access to the hit and miss counters of the cache
+		 */
+		FitnessCache& getFitnessCache() { return m_fitnessCache; }
+		const FitnessCache& getFitnessCache() const { return m_fitnessCache; }
+
+		/**
+		 * @brief
+		 * Racing lets a test function stop simulating an agent that can't survive the selection anymore.
+		 * After a generation got tested, the solver publishes a threshold score.
+		 * A test function whose score only grows during the simulation polls isRaceLost() with its partial score
+		 * and may stop early. It then returns a bounded score, for example the partial score extrapolated to the full horizon.
+		 * Such a score is worse than the threshold, so the agent still ranks behind all agents better than the threshold.
+		 * The bounded score only holds for the threshold of that moment, it is not stored in the fitness cache.
+		 * A batch test function marks the stopped agents with AgentBlock::setRaceLost().
+		 * Only used when minimizing.
+		 */
+		void setRacingEnabled(bool enabled);
+		bool isRacingEnabled() const { return m_racingEnabled; }
+
+		/**
+		 * @brief
+		 * Sets which agent of the last tested generation defines the threshold.
+		 * @param quantile 1 uses the worst agent, no agent better than any agent of the last generation gets stopped.
+		 *                 Smaller values stop earlier, but may stop agents that would have survived.
+		 */
+		void setRacingQuantile(double quantile) { m_racingQuantile = std::clamp(quantile, 0.0, 1.0); }
+		double getRacingQuantile() const { return m_racingQuantile; }
+
+		/**
+		 * @return the current threshold, infinity if racing is disabled or no generation was tested yet
+		 */
+		double getRacingThreshold() const { return m_racingThreshold.load(std::memory_order_relaxed); }
+
+		/**
+		 * @brief
+		 * Cheap check for test functions, thread safe.
+		 * @param partialScore sum of the score parts accumulated so far, a lower bound of the final score
+		 * @return true if the agent can stop, it is counted as an abort
+		 */
+		bool isRaceLost(double partialScore) const;
+		size_t getRacingAbortCount() const { return m_racingAbortCount.load(); }
+		void resetRacingAbortCount() { m_racingAbortCount.store(0); }
+
+		/**
+		 * @brief
+		 * Surrogate pre-screening of the offspring.
+		 * Every tested agent trains an RBF model of the score.
+		 * Solvers that support it breed a pool of candidates for each agent to test
+		 * and only send the candidate with the best predicted score to the test function.
+		 * Supported by the GeneticSolver with a single island and by the DifferentialEvolutionSolver.
+		 * @param poolSize candidates per tested agent, 1 disables the screening
+		 */
+		void setSurrogatePoolSize(size_t poolSize);
+		size_t getSurrogatePoolSize() const { return m_surrogatePoolSize; }
+
+		/**
+		 * @brief
+		 * Gives access to the model settings, like the capacity and the length scale
+		 */
+		RBFSurrogate& getSurrogate() { return m_surrogate; }
+		const RBFSurrogate& getSurrogate() const { return m_surrogate; }
+
+		const SurrogateStatistics& getSurrogateStatistics() const { return m_surrogateStatistics; }
+		void resetSurrogateStatistics() { m_surrogateStatistics = SurrogateStatistics(); }
+		virtual void setScorePartsLabels(const std::vector<std::string>& labels) { m_scorePartsLabels = labels; }
+		const std::vector<std::string>& getScorePartsLabels() const { return m_scorePartsLabels; }
+
+		/**
+		 * @brief
+		 * Copies the state that is shown by the painters into the snapshot.
+		 * The generation, epoch and history are set by the caller.
+		 * Solvers with additional state override it and call the base.
+		 */
+		virtual void writeSnapshot(SolverSnapshot& snapshot) const;
+
+		/**
+		 * @return the step size of the search distribution, 0 for solvers without one
+		 */
+		virtual double getStepSize() const { return 0; }
+
+		virtual const std::vector<double>& getAlltimeBestParameters() const = 0;
+		virtual const std::vector<double>& getBestParameters() const = 0;
+
+		virtual void clearAlltimeBestParameters() = 0;
+
+		virtual std::vector<double> getScores() = 0;
+
+
+		/**
+		 * @brief
+		 * Sets the seed of the random numbers used by the solver.
+		 * The same seed and the same initial parameters give the same run, independent of the thread count.
+		 */
+		virtual void setSeed(uint64_t seed)
+		{
+			m_seed = seed;
+			m_random.setSeed(seed);
+		}
+		uint64_t getSeed() const { return m_seed; }
+
+		/**
+		 * @brief
+		 * Creates an independent random stream of the solver seed,
+		 * for example one per epoch and agent pair, so the work can be split over threads.
+		 */
+		RandomStream createRandomStream(uint32_t streamA, uint32_t streamB = 0) const
+		{
+			return RandomStream(m_seed, streamA, streamB);
+		}
+
+		/**
+		 * @brief
+		 * Reserved streamA ids of createRandomStream(), so no two users draw the same numbers.
+		 * The solvers use the generation as streamA of their per generation streams, which stays far below these ids.
+		 * The ids from s_problemStream up to below s_steadyStateStream belong to the test problem,
+		 * for example s_problemStream for random test inputs and s_problemStream + 1 for measurement noise.
+		 */
+		static constexpr uint32_t s_populationStream = 0xFFFFFFFF;	// Initial population built by the caller
+		static constexpr uint32_t s_islandStream = 0xFFFFFFFE;		// GeneticSolver, one stream per island
+		static constexpr uint32_t s_steadyStateStream = 0xFFFFFFFD;	// GeneticSolver, one stream per steady-state child
+		static constexpr uint32_t s_problemStream = 0xFFFFFFF0;
+
+		/**
+		 * @brief
+		 * Random helpers on the stream of the calling thread.
+		 * See RandomStream::setThreadStreamSeed() to make them reproducible.
+		 */
+		static double getRandomDouble(double min, double max)
+		{
+			return RandomStream::getThreadStream().getDouble(min, max);
+		}
+		static double getRandomGaussDouble(double min, double max)
+		{
+			return RandomStream::getThreadStream().getGaussDouble(min, max);
+		}
+
+		// Inclusive
+		static size_t getRandomSizeT(size_t min, size_t max)
+		{
+			return RandomStream::getThreadStream().getSizeT(min, max);
+		}
+
+	protected:
+		void notifyGeneration(const PopulationStore::Generation& generation)
+		{
+			if (m_observer)
+				m_observer->onGeneration(*this, generation);
+		}
+		void notifyReset()
+		{
+			if (m_observer)
+				m_observer->onReset(*this);
+		}
+
+		bool hasTestFunc() const
+		{
+			return m_parametersTestFunc || useBatchTestFunc();
+		}
+		bool useBatchTestFunc() const
+		{
+			// Without score parts there is no row the batch function could write the score to
+			return m_parametersBatchTestFunc && !m_scorePartsLabels.empty();
+		}
+
+		/**
+		 * @brief
+		 * Runs a job on the scheduler of the solver, with the priority and concurrency limit of the solver
+		 */
+		void parallelFor(size_t count, size_t grainSize, const TaskScheduler::RangeFunc& func)
+		{
+			getTaskScheduler().parallelFor(count, grainSize, func, &m_taskGroup);
+		}
+
+		/**
+		 * @brief
+		 * Tests all agents of the generation in parallel on the task scheduler.
+		 * The score parts get stored in the generation and the score of each agent is set to their sum.
+		 */
+		void testGeneration(PopulationStore::Generation& generation);
+
+		/**
+		 * @brief
+		 * Tests the agents [begin, end) of the generation on the calling thread.
+		 * @param agentIndexOffset added to the agent index passed to the test functions,
+		 *                         when the generation is only a part of the population
+		 */
+		void testAgents(PopulationStore::Generation& generation, size_t begin, size_t end, size_t agentIndexOffset = 0);
+
+		/**
+		 * @brief
+		 * Publishes the racing threshold for the next tests, from the scores of a tested generation.
+		 * Has to be called by the solver whenever the scores an agent has to beat changed.
+		 */
+		void updateRacingThreshold(const PopulationStore::Generation& generation);
+
+		/**
+		 * @brief
+		 * Removes the threshold until the next updateRacingThreshold(),
+		 * for example when the solver restarts in another region
+		 */
+		void resetRacingThreshold() { m_racingThreshold.store(std::numeric_limits<double>::infinity()); }
+
+		/**
+		 * @return true if the solver should breed candidate pools, the surrogate is trained and fitted
+		 */
+		bool isSurrogateScreening() const { return m_surrogatePoolSize > 1 && m_surrogate.isReady(); }
+
+		/**
+		 * @brief
+		 * Adds the scores of a tested generation to the surrogate and fits it.
+		 * At most half the surrogate capacity gets added, evenly spaced over the generation.
+		 * The model gets cleared when the fitness context version changed.
+		 */
+		void trainSurrogate(const PopulationStore::Generation& generation);
+
+		/**
+		 * @return true if the predicted score a is better than b
+		 */
+		bool isPredictionBetter(double a, double b) const
+		{
+			if (m_optimizingDirection == OptimizingDirection::Minimize)
+				return a < b;
+			return a > b;
+		}
+
+		SurrogateStatistics m_surrogateStatistics;
+
+		OptimizingDirection m_optimizingDirection = OptimizingDirection::Maximize;
+		ParametersTestFunc m_parametersTestFunc = nullptr;
+		ParametersBatchTestFunc m_parametersBatchTestFunc = nullptr;
+
+		// Stream 0 of the seed, used for the sequential parts of an epoch
+		uint64_t m_seed = RandomStream::s_defaultSeed;
+		RandomStream m_random;
+
+	private:
+		void testAgentsBatchCached(PopulationStore::Generation& generation, size_t begin, size_t end, size_t agentIndexOffset);
+
+		std::string m_name;
+		Observer* m_observer = nullptr;
+		std::vector<std::string> m_scorePartsLabels;
+
+		TaskScheduler* m_taskScheduler = nullptr;
+		TaskScheduler::Group m_taskGroup;
+		size_t m_testGrainSize = 0;
+		FitnessCache m_fitnessCache;
+
+		bool m_racingEnabled = false;
+		double m_racingQuantile = 1.0;
+		std::atomic<double> m_racingThreshold{ std::numeric_limits<double>::infinity() };
+		mutable std::atomic<size_t> m_racingAbortCount{ 0 };
+		std::vector<double> m_racingScores;
+
+		size_t m_surrogatePoolSize = 1;
+		RBFSurrogate m_surrogate;
+		uint64_t m_surrogateContextVersion = 0;
+		std::vector<double> m_surrogateParameters;
+	};
+}
\ No newline at end of file
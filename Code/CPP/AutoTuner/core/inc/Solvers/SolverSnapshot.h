@@ -0,0 +1,52 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include "Solvers/Solver.h"
+#include <memory>
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Copy of the state of a solver after one generation.
+	 * Painters and charts draw from a snapshot, so they do not touch the solver while it runs on another thread.
+	 * Published snapshots are shared read-only through a Handle and go back to their pool when the last handle is dropped.
+	 */
+	struct AUTO_TUNER_API SolverSnapshot
+	{
+		typedef std::shared_ptr<const SolverSnapshot> Handle;
+
+		struct HistoryEntry
+		{
+			size_t epoch = 0;
+			double bestScore = 0;
+			double averageScore = 0;
+			double worstScore = 0;
+			double stepSize = 0;	// CMAESSolver only
+		};
+
+		size_t version = 0;		// Increases with every published snapshot, also across resets
+		size_t epoch = 0;		// Index of the epoch of the generation since the last reset
+		size_t resetCount = 0;	// Changes when the solver forgot its history, the generation is empty right after a reset
+
+		PopulationStore::Generation generation;
+		std::vector<std::string> scorePartsLabels;
+		std::vector<double> bestParameters;
+		std::vector<double> alltimeBestParameters;
+		Solver::SurrogateStatistics surrogateStatistics;
+
+		double stepSize = 0;										// CMAESSolver only
+		std::vector<std::vector<double>> paretoFrontScoreParts;	// NSGA2Solver only
+
+		// One entry per epoch since the last reset, oldest first
+		std::vector<HistoryEntry> history;
+
+		/**
+		 * @brief
+		 * Summarizes the scores of a generation for the history
+		 * @param direction of the solver, decides which score is the best one
+		 */
+		static HistoryEntry createHistoryEntry(const PopulationStore::Generation& generation, size_t epoch,
+			double stepSize, Solver::OptimizingDirection direction);
+	};
+}
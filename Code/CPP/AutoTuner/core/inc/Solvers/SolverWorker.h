@@ -0,0 +1,134 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include "Solvers/Solver.h"
+#include "Solvers/SolverSnapshot.h"
+#include "Utilities/TripleBuffer.h"
+#include "Utilities/ObjectPool.h"
+#include <thread>
+#include <limits>
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Runs the epochs of a solver on a dedicated thread.
+	 * The worker publishes SolverSnapshot handles through a lock-free triple buffer.
+	 * A GUI thread reads the newest snapshot at its own frame rate, so neither side throttles the other.
+	 * A generation only gets copied into a snapshot once the reader took the previous one,
+	 * the epochs in between only extend the history. The last generation of a run is always published.
+	 * The snapshots come from a pool, a snapshot nobody holds anymore gets refilled without allocating.
+	 *
+	 * The worker is the observer of its solver, so it also publishes the generations and resets
+	 * of a solver that is stepped by hand while the worker is stopped.
+	 * While the worker runs, the solver must not be used by other threads.
+	 * Stop the worker to change the solver settings, the initial parameters or the test function data.
+	 */
+	class AUTO_TUNER_API SolverWorker : private Solver::Observer
+	{
+	public:
+		/**
+		 * @brief
+		 * Called on the worker thread after each generation with the number of generations since the last reset.
+		 * The solver is in the middle of its epoch, read the scores and parameters from the generation.
+		 * @return false to stop the worker
+		 */
+		typedef std::function<bool(size_t epoch, const PopulationStore::Generation& generation)> EpochCallback;
+
+		/**
+		 * @param solver is not owned by the worker
+		 */
+		SolverWorker(Solver* solver = nullptr);
+		SolverWorker(const SolverWorker&) = delete;
+		SolverWorker& operator=(const SolverWorker&) = delete;
+		~SolverWorker();
+
+		/**
+		 * @brief
+		 * Sets the solver and observes it, stops the worker first
+		 */
+		void setSolver(Solver* solver);
+		Solver* getSolver() const { return m_solver; }
+
+		void setEpochCallback(EpochCallback callback) { m_epochCallback = callback; }
+
+		/**
+		 * @brief
+		 * Sets the maximal number of epochs kept in the history of the snapshots
+		 */
+		void setHistorySize(size_t size) { m_historySize = size; }
+		size_t getHistorySize() const { return m_historySize; }
+
+		/**
+		 * @brief
+		 * Starts running epochs on the worker thread, does nothing if the worker already runs
+		 * @param epochCount number of epochs to run, 0 runs until stop() is called
+		 */
+		void start(size_t epochCount = 0);
+
+		/**
+		 * @brief
+		 * Stops after the current epoch and waits for the thread to finish
+		 */
+		void stop();
+
+		/**
+		 * @return true while the worker thread runs epochs
+		 */
+		bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+
+		/**
+		 * @return number of generations since the last reset of the solver
+		 */
+		size_t getEpoch() const { return m_epoch.load(std::memory_order_relaxed); }
+
+		/**
+		 * @brief
+		 * Takes the newest published snapshot and asks the worker for the next one, for a single reader thread
+		 * @return true if the snapshot changed since the last call
+		 */
+		bool updateSnapshot()
+		{
+			m_snapshotRequested.store(true, std::memory_order_relaxed);
+			return m_snapshots.update();
+		}
+
+		/**
+		 * @brief
+		 * Gets the snapshot of the last updateSnapshot(), nullptr before the first generation.
+		 * Keep a copy of the handle to hold on to the snapshot after the next updateSnapshot().
+		 */
+		const SolverSnapshot::Handle& getSnapshot() const { return m_snapshots.getReadBuffer(); }
+
+	private:
+		void onGeneration(const Solver& solver, const PopulationStore::Generation& generation) override;
+		void onReset(const Solver& solver) override;
+
+		void threadFunction(size_t epochCount);
+		void addHistoryEntry(const SolverSnapshot::HistoryEntry& entry);
+		void writeHistory(SolverSnapshot& snapshot) const;
+		void publish(const std::shared_ptr<SolverSnapshot>& snapshot);
+
+		Solver* m_solver = nullptr;
+		EpochCallback m_epochCallback = nullptr;
+
+		std::thread m_thread;
+		std::atomic<bool> m_running{ false };
+		std::atomic<bool> m_stopRequested{ false };
+		std::atomic<size_t> m_epoch{ 0 };
+		std::atomic<bool> m_snapshotRequested{ true };
+
+		// Worker thread only
+		size_t m_runEpochCount = 0;	// 0 runs until stop()
+		size_t m_runEpoch = 0;
+		bool m_stopAfterEpoch = false;
+		bool m_generationPublished = true;
+
+		TripleBuffer<SolverSnapshot::Handle> m_snapshots;
+		ObjectPool<SolverSnapshot> m_snapshotPool;
+		size_t m_version = 0;
+		std::vector<SolverSnapshot::HistoryEntry> m_history;	// Trimmed in batches, holds up to twice the history size
+		size_t m_historySize = 1000;
+		size_t m_resetCount = 0;
+	};
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Bounded cache of score parts, keyed by the exact bits of a parameter vector and a context version.
+	 * The context version lets a problem invalidate all entries when its test changes,
+	 * for example when a new step sequence is used.
+	 *
+	 * The entries are split into shards with their own lock, so the test workers rarely wait on each other.
+	 * A full shard replaces its oldest entry.
+	 */
+	class AUTO_TUNER_API FitnessCache
+	{
+	public:
+		/**
+		 * @param capacity maximal number of entries, 0 disables the cache
+		 */
+		FitnessCache(size_t capacity = 0, size_t shardCount = 16);
+		FitnessCache(const FitnessCache&) = delete;
+		FitnessCache& operator=(const FitnessCache&) = delete;
+
+		/**
+		 * @brief
+		 * Changes the capacity, removes all entries
+		 */
+		void setCapacity(size_t capacity);
+		size_t getCapacity() const { return m_capacity; }
+		bool isEnabled() const { return m_capacity > 0; }
+
+		/**
+		 * @brief
+		 * Entries of other context versions are not found anymore.
+		 */
+		void setContextVersion(uint64_t version) { m_contextVersion.store(version); }
+		uint64_t getContextVersion() const { return m_contextVersion.load(); }
+
+		/**
+		 * @return true if the parameters are cached, the score parts are written to scoreParts
+		 */
+		bool lookup(const std::vector<double>& parameters, std::vector<double>& scoreParts);
+		void insert(const std::vector<double>& parameters, const std::vector<double>& scoreParts);
+
+		void clear();
+		size_t size() const;
+
+		size_t getHitCount() const { return m_hitCount.load(); }
+		size_t getMissCount() const { return m_missCount.load(); }
+		void resetCounters();
+
+	private:
+		struct Key
+		{
+			uint64_t contextVersion = 0;
+			std::vector<uint64_t> bits;
+
+			bool operator==(const Key& other) const
+			{
+				return contextVersion == other.contextVersion && bits == other.bits;
+			}
+		};
+		struct KeyHash
+		{
+			size_t operator()(const Key& key) const;
+		};
+		struct Shard
+		{
+			std::mutex mutex;
+			std::unordered_map<Key, std::vector<double>, KeyHash> entries;
+			std::vector<Key> insertionOrder;	// Ring buffer of the keys, oldest at nextEviction
+			size_t nextEviction = 0;
+		};
+
+		Key makeKey(const std::vector<double>& parameters) const;
+		Shard& getShard(const Key& key);
+
+		size_t m_capacity = 0;
+		size_t m_shardCapacity = 0;
+		std::vector<std::unique_ptr<Shard>> m_shards;
+		std::atomic<uint64_t> m_contextVersion{ 0 };
+		std::atomic<size_t> m_hitCount{ 0 };
+		std::atomic<size_t> m_missCount{ 0 };
+	};
+}
@@ -2,6 +2,7 @@
 
 #include "AutoTuner_base.h"
 #include "Utilities/TimeBasedSystem.h"
+#include "Utilities/TaskScheduler.h"
 #include <complex>
 
 namespace AutoTuner
@@ -24,6 +25,17 @@ namespace AutoTuner
 		};
 		
 
+		enum class Method
+		{
+			TimeDomainSweep,	// Simulates a sine at each frequency and measures the output phasor
+			Analytic,			// Uses TimeBasedSystem::getFrequencyResponse(), the response stays empty if the system has no linear model
+			ParallelSweep,		// Sweeps runs of neighbouring frequencies on clones of the system, the runs execute concurrently
+			Multisine,			// One simulation excited with a Schroeder phased multisine, evaluated with an FFT
+			Chirp,				// One simulation excited with a periodic logarithmic chirp, evaluated with an FFT
+			Auto				// Analytic if the system supports it, otherwise ParallelSweep
+		};
+		
+
 		FrequencyResponse();
 		~FrequencyResponse();
 
@@ -36,17 +48,154 @@ namespace AutoTuner
 		void setSignalGain(double gain) { m_signalGain = gain; }
 		double getSignalGain() const { return m_signalGain; }
 
+		void setMethod(Method method) { m_method = method; }
+		Method getMethod() const { return m_method; }
+
+		/**
+		 * @brief
+		 * Sets the scheduler used by Method::ParallelSweep.
+		 * @param scheduler nullptr uses TaskScheduler::getDefault()
+		 */
+		void setTaskScheduler(TaskScheduler* scheduler) { m_taskScheduler = scheduler; }
+		TaskScheduler& getTaskScheduler() const
+		{
+			if (m_taskScheduler)
+				return *m_taskScheduler;
+			return TaskScheduler::getDefault();
+		}
+
+		/**
+		 * @brief
+		 * Sets the group the jobs of Method::ParallelSweep belong to, for example Solver::getTaskGroup().
+		 * @param group nullptr uses the group of the calling task, a sweep started by a test function
+		 *              therefore stays within the priority and limit of its solver
+		 */
+		void setTaskGroup(TaskScheduler::Group* group) { m_taskGroup = group; }
+		TaskScheduler::Group* getTaskGroup() const { return m_taskGroup; }
+
+		/**
+		 * @brief
+		 * Settling of the parallel sweep ends as soon as the output phasor of two consecutive periods
+		 * differs by less than tolerance * |phasor|.
+		 * It gets cut off after maxSettlingPeriods periods, whatever the frequency.
+		 */
+		void setSettlingTolerance(double tolerance) { m_settlingTolerance = tolerance; }
+		double getSettlingTolerance() const { return m_settlingTolerance; }
+		void setMaxSettlingPeriods(size_t periods) { m_maxSettlingPeriods = periods; }
+		size_t getMaxSettlingPeriods() const { return m_maxSettlingPeriods; }
+		void setMeasuringPeriods(size_t periods) { m_measuringPeriods = periods; }
+		size_t getMeasuringPeriods() const { return m_measuringPeriods; }
+
+		/**
+		 * @brief
+		 * Number of neighbouring frequencies Method::ParallelSweep measures one after the other on the same clone.
+		 * Each point starts from the settled state of the previous one, so longer runs settle faster
+		 * but leave fewer runs to execute concurrently.
+		 */
+		void setSweepRunLength(size_t points) { m_sweepRunLength = points; }
+		size_t getSweepRunLength() const { return m_sweepRunLength; }
+
+		/**
+		 * @brief
+		 * Samples per period of the highest frequency for Method::Multisine and Method::Chirp.
+		 * The excitation period gets rounded up to a power of two samples for the FFT.
+		 */
+		void setIdentificationOversampling(size_t samples) { m_identificationOversampling = samples; }
+		size_t getIdentificationOversampling() const { return m_identificationOversampling; }
+
+		/**
+		 * @brief
+		 * Excitation periods simulated before the measured period for Method::Multisine and Method::Chirp.
+		 * The first of them fades the excitation in.
+		 * The wrap of the chirp also drives the lines below its run, a lightly damped mode there needs more periods,
+		 * or Method::Multisine, which leaves these lines without energy.
+		 */
+		void setIdentificationSettlingPeriods(size_t periods) { m_identificationSettlingPeriods = periods; }
+		size_t getIdentificationSettlingPeriods() const { return m_identificationSettlingPeriods; }
+
+		/**
+		 * @brief
+		 * Splits the range of Method::Multisine and Method::Chirp into runs of at most the given number of decades.
+		 * The period of a run is 1 / baseFrequency with baseFrequency = f_first / ceil(f_first / (f_second - f_first)),
+		 * sampled with at least oversampling samples per period of its highest frequency, rounded up to a power of two.
+		 * With 10 points per decade and an oversampling of 50, a one decade run has 2048 samples per period
+		 * and costs (settlingPeriods + 1) * 2048 updates, 24576 updates for 0.1 Hz to 1000 Hz with the defaults.
+		 * A single run over 0.1 Hz to 1000 Hz would need 2^21 samples per period instead.
+		 * @param decades 0 identifies the whole range in a single run
+		 */
+		void setIdentificationDecadesPerRun(double decades) { m_identificationDecadesPerRun = decades; }
+		double getIdentificationDecadesPerRun() const { return m_identificationDecadesPerRun; }
+
 		void setInputIndex(size_t index) { m_inputIndex = index; }
 		size_t getInputIndex() const { return m_inputIndex; }
 		void setOutputIndex(size_t index) { m_outputIndex = index; }
 		size_t getOutputIndex() const { return m_outputIndex; }
 		
+		/**
+		 * @brief
+		 * Measures the response between startFrequency and endFrequency with the selected method
+		 * @return the response, its responsePoints are empty if Method::Analytic is selected and the system has no linear model
+		 */
 		FrequencyResponseData getResponse(TimeBasedSystem& system, double startFrequency, double endFrequency) const;
 
 
 
 		//static void drawNyquistPlot(const std::vector<FrequencyResponsePoint>& response, const char* title = "Nyquist Plot");
 	private:
+		bool getAnalyticResponse(TimeBasedSystem& system, const std::vector<double>& frequencies, FrequencyResponseData& data) const;
+		void getSweepResponse(TimeBasedSystem& system, const std::vector<double>& frequencies, FrequencyResponseData& data) const;
+		void getParallelSweepResponse(TimeBasedSystem& system, const std::vector<double>& frequencies, FrequencyResponseData& data) const;
+
+		/**
+		 * @brief
+		 * Measures the gain of a single frequency on the given system, starting from its current state
+		 */
+		std::complex<double> measureGain(TimeBasedSystem& system, double frequency) const;
+
+		/**
+		 * @brief
+		 * Fits a sine of the oscillator frequency plus a quadratic trend to whole periods of the signals.
+		 * The trend takes up a transient that decays slowly compared to the period, so it does not leak into the phasor.
+		 * @param oscillator e^(j*omega*t) at the samples of one period
+		 * @param periods number of periods in input and output
+		 */
+		static void fitPhasors(const std::vector<std::complex<double>>& oscillator, const double* input, const double* output,
+			size_t periods, std::complex<double>& inputPhasor, std::complex<double>& outputPhasor);
+
+		/**
+		 * @brief
+		 * Splits the frequencies into runs of at most m_identificationDecadesPerRun decades and identifies them one after the other
+		 */
+		void getIdentifiedResponse(TimeBasedSystem& system, const std::vector<double>& frequencies, Method method, FrequencyResponseData& data) const;
+
+		/**
+		 * @brief
+		 * Excites the system from rest with one periodic broadband signal and divides the output spectrum by the input spectrum.
+		 * The frequencies get moved to the nearest line of the excitation period, the points get appended to data.
+		 */
+		void identifyRun(TimeBasedSystem& system, const std::vector<double>& frequencies, Method method, FrequencyResponseData& data) const;
+
+		/**
+		 * @brief
+		 * Refits the lines 1 to highestLine of the spectrum together with a quadratic trend over the period.
+		 * The trend takes up a transient that has not decayed yet, so it does not leak into the lines.
+		 * @param samples one period of the signal
+		 * @param spectrum FFT of the samples, the lines get replaced by the fitted ones
+		 */
+		static void removeTrend(const std::vector<double>& samples, size_t highestLine, std::vector<std::complex<double>>& spectrum);
+
+		/**
+		 * @brief
+		 * In place radix-2 FFT, data.size() must be a power of two
+		 */
+		static void fft(std::vector<std::complex<double>>& data, bool inverse);
+
+		/**
+		 * @brief
+		 * Finds the crossover frequencies, gain margin and phase margin from data.responsePoints
+		 */
+		static void computeMargins(FrequencyResponseData& data);
+
 		static std::complex<double> computePhasor(const std::vector<double>& signal, double freq, double dt);
 		static std::vector<double> logspace(double start, double end, int n);
 
@@ -55,6 +204,18 @@ namespace AutoTuner
 		double m_settelingTime		= 10;
 		//double m_deltaTime			= 0.005;
 		size_t m_pointsPerDecade	= 10;
+		Method m_method = Method::Auto;
+		TaskScheduler* m_taskScheduler = nullptr;
+		TaskScheduler::Group* m_taskGroup = nullptr;
+
+		double m_settlingTolerance	= 1e-4;
+		size_t m_maxSettlingPeriods	= 5;
+		size_t m_measuringPeriods	= 2;
+		size_t m_sweepRunLength		= 5;
+
+		size_t m_identificationOversampling		= 50;
+		size_t m_identificationSettlingPeriods	= 2;
+		double m_identificationDecadesPerRun	= 1;
 
 		size_t m_inputIndex = 0;
 		size_t m_outputIndex = 0;
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include <vector>
+#include <complex>
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Small dense matrix helpers for the system classes.
+	 * All matrices are std::vector<double> in row-major order: element (row, col) is located at [row * cols + col].
+	 */
+	class AUTO_TUNER_API LinearAlgebra
+	{
+	public:
+		static std::vector<double> identity(size_t n);
+
+		/**
+		 * @brief
+		 * result = a * b
+		 * @param a matrix with rows x inner elements
+		 * @param b matrix with inner x cols elements
+		 */
+		static void multiply(const std::vector<double>& a, const std::vector<double>& b,
+			size_t rows, size_t inner, size_t cols, std::vector<double>& result);
+
+		/**
+		 * @brief
+		 * LU decomposition with partial pivoting, done in place.
+		 * @param a square n x n matrix, gets replaced by L (below the diagonal, unit diagonal) and U
+		 * @param pivot row permutation, row i of the decomposed matrix is row pivot[i] of the original
+		 * @return false if the matrix is singular
+		 */
+		static bool luDecompose(std::vector<double>& a, size_t n, std::vector<size_t>& pivot);
+
+		/**
+		 * @brief
+		 * Solves A * X = B for X using the decomposition of luDecompose().
+		 * @param b n x cols matrix, gets replaced by the solution
+		 */
+		static void luSolve(const std::vector<double>& lu, const std::vector<size_t>& pivot, size_t n,
+			std::vector<double>& b, size_t cols);
+
+		/**
+		 * @brief
+		 * Solves A * X = B for X
+		 * @return false if A is singular
+		 */
+		static bool solve(std::vector<double> a, size_t n, std::vector<double>& b, size_t cols);
+
+		/**
+		 * @brief
+		 * Matrix exponential e^A using a diagonal Pade approximation of degree 6 with scaling and squaring
+		 */
+		static std::vector<double> expm(const std::vector<double>& a, size_t n);
+
+		static double normInf(const std::vector<double>& a, size_t rows, size_t cols);
+
+		/**
+		 * @brief
+		 * Reduces A to upper Hessenberg form H = Q^T * A * Q using Householder reflections, done in place.
+		 * @param a square n x n matrix, gets replaced by H
+		 * @param q gets the orthogonal n x n matrix Q
+		 */
+		static void hessenbergReduce(std::vector<double>& a, size_t n, std::vector<double>& q);
+
+		/**
+		 * @brief
+		 * Solves (shift * I - H) * x = b for an upper Hessenberg matrix H in O(n^2).
+		 * @param b right hand side, gets replaced by the solution
+		 * @return false if the shifted matrix is singular
+		 */
+		static bool solveShiftedHessenberg(const std::vector<double>& h, size_t n, std::complex<double> shift,
+			std::vector<std::complex<double>>& b);
+
+		/**
+		 * @brief
+		 * Eigen decomposition A = V * diag(values) * V^T of a symmetric matrix, using cyclic Jacobi rotations.
+		 * @param a symmetric n x n matrix, only read
+		 * @param values gets the n eigenvalues
+		 * @param vectors gets the n x n matrix V, column i is the eigenvector of values[i]
+		 * @return false if the rotations did not converge
+		 */
+		static bool symmetricEigen(const std::vector<double>& a, size_t n,
+			std::vector<double>& values, std::vector<double>& vectors);
+	};
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Hands out reference counted objects and takes them back when the last reference is dropped.
+	 * A returned object keeps its state and the capacity of its containers, so refilling it does not allocate.
+	 * References may be dropped on any thread, the pool itself may be destroyed before its objects.
+	 */
+	template<typename T>
+	class ObjectPool
+	{
+	public:
+		/**
+		 * @param maxFreeCount number of free objects kept for reuse, objects above are deleted
+		 */
+		ObjectPool(size_t maxFreeCount = 4)
+			: m_storage(std::make_shared<Storage>())
+		{
+			m_storage->maxFreeCount = maxFreeCount;
+		}
+		ObjectPool(const ObjectPool&) = delete;
+		ObjectPool& operator=(const ObjectPool&) = delete;
+
+		/**
+		 * @brief
+		 * Gets a free object or creates a new one.
+		 * A reused object still holds the values of its last use.
+		 */
+		std::shared_ptr<T> acquire()
+		{
+			T* object = nullptr;
+			{
+				std::lock_guard<std::mutex> lock(m_storage->mutex);
+				if (!m_storage->free.empty())
+				{
+					object = m_storage->free.back().release();
+					m_storage->free.pop_back();
+				}
+			}
+			if (!object)
+				object = new T();
+
+			// The deleter keeps the storage alive until the last object came back
+			std::shared_ptr<Storage> storage = m_storage;
+			return std::shared_ptr<T>(object, [storage](T* object)
+				{
+					std::unique_ptr<T> owned(object);
+					std::lock_guard<std::mutex> lock(storage->mutex);
+					if (storage->free.size() < storage->maxFreeCount)
+						storage->free.push_back(std::move(owned));
+				});
+		}
+
+		size_t getFreeCount() const
+		{
+			std::lock_guard<std::mutex> lock(m_storage->mutex);
+			return m_storage->free.size();
+		}
+
+	private:
+		struct Storage
+		{
+			std::mutex mutex;
+			std::vector<std::unique_ptr<T>> free;
+			size_t maxFreeCount = 4;
+		};
+		std::shared_ptr<Storage> m_storage;
+	};
+}
@@ -163,6 +163,13 @@ namespace AutoTuner
 				return m_inputValue;
 			return 0.0;
 		}
+
+		/**
+		 * @brief
+		 * Linear transfer function Kp + Ki/s + Kd*s, or Kd*Kn*s/(s+Kn) for the filtered derivative.
+		 * Saturation and anti windup are not part of the linear model.
+		 */
+		bool getFrequencyResponse(double omega, size_t inputIndex, size_t outputIndex, std::complex<double>& response) override;
 	private:
 		
 		//PIDType m_pidType = PIDType::PID;
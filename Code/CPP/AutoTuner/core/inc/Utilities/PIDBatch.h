@@ -0,0 +1,154 @@
+#pragma once
+
+#include "AutoTuner_base.h"
+#include "Utilities/PID.h"
+#include "Utilities/SimdDouble.h"
+#include <vector>
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Advances many PID controllers at once.
+	 * All controllers share the same configuration (derivative type, anti-windup method, solvers)
+	 * but each one has its own gains, limits and state.
+	 * The values are stored structure-of-arrays, one contiguous row per value,
+	 * so one update processes SimdDouble::s_laneCount controllers per instruction.
+	 * Saturation and anti-windup are evaluated with compare masks instead of branches.
+	 *
+	 * Precision::Strict uses the same operation order as PID::update() and gives bitwise identical results.
+	 * Precision::Fast replaces the division by the time step with a multiplication
+	 * and clamps with min/max instructions, results may differ in the last bits.
+	 */
+	class AUTO_TUNER_API PIDBatch
+	{
+	public:
+		enum class Precision
+		{
+			Fast,
+			Strict
+		};
+
+		PIDBatch(size_t count = 0);
+
+		/**
+		 * @brief
+		 * Changes the number of controllers.
+		 * New controllers get the default values of a PID, existing controllers are kept.
+		 */
+		void resize(size_t count);
+		size_t size() const { return m_count; }
+
+		/**
+		 * @brief
+		 * Resets the state of all controllers, gains and limits are kept
+		 */
+		void reset();
+
+		// Configuration shared by all controllers
+		void setPrecision(Precision precision) { m_precision = precision; }
+		Precision getPrecision() const { return m_precision; }
+		void setAntiWindupMethod(PID::AntiWindupMethod method) { m_antiWindupMethod = method; }
+		PID::AntiWindupMethod getAntiWindupMethod() const { return m_antiWindupMethod; }
+		void setDerivativeType(PID::DerivativeType type) { m_derivativeType = type; }
+		PID::DerivativeType getDerivativeType() const { return m_derivativeType; }
+		void setIntegrationSolver(TimeBasedSystem::IntegrationSolver solver) { m_integrationSolver = solver; }
+		TimeBasedSystem::IntegrationSolver getIntegrationSolver() const { return m_integrationSolver; }
+		void setDifferentiationSolver(TimeBasedSystem::DifferentiationSolver solver) { m_differentiationSolver = solver; }
+		TimeBasedSystem::DifferentiationSolver getDifferentiationSolver() const { return m_differentiationSolver; }
+
+		/**
+		 * @brief
+		 * Takes over the shared configuration of a scalar PID
+		 * and its gains and limits for all controllers
+		 */
+		void setConfiguration(const PID& pid);
+
+		/**
+		 * @brief
+		 * Takes over the gains and limits of a scalar PID for one controller
+		 */
+		void setController(size_t index, const PID& pid);
+
+		// Per controller values
+		void setParameters(size_t index, double kp, double ki, double kd, double kn = 0.0);
+		double getKp(size_t index) const { return m_kp[index]; }
+		double getKi(size_t index) const { return m_ki[index]; }
+		double getKd(size_t index) const { return m_kd[index]; }
+		double getKn(size_t index) const { return m_kn[index]; }
+
+		void setIntegralSatturationLimit(size_t index, double limit) { m_iSaturationLimit[index] = std::max(0.0, limit); }
+		double getIntegralSatturationLimit(size_t index) const { return m_iSaturationLimit[index]; }
+		void setAntiWindupBackCalculationConstant(size_t index, double constant) { m_backCalculationConstant[index] = constant; }
+		double getAntiWindupBackCalculationConstant(size_t index) const { return m_backCalculationConstant[index]; }
+		void setOutputSaturationLimits(size_t index, double lowerLimit, double upperLimit)
+		{
+			m_outputSaturationLimitLower[index] = lowerLimit;
+			m_outputSaturationLimitUpper[index] = upperLimit;
+		}
+		/**
+		 * @brief
+		 * Sets the output limits of all controllers
+		 */
+		void setOutputSaturationLimits(double lowerLimit, double upperLimit);
+		std::pair<double, double> getOutputSaturationLimits(size_t index) const
+		{
+			return { m_outputSaturationLimitLower[index], m_outputSaturationLimitUpper[index] };
+		}
+
+		/**
+		 * @brief
+		 * Advances all controllers by one time step
+		 */
+		void update(double deltaTime);
+
+		void setInput(size_t index, double u) { m_inputValue[index] = u; }
+		double getInput(size_t index) const { return m_inputValue[index]; }
+		double getOutput(size_t index) const { return m_outputValue[index]; }
+		double getIntegral(size_t index) const { return m_integral[index]; }
+
+		/**
+		 * @brief
+		 * Direct access to the contiguous input and output rows.
+		 * The rows hold size() values followed by padding up to a multiple of the lane count.
+		 */
+		double* getInputs() { return m_inputValue.data(); }
+		const double* getInputs() const { return m_inputValue.data(); }
+		const double* getOutputs() const { return m_outputValue.data(); }
+
+		bool isOutputPositiveSaturated(size_t index) const { return m_outputPositiveSaturated[index] != 0.0; }
+		bool isOutputNegativeSaturated(size_t index) const { return m_outputNegativeSaturated[index] != 0.0; }
+		bool isOutputSaturated(size_t index) const { return isOutputPositiveSaturated(index) || isOutputNegativeSaturated(index); }
+
+	private:
+		template<bool strict>
+		void updateLanes(double deltaTime);
+
+		size_t m_count = 0;
+		Precision m_precision = Precision::Strict;
+		PID::AntiWindupMethod m_antiWindupMethod = PID::AntiWindupMethod::None;
+		PID::DerivativeType m_derivativeType = PID::DerivativeType::Unfiltered;
+		TimeBasedSystem::IntegrationSolver m_integrationSolver;
+		TimeBasedSystem::DifferentiationSolver m_differentiationSolver;
+
+		// Gains and limits
+		std::vector<double> m_kp;
+		std::vector<double> m_ki;
+		std::vector<double> m_kd;
+		std::vector<double> m_kn;
+		std::vector<double> m_backCalculationConstant;
+		std::vector<double> m_iSaturationLimit;
+		std::vector<double> m_outputSaturationLimitLower;
+		std::vector<double> m_outputSaturationLimitUpper;
+
+		// State
+		std::vector<double> m_integral;
+		std::vector<double> m_inputValue;
+		std::vector<double> m_lastInputValue;
+		std::vector<double> m_lastDerivativeValue;
+		std::vector<double> m_outputValue;
+		std::vector<double> m_outputValueBeforeSaturation;
+		std::vector<double> m_outputPositiveSaturated; // 1.0 if saturated, otherwise 0.0
+		std::vector<double> m_outputNegativeSaturated;
+	};
+}
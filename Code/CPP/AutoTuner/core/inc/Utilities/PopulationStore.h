@@ -0,0 +1,207 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include <vector>
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Contiguous storage for all agents of a population.
+	 * Every value is stored parameter-major: parameter p of agent i is located at [p * agentCount + i].
+	 * The same parameter of neighbouring agents is therefore next to each other in memory,
+	 * which is the access pattern of a batched evaluation.
+	 *
+	 * Two generations are kept. The next generation gets written while the current one is read,
+	 * afterwards both are swapped. No memory gets allocated between epochs.
+	 */
+	class AUTO_TUNER_API PopulationStore
+	{
+	public:
+		/**
+		 * @brief
+		 * View on a contiguous block of agents of one generation.
+		 * A batch test function reads the parameters and writes the score parts of all agents in the block.
+		 * Agent indices passed to the accessors are local to the block [0, count).
+		 */
+		struct AgentBlock
+		{
+			const double* parameters = nullptr;
+			double* scoreParts = nullptr;
+			size_t stride = 0;	// Agent count of the whole generation
+			size_t begin = 0;	// Index of the first agent in the generation
+			size_t count = 0;
+			size_t parameterCount = 0;
+			size_t scorePartCount = 0;
+			size_t indexOffset = 0;	// Added by getAgentIndex(), for example the first agent of an island
+			unsigned char* raceLost = nullptr;	// One flag per agent of the block, nullptr if nobody reads them
+
+			double getParameter(size_t agent, size_t parameter) const
+			{
+				return parameters[parameter * stride + begin + agent];
+			}
+
+			/**
+			 * @brief
+			 * Gets the values of one parameter for all agents of the block.
+			 * @return pointer to <count> contiguous values
+			 */
+			const double* getParameterRow(size_t parameter) const
+			{
+				return parameters + parameter * stride + begin;
+			}
+			double* getScorePartRow(size_t scorePart) const
+			{
+				return scoreParts + scorePart * stride + begin;
+			}
+			void setScorePart(size_t agent, size_t scorePart, double value) const
+			{
+				scoreParts[scorePart * stride + begin + agent] = value;
+			}
+
+			/**
+			 * @brief
+			 * Gets the index of the agent inside the whole population
+			 */
+			size_t getAgentIndex(size_t agent) const
+			{
+				return indexOffset + begin + agent;
+			}
+
+			/**
+			 * @brief
+			 * Marks an agent that was stopped by Solver::isRaceLost().
+			 * Its score is only a bound and doesn't get cached.
+			 */
+			void setRaceLost(size_t agent) const
+			{
+				if (raceLost)
+					raceLost[agent] = 1;
+			}
+		};
+
+		class AUTO_TUNER_API Generation
+		{
+			friend PopulationStore;
+		public:
+			size_t getAgentCount() const { return m_agentCount; }
+			size_t getParameterCount() const { return m_parameterCount; }
+			size_t getScorePartCount() const { return m_scorePartCount; }
+
+			double getParameter(size_t agent, size_t parameter) const { return m_parameters[parameter * m_agentCount + agent]; }
+			void setParameter(size_t agent, size_t parameter, double value) { m_parameters[parameter * m_agentCount + agent] = value; }
+			double* getParameterRow(size_t parameter) { return m_parameters.data() + parameter * m_agentCount; }
+			const double* getParameterRow(size_t parameter) const { return m_parameters.data() + parameter * m_agentCount; }
+
+			double getMutationFactor(size_t agent, size_t parameter) const { return m_mutationFactors[parameter * m_agentCount + agent]; }
+			void setMutationFactor(size_t agent, size_t parameter, double value) { m_mutationFactors[parameter * m_agentCount + agent] = value; }
+			double* getMutationFactorRow(size_t parameter) { return m_mutationFactors.data() + parameter * m_agentCount; }
+			const double* getMutationFactorRow(size_t parameter) const { return m_mutationFactors.data() + parameter * m_agentCount; }
+
+			double getScorePart(size_t agent, size_t scorePart) const { return m_scoreParts[scorePart * m_agentCount + agent]; }
+			void setScorePart(size_t agent, size_t scorePart, double value) { m_scoreParts[scorePart * m_agentCount + agent] = value; }
+			double* getScorePartRow(size_t scorePart) { return m_scoreParts.data() + scorePart * m_agentCount; }
+			const double* getScorePartRow(size_t scorePart) const { return m_scoreParts.data() + scorePart * m_agentCount; }
+
+			double getScore(size_t agent) const { return m_scores[agent]; }
+			void setScore(size_t agent, double score) { m_scores[agent] = score; }
+			double* getScores() { return m_scores.data(); }
+			const double* getScores() const { return m_scores.data(); }
+
+			/**
+			 * @brief
+			 * Copies the parameters of one agent into a continuous vector
+			 * @param agent index of the agent
+			 * @param parameters output, gets resized to the parameter count
+			 */
+			void getParameters(size_t agent, std::vector<double>& parameters) const;
+			std::vector<double> getParameters(size_t agent) const
+			{
+				std::vector<double> parameters;
+				getParameters(agent, parameters);
+				return parameters;
+			}
+			void setParameters(size_t agent, const std::vector<double>& parameters);
+
+			void getMutationFactors(size_t agent, std::vector<double>& factors) const;
+			void getScoreParts(size_t agent, std::vector<double>& scoreParts) const;
+
+			/**
+			 * @brief
+			 * Stores the score parts of one agent and sets its score to the sum of all given parts.
+			 * Parts exceeding the score part count of the store are only added to the score.
+			 */
+			void setScoreParts(size_t agent, const std::vector<double>& scoreParts);
+
+			/**
+			 * @brief
+			 * Sets the score of each agent in the range to the sum of its score parts
+			 */
+			void sumScoreParts(size_t begin, size_t end);
+
+			/**
+			 * @brief
+			 * Copies all values of one agent of the source generation.
+			 * Both generations must have the same dimensions.
+			 */
+			void copyAgent(const Generation& source, size_t sourceAgent, size_t targetAgent);
+
+			/**
+			 * @brief
+			 * Copies all values of the agents from the source generation in the given order.
+			 * Agent i of this generation becomes agent order[i] of the source.
+			 */
+			void gather(const Generation& source, const std::vector<size_t>& order);
+
+			AgentBlock getBlock(size_t begin, size_t count);
+
+		private:
+			void resize(size_t agentCount, size_t parameterCount, size_t scorePartCount);
+
+			size_t m_agentCount = 0;
+			size_t m_parameterCount = 0;
+			size_t m_scorePartCount = 0;
+
+			std::vector<double> m_parameters;
+			std::vector<double> m_mutationFactors;
+			std::vector<double> m_scoreParts;
+			std::vector<double> m_scores;
+		};
+
+		PopulationStore();
+		PopulationStore(size_t agentCount, size_t parameterCount, size_t scorePartCount = 0);
+
+		/**
+		 * @brief
+		 * Resizes both generations. All values are reset to zero.
+		 */
+		void resize(size_t agentCount, size_t parameterCount, size_t scorePartCount = 0);
+
+		/**
+		 * @brief
+		 * Changes the number of score parts per agent, parameters and mutation factors are kept.
+		 */
+		void setScorePartCount(size_t scorePartCount);
+
+		size_t getAgentCount() const { return m_generations[0].m_agentCount; }
+		size_t getParameterCount() const { return m_generations[0].m_parameterCount; }
+		size_t getScorePartCount() const { return m_generations[0].m_scorePartCount; }
+		bool empty() const { return getAgentCount() == 0; }
+
+		Generation& getCurrent() { return m_generations[m_currentIndex]; }
+		const Generation& getCurrent() const { return m_generations[m_currentIndex]; }
+		Generation& getNext() { return m_generations[1 - m_currentIndex]; }
+		const Generation& getNext() const { return m_generations[1 - m_currentIndex]; }
+
+		/**
+		 * @brief
+		 * Makes the next generation the current one.
+		 * Only the roles of the buffers get exchanged, no data is copied.
+		 */
+		void swapGenerations() { m_currentIndex = 1 - m_currentIndex; }
+
+	private:
+		Generation m_generations[2];
+		size_t m_currentIndex = 0;
+	};
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include <vector>
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Radial basis function model of the score, trained on the tested agents.
+	 * Predicts s(x) = mean + sum_i w_i * exp(-0.5 * |(x - x_i) / l|^2), which is the mean of a Gaussian process.
+	 * The length scale l is given relative to the spread of the training points per parameter.
+	 *
+	 * The kernel matrix is kept as a Cholesky factor that grows by one row per added point,
+	 * so training costs O(n^2) per point instead of a refit in O(n^3).
+	 * When the model is full, it is rebuilt from its newest half.
+	 */
+	class AUTO_TUNER_API RBFSurrogate
+	{
+	public:
+		/**
+		 * @param capacity maximal number of training points
+		 */
+		RBFSurrogate(size_t capacity = 256);
+
+		void setCapacity(size_t capacity);
+		size_t getCapacity() const { return m_capacity; }
+
+		/**
+		 * @brief
+		 * Sets the length scale of the kernel in units of the standard deviation of the training points.
+		 * Takes effect with the next rebuild.
+		 */
+		void setLengthScale(double lengthScale) { m_lengthScale = lengthScale; }
+		double getLengthScale() const { return m_lengthScale; }
+
+		/**
+		 * @brief
+		 * Sets the noise added to the kernel diagonal, smooths noisy scores and keeps the factor stable
+		 */
+		void setRegularization(double regularization) { m_regularization = regularization; }
+		double getRegularization() const { return m_regularization; }
+
+		void clear();
+
+		/**
+		 * @brief
+		 * Adds a tested point. Points with a non finite score
+		 * and points too close to a known point are ignored.
+		 */
+		void add(const std::vector<double>& parameters, double score);
+
+		/**
+		 * @brief
+		 * Solves the weights for the added points in O(n^2).
+		 * Has to be called after adding points, before predict() is used.
+		 */
+		void fit();
+
+		/**
+		 * @return true if the model has enough points to predict
+		 */
+		bool isReady() const { return m_fitted && m_pointCount >= m_parameterCount + 2; }
+
+		/**
+		 * @brief
+		 * Predicts the score, thread safe once fit() was called
+		 * @param parameters first parameter, the following ones are stride elements apart
+		 */
+		double predict(const double* parameters, size_t stride = 1) const;
+		double predict(const std::vector<double>& parameters) const { return predict(parameters.data()); }
+
+		size_t getPointCount() const { return m_pointCount; }
+		size_t getRebuildCount() const { return m_rebuildCount; }
+
+	private:
+		double kernel(const double* a, const double* b, size_t bStride) const;
+
+		/**
+		 * @brief
+		 * Extends the factor by the last stored point
+		 * @return false if the point is numerically a duplicate
+		 */
+		bool extendFactor();
+
+		/**
+		 * @brief
+		 * Recomputes the scaling and the factor of the stored points
+		 */
+		void rebuild();
+
+		size_t m_capacity = 0;
+		double m_lengthScale = 1.0;
+		double m_regularization = 1e-6;
+
+		size_t m_parameterCount = 0;
+		size_t m_pointCount = 0;
+		std::vector<double> m_points;			// One row per point
+		std::vector<double> m_scores;
+		std::vector<double> m_inverseLengths;	// Per parameter, 1 / (l * spread)
+		double m_mean = 0;
+
+		std::vector<double> m_factor;			// Lower triangle of L, row stride m_capacity
+		std::vector<double> m_weights;
+		bool m_scaled = false;
+		bool m_fitted = false;
+		size_t m_rebuildCount = 0;
+	};
+}
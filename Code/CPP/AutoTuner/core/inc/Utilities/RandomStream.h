@@ -0,0 +1,172 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include <cstdint>
+#include <cmath>
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Counter based random number generator (Philox4x32-10).
+	 * A value is a pure function of (seed, stream ids, position), there is no hidden shared state.
+	 * Independent streams are created by using different stream ids,
+	 * for example one stream per epoch and agent pair.
+	 * So a run is reproducible from its seed, no matter on which thread or in which order the streams get used.
+	 *
+	 * Each Philox block gives 4 32-bit words. The blocks don't depend on each other,
+	 * so fillUniform() computes them in a loop the compiler can vectorise.
+	 */
+	class AUTO_TUNER_API RandomStream
+	{
+	public:
+		RandomStream(uint64_t seed = s_defaultSeed, uint32_t streamA = 0, uint32_t streamB = 0)
+		{
+			setSeed(seed, streamA, streamB);
+		}
+
+		/**
+		 * @brief
+		 * Restarts the stream at position 0
+		 */
+		void setSeed(uint64_t seed, uint32_t streamA = 0, uint32_t streamB = 0)
+		{
+			m_seed = seed;
+			m_key[0] = static_cast<uint32_t>(seed);
+			m_key[1] = static_cast<uint32_t>(seed >> 32);
+			m_streamA = streamA;
+			m_streamB = streamB;
+			m_block = 0;
+			m_bufferIndex = 4;
+		}
+		uint64_t getSeed() const { return m_seed; }
+
+		uint32_t nextUInt32()
+		{
+			if (m_bufferIndex >= 4)
+			{
+				getBlock(m_block++, m_buffer);
+				m_bufferIndex = 0;
+			}
+			return m_buffer[m_bufferIndex++];
+		}
+		uint64_t nextUInt64()
+		{
+			uint64_t hi = nextUInt32();
+			return (hi << 32) | nextUInt32();
+		}
+
+		/**
+		 * @return uniform value in [0, 1) with 53 bit resolution
+		 */
+		double nextDouble()
+		{
+			return static_cast<double>(nextUInt64() >> 11) * s_toUnitDouble;
+		}
+
+		/**
+		 * @return uniform value in [min, max)
+		 */
+		double getDouble(double min, double max)
+		{
+			return min + nextDouble() * (max - min);
+		}
+
+		/**
+		 * @brief
+		 * Normal distributed value with mean (min + max) / 2 and standard deviation (max - min) / 6,
+		 * clamped to [min, max]
+		 */
+		double getGaussDouble(double min, double max);
+
+		/**
+		 * @return uniform value in [min, max], inclusive
+		 */
+		size_t getSizeT(size_t min, size_t max)
+		{
+			uint64_t range = static_cast<uint64_t>(max - min) + 1;
+			if (range == 0)
+				return static_cast<size_t>(nextUInt64());
+			return min + static_cast<size_t>(nextUInt64() % range);
+		}
+
+		/**
+		 * @brief
+		 * Fills the array with uniform values in [min, max).
+		 * Uses the next blocks of the stream, like count calls of getDouble() would do.
+		 */
+		void fillUniform(double* values, size_t count, double min, double max);
+
+		/**
+		 * @brief
+		 * Fills the array with standard normal distributed values (mean 0, standard deviation 1, not clamped)
+		 */
+		void fillGaussian(double* values, size_t count);
+
+		/**
+		 * @brief
+		 * Computes one block of 4 words of the stream
+		 * @param block position of the block in the stream
+		 */
+		void getBlock(uint64_t block, uint32_t out[4]) const
+		{
+			philox(static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32), m_streamA, m_streamB,
+				m_key[0], m_key[1], out);
+		}
+
+		/**
+		 * @brief
+		 * Stream of the calling thread, used by the static random helpers of the solvers.
+		 * Each thread gets its own stream id in the order in which the threads first use it.
+		 */
+		static RandomStream& getThreadStream();
+
+		/**
+		 * @brief
+		 * Sets the seed of all thread streams.
+		 * Threads pick up the new seed on their next call of getThreadStream().
+		 */
+		static void setThreadStreamSeed(uint64_t seed);
+
+		static constexpr uint64_t s_defaultSeed = 5489;
+
+	private:
+		static inline void philox(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3,
+								  uint32_t k0, uint32_t k1, uint32_t out[4])
+		{
+			for (int round = 0; round < 10; ++round)
+			{
+				uint64_t product0 = static_cast<uint64_t>(s_multiplier0) * c0;
+				uint64_t product1 = static_cast<uint64_t>(s_multiplier1) * c2;
+				uint32_t hi0 = static_cast<uint32_t>(product0 >> 32);
+				uint32_t lo0 = static_cast<uint32_t>(product0);
+				uint32_t hi1 = static_cast<uint32_t>(product1 >> 32);
+				uint32_t lo1 = static_cast<uint32_t>(product1);
+				c0 = hi1 ^ c1 ^ k0;
+				c1 = lo1;
+				c2 = hi0 ^ c3 ^ k1;
+				c3 = lo0;
+				k0 += s_weyl0;
+				k1 += s_weyl1;
+			}
+			out[0] = c0;
+			out[1] = c1;
+			out[2] = c2;
+			out[3] = c3;
+		}
+
+		static constexpr uint32_t s_multiplier0 = 0xD2511F53;
+		static constexpr uint32_t s_multiplier1 = 0xCD9E8D57;
+		static constexpr uint32_t s_weyl0 = 0x9E3779B9;
+		static constexpr uint32_t s_weyl1 = 0xBB67AE85;
+		static constexpr double s_toUnitDouble = 1.0 / 9007199254740992.0; // 2^-53
+
+		uint64_t m_seed = 0;
+		uint32_t m_key[2] = { 0, 0 };
+		uint32_t m_streamA = 0;
+		uint32_t m_streamB = 0;
+		uint64_t m_block = 0;
+		uint32_t m_buffer[4] = { 0, 0, 0, 0 };
+		size_t m_bufferIndex = 4;
+	};
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include "Utilities/RandomStream.h"
+#include <vector>
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Fitness based selection of agents, built once per generation.
+	 * After build() the table is read only, so any number of threads can draw from it at the same time,
+	 * each one with its own RandomStream.
+	 * The scores have to be >= 0, higher is better.
+	 */
+	class AUTO_TUNER_API SelectionTable
+	{
+	public:
+		enum class Method
+		{
+			PrefixSum,			// Fitness proportional, binary search in the cumulative scores, O(log n) per draw
+			Alias,				// Fitness proportional, Walker's alias method, O(1) per draw
+			Tournament,			// Best of getTournamentSize() uniformly drawn agents, O(k) per draw
+			StochasticUniversal	// Fitness proportional with evenly spaced pointers, all draws are sampled in build()
+		};
+
+		static std::string methodToString(Method method);
+
+		void setMethod(Method method) { m_method = method; }
+		Method getMethod() const { return m_method; }
+		void setTournamentSize(size_t size) { m_tournamentSize = std::max<size_t>(1, size); }
+		size_t getTournamentSize() const { return m_tournamentSize; }
+
+		/**
+		 * @brief
+		 * Builds the table for the given scores
+		 * @param drawCount number of draws StochasticUniversal samples in advance
+		 * @param random stream for the sampling and shuffling of StochasticUniversal
+		 */
+		void build(const double* scores, size_t count, size_t drawCount, RandomStream& random);
+
+		/**
+		 * @brief
+		 * Draws one agent.
+		 * @param drawIndex index of the draw in [0, drawCount), only used by StochasticUniversal
+		 * @param attempt StochasticUniversal returns the sampled agent for attempt 0 and
+		 *                falls back to a fitness proportional draw for retries
+		 * @return index of the agent
+		 */
+		size_t draw(size_t drawIndex, RandomStream& random, size_t attempt = 0) const;
+
+		size_t getAgentCount() const { return m_scores.size(); }
+
+	private:
+		size_t drawPrefixSum(RandomStream& random) const;
+		size_t drawAlias(RandomStream& random) const;
+		size_t drawTournament(RandomStream& random) const;
+
+		void buildPrefixSum(const double* scores, size_t count);
+		void buildAlias(size_t count);
+		void sampleUniversal(size_t drawCount, RandomStream& random);
+
+		Method m_method = Method::PrefixSum;
+		size_t m_tournamentSize = 2;
+
+		std::vector<double> m_scores;
+		std::vector<double> m_prefixSum;
+		std::vector<double> m_aliasPropability;
+		std::vector<size_t> m_alias;
+		std::vector<size_t> m_sampled;
+	};
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include <algorithm>
+#include <cmath>
+
+// Select the widest vector instruction set the target is compiled for
+#if defined(__AVX2__) || defined(__AVX__)
+	#include <immintrin.h>
+	#define AT_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define AT_SIMD_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	#include <arm_neon.h>
+	#define AT_SIMD_NEON
+#endif
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Thin wrapper around a native vector of doubles.
+	 * AVX: 4 lanes, SSE2 and NEON: 2 lanes, otherwise a single scalar lane.
+	 *
+	 * All arithmetic operations are plain IEEE operations with the same rounding as their
+	 * scalar counterparts. A computation written with the same operation order therefore
+	 * gives bitwise identical results, as long as the compiler does not contract
+	 * multiplications and additions into FMA instructions.
+	 * Masks are vectors with all bits set in the lanes where a comparison is true.
+	 */
+	struct SimdDouble
+	{
+#if defined(AT_SIMD_AVX)
+		typedef __m256d Native;
+		static constexpr size_t s_laneCount = 4;
+#elif defined(AT_SIMD_SSE2)
+		typedef __m128d Native;
+		static constexpr size_t s_laneCount = 2;
+#elif defined(AT_SIMD_NEON)
+		typedef float64x2_t Native;
+		static constexpr size_t s_laneCount = 2;
+#else
+		typedef double Native;
+		static constexpr size_t s_laneCount = 1;
+#endif
+		Native value;
+
+		SimdDouble() = default;
+		SimdDouble(Native v) : value(v) {}
+
+		/**
+		 * @brief
+		 * Rounds a count up to the next multiple of the lane count
+		 */
+		static constexpr size_t getPaddedCount(size_t count)
+		{
+			return (count + s_laneCount - 1) / s_laneCount * s_laneCount;
+		}
+
+#if defined(AT_SIMD_AVX)
+		static SimdDouble broadcast(double v) { return _mm256_set1_pd(v); }
+		static SimdDouble load(const double* ptr) { return _mm256_loadu_pd(ptr); }
+		void store(double* ptr) const { _mm256_storeu_pd(ptr, value); }
+
+		friend SimdDouble operator+(SimdDouble a, SimdDouble b) { return _mm256_add_pd(a.value, b.value); }
+		friend SimdDouble operator-(SimdDouble a, SimdDouble b) { return _mm256_sub_pd(a.value, b.value); }
+		friend SimdDouble operator*(SimdDouble a, SimdDouble b) { return _mm256_mul_pd(a.value, b.value); }
+		friend SimdDouble operator/(SimdDouble a, SimdDouble b) { return _mm256_div_pd(a.value, b.value); }
+		friend SimdDouble operator-(SimdDouble a) { return _mm256_xor_pd(a.value, _mm256_set1_pd(-0.0)); }
+
+		static SimdDouble lessThan(SimdDouble a, SimdDouble b) { return _mm256_cmp_pd(a.value, b.value, _CMP_LT_OQ); }
+		static SimdDouble greaterThan(SimdDouble a, SimdDouble b) { return _mm256_cmp_pd(a.value, b.value, _CMP_GT_OQ); }
+		static SimdDouble maskAnd(SimdDouble a, SimdDouble b) { return _mm256_and_pd(a.value, b.value); }
+		static SimdDouble maskOr(SimdDouble a, SimdDouble b) { return _mm256_or_pd(a.value, b.value); }
+		static SimdDouble maskAndNot(SimdDouble mask, SimdDouble b) { return _mm256_andnot_pd(mask.value, b.value); }
+		static SimdDouble select(SimdDouble mask, SimdDouble ifTrue, SimdDouble ifFalse) { return _mm256_blendv_pd(ifFalse.value, ifTrue.value, mask.value); }
+		static SimdDouble min(SimdDouble a, SimdDouble b) { return _mm256_min_pd(a.value, b.value); }
+		static SimdDouble max(SimdDouble a, SimdDouble b) { return _mm256_max_pd(a.value, b.value); }
+		static SimdDouble abs(SimdDouble a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.value); }
+#elif defined(AT_SIMD_SSE2)
+		static SimdDouble broadcast(double v) { return _mm_set1_pd(v); }
+		static SimdDouble load(const double* ptr) { return _mm_loadu_pd(ptr); }
+		void store(double* ptr) const { _mm_storeu_pd(ptr, value); }
+
+		friend SimdDouble operator+(SimdDouble a, SimdDouble b) { return _mm_add_pd(a.value, b.value); }
+		friend SimdDouble operator-(SimdDouble a, SimdDouble b) { return _mm_sub_pd(a.value, b.value); }
+		friend SimdDouble operator*(SimdDouble a, SimdDouble b) { return _mm_mul_pd(a.value, b.value); }
+		friend SimdDouble operator/(SimdDouble a, SimdDouble b) { return _mm_div_pd(a.value, b.value); }
+		friend SimdDouble operator-(SimdDouble a) { return _mm_xor_pd(a.value, _mm_set1_pd(-0.0)); }
+
+		static SimdDouble lessThan(SimdDouble a, SimdDouble b) { return _mm_cmplt_pd(a.value, b.value); }
+		static SimdDouble greaterThan(SimdDouble a, SimdDouble b) { return _mm_cmpgt_pd(a.value, b.value); }
+		static SimdDouble maskAnd(SimdDouble a, SimdDouble b) { return _mm_and_pd(a.value, b.value); }
+		static SimdDouble maskOr(SimdDouble a, SimdDouble b) { return _mm_or_pd(a.value, b.value); }
+		static SimdDouble maskAndNot(SimdDouble mask, SimdDouble b) { return _mm_andnot_pd(mask.value, b.value); }
+		static SimdDouble select(SimdDouble mask, SimdDouble ifTrue, SimdDouble ifFalse)
+		{
+			return _mm_or_pd(_mm_and_pd(mask.value, ifTrue.value), _mm_andnot_pd(mask.value, ifFalse.value));
+		}
+		static SimdDouble min(SimdDouble a, SimdDouble b) { return _mm_min_pd(a.value, b.value); }
+		static SimdDouble max(SimdDouble a, SimdDouble b) { return _mm_max_pd(a.value, b.value); }
+		static SimdDouble abs(SimdDouble a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a.value); }
+#elif defined(AT_SIMD_NEON)
+		static SimdDouble broadcast(double v) { return vdupq_n_f64(v); }
+		static SimdDouble load(const double* ptr) { return vld1q_f64(ptr); }
+		void store(double* ptr) const { vst1q_f64(ptr, value); }
+
+		friend SimdDouble operator+(SimdDouble a, SimdDouble b) { return vaddq_f64(a.value, b.value); }
+		friend SimdDouble operator-(SimdDouble a, SimdDouble b) { return vsubq_f64(a.value, b.value); }
+		friend SimdDouble operator*(SimdDouble a, SimdDouble b) { return vmulq_f64(a.value, b.value); }
+		friend SimdDouble operator/(SimdDouble a, SimdDouble b) { return vdivq_f64(a.value, b.value); }
+		friend SimdDouble operator-(SimdDouble a) { return vnegq_f64(a.value); }
+
+		static SimdDouble lessThan(SimdDouble a, SimdDouble b) { return vreinterpretq_f64_u64(vcltq_f64(a.value, b.value)); }
+		static SimdDouble greaterThan(SimdDouble a, SimdDouble b) { return vreinterpretq_f64_u64(vcgtq_f64(a.value, b.value)); }
+		static SimdDouble maskAnd(SimdDouble a, SimdDouble b)
+		{
+			return vreinterpretq_f64_u64(vandq_u64(vreinterpretq_u64_f64(a.value), vreinterpretq_u64_f64(b.value)));
+		}
+		static SimdDouble maskOr(SimdDouble a, SimdDouble b)
+		{
+			return vreinterpretq_f64_u64(vorrq_u64(vreinterpretq_u64_f64(a.value), vreinterpretq_u64_f64(b.value)));
+		}
+		static SimdDouble maskAndNot(SimdDouble mask, SimdDouble b)
+		{
+			return vreinterpretq_f64_u64(vbicq_u64(vreinterpretq_u64_f64(b.value), vreinterpretq_u64_f64(mask.value)));
+		}
+		static SimdDouble select(SimdDouble mask, SimdDouble ifTrue, SimdDouble ifFalse)
+		{
+			return vbslq_f64(vreinterpretq_u64_f64(mask.value), ifTrue.value, ifFalse.value);
+		}
+		static SimdDouble min(SimdDouble a, SimdDouble b) { return vminq_f64(a.value, b.value); }
+		static SimdDouble max(SimdDouble a, SimdDouble b) { return vmaxq_f64(a.value, b.value); }
+		static SimdDouble abs(SimdDouble a) { return vabsq_f64(a.value); }
+#else
+		static SimdDouble broadcast(double v) { return v; }
+		static SimdDouble load(const double* ptr) { return *ptr; }
+		void store(double* ptr) const { *ptr = value; }
+
+		friend SimdDouble operator+(SimdDouble a, SimdDouble b) { return a.value + b.value; }
+		friend SimdDouble operator-(SimdDouble a, SimdDouble b) { return a.value - b.value; }
+		friend SimdDouble operator*(SimdDouble a, SimdDouble b) { return a.value * b.value; }
+		friend SimdDouble operator/(SimdDouble a, SimdDouble b) { return a.value / b.value; }
+		friend SimdDouble operator-(SimdDouble a) { return -a.value; }
+
+		// The scalar fallback uses 1.0 and 0.0 as mask values
+		static SimdDouble lessThan(SimdDouble a, SimdDouble b) { return a.value < b.value ? 1.0 : 0.0; }
+		static SimdDouble greaterThan(SimdDouble a, SimdDouble b) { return a.value > b.value ? 1.0 : 0.0; }
+		static SimdDouble maskAnd(SimdDouble a, SimdDouble b) { return (a.value != 0.0 && b.value != 0.0) ? b.value : 0.0; }
+		static SimdDouble maskOr(SimdDouble a, SimdDouble b) { return (a.value != 0.0 || b.value != 0.0) ? 1.0 : 0.0; }
+		static SimdDouble maskAndNot(SimdDouble mask, SimdDouble b) { return mask.value != 0.0 ? 0.0 : b.value; }
+		static SimdDouble select(SimdDouble mask, SimdDouble ifTrue, SimdDouble ifFalse) { return mask.value != 0.0 ? ifTrue : ifFalse; }
+		static SimdDouble min(SimdDouble a, SimdDouble b) { return std::min(a.value, b.value); }
+		static SimdDouble max(SimdDouble a, SimdDouble b) { return std::max(a.value, b.value); }
+		static SimdDouble abs(SimdDouble a) { return std::abs(a.value); }
+#endif
+
+		SimdDouble& operator+=(SimdDouble other) { *this = *this + other; return *this; }
+		SimdDouble& operator-=(SimdDouble other) { *this = *this - other; return *this; }
+		SimdDouble& operator*=(SimdDouble other) { *this = *this * other; return *this; }
+
+		/**
+		 * @brief
+		 * Converts a mask into 1.0 for true lanes and 0.0 for false lanes
+		 */
+		static SimdDouble maskToOne(SimdDouble mask)
+		{
+			return maskAnd(mask, broadcast(1.0));
+		}
+	};
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include <vector>
+#include <atomic>
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Bounded lock-free queue for exactly one producer thread and one consumer thread.
+	 * push() is only called by the producer, front(), pop() and tryPop() only by the consumer.
+	 * Neither side ever waits for the other one, a full queue rejects the value.
+	 */
+	template<typename T>
+	class SpscQueue
+	{
+	public:
+		/**
+		 * @param capacity maximal number of queued values
+		 */
+		explicit SpscQueue(size_t capacity = 64)
+		{
+			// One slot stays free to tell a full queue from an empty one
+			size_t slotCount = 2;
+			while (slotCount < capacity + 1)
+				slotCount *= 2;
+			m_slots.resize(slotCount);
+			m_mask = slotCount - 1;
+		}
+		SpscQueue(const SpscQueue&) = delete;
+		SpscQueue& operator=(const SpscQueue&) = delete;
+
+		size_t getCapacity() const { return m_mask; }
+
+		/**
+		 * @return false if the queue is full, the value is not queued then
+		 */
+		bool push(T value)
+		{
+			const size_t tail = m_tail.load(std::memory_order_relaxed);
+			const size_t next = (tail + 1) & m_mask;
+			if (next == m_head.load(std::memory_order_acquire))
+				return false;
+			m_slots[tail] = std::move(value);
+			m_tail.store(next, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * @return the oldest value, nullptr if the queue is empty. Stays valid until pop().
+		 */
+		T* front()
+		{
+			const size_t head = m_head.load(std::memory_order_relaxed);
+			if (head == m_tail.load(std::memory_order_acquire))
+				return nullptr;
+			return &m_slots[head];
+		}
+
+		/**
+		 * @brief
+		 * Removes the oldest value, the queue must not be empty
+		 */
+		void pop()
+		{
+			const size_t head = m_head.load(std::memory_order_relaxed);
+			m_head.store((head + 1) & m_mask, std::memory_order_release);
+		}
+
+		bool tryPop(T& value)
+		{
+			T* oldest = front();
+			if (!oldest)
+				return false;
+			value = std::move(*oldest);
+			pop();
+			return true;
+		}
+
+		bool empty() const
+		{
+			return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+		}
+
+	private:
+		std::vector<T> m_slots;
+		size_t m_mask = 0;
+
+		// On separate cache lines, so producer and consumer don't invalidate each other
+		alignas(64) std::atomic<size_t> m_head{ 0 };
+		alignas(64) std::atomic<size_t> m_tail{ 0 };
+	};
+}
@@ -2,6 +2,7 @@
 
 #include "AutoTuner_base.h"
 #include "Utilities/TimeBasedSystem.h"
+#include "Utilities/LinearAlgebra.h"
 
 namespace AutoTuner
 {
@@ -49,6 +50,40 @@ namespace AutoTuner
 
 		void setIntegrationSolver(IntegrationSolver solver) override;
 
+		/**
+		 * @brief
+		 * Selects how IntegrationSolver::Discretized gets its discrete model.
+		 * With C2DMethod::None, A and B are used as discrete matrices.
+		 * Otherwise A and B are treated as continuous and get discretized for the time step of update().
+		 * The discrete matrices are cached until the time step or the matrices change.
+		 */
+		void setC2DMethod(C2DMethod method) override
+		{
+			TimeBasedSystem::setC2DMethod(method);
+			invalidateDiscretization();
+		}
+
+		/**
+		 * @brief
+		 * Gets the discrete model used for the given time step.
+		 * @return false if no C2DMethod is selected or the discretization is singular
+		 */
+		bool getDiscretizedMatrices(double deltaTime, MatlabAPI::Matrix& Ad, MatlabAPI::Matrix& Bd);
+
+		/**
+		 * @brief
+		 * True if the last discretization failed, because (I - A*dt/2) of the Tustin method is singular.
+		 * The discrete matrices are zero in that case.
+		 */
+		bool isDiscretizationSingular() const { return m_isDiscretizationSingular; }
+
+		/**
+		 * @brief
+		 * Evaluates C * (j*omega*I - A)^-1 * B + D for one input/output pair.
+		 * A is reduced to Hessenberg form once, after that each frequency costs O(n^2).
+		 */
+		bool getFrequencyResponse(double omega, size_t inputIndex, size_t outputIndex, std::complex<double>& response) override;
+
 		void reset() override
 		{
 			setStates(0.0);
@@ -160,6 +195,8 @@ namespace AutoTuner
 		void setMatrixA(const MatlabAPI::Matrix& A) 
 		{ 
 			m_A = A; 
+			invalidateDiscretization();
+			m_isHessenbergValid = false;
 
 			//m_u = MatlabAPI::Matrix(B.getCols(), 1);
 			m_x = MatlabAPI::Matrix(A.getRows(), 1);
@@ -168,12 +205,18 @@ namespace AutoTuner
 		void setMatrixB(const MatlabAPI::Matrix& B) 
 		{ 
 			m_B = B; 
+			invalidateDiscretization();
+			m_isHessenbergValid = false;
 
 			m_u = MatlabAPI::Matrix(B.getCols(), 1);
 			//m_x = MatlabAPI::Matrix(A.getRows(), 1);
 			//m_lastXdot = MatlabAPI::Matrix(A.getRows(), 1);
 		}
-		void setMatrixC(const MatlabAPI::Matrix& C) { m_C = C; }
+		void setMatrixC(const MatlabAPI::Matrix& C) 
+		{ 
+			m_C = C; 
+			m_isHessenbergValid = false;
+		}
 		void setMatrixD(const MatlabAPI::Matrix& D) { m_D = D; }
 
 
@@ -220,6 +263,23 @@ namespace AutoTuner
 
 
 	private:
+		void invalidateDiscretization()
+		{
+			m_isDiscretizationValid = false;
+		}
+
+		/**
+		 * @brief
+		 * Computes the discrete matrices for the time step if the cached ones do not match
+		 */
+		void updateDiscretization(double deltaTime);
+
+		/**
+		 * @brief
+		 * Computes H = Q^T * A * Q, Q^T * B and C * Q if the matrices have changed
+		 */
+		void updateHessenbergForm();
+
 		MatlabAPI::Matrix m_A;
 		MatlabAPI::Matrix m_B;
 		MatlabAPI::Matrix m_C;
@@ -233,6 +293,20 @@ namespace AutoTuner
 		ProcessTimeStepFunc m_processTimeStepFunc;
 		double m_timeStep;
 
+		// Discrete model cache, row-major
+		std::vector<double> m_discretizedA;
+		std::vector<double> m_discretizedB;
+		std::vector<double> m_nextState;
+		double m_discretizedTimeStep = 0;
+		bool m_isDiscretizationValid = false;
+		bool m_isDiscretizationSingular = false;
+
+		// Hessenberg form cache for the frequency response, row-major
+		std::vector<double> m_hessenbergA;
+		std::vector<double> m_hessenbergB;
+		std::vector<double> m_hessenbergC;
+		bool m_isHessenbergValid = false;
+
 		
 	};
 }
\ No newline at end of file
@@ -0,0 +1,399 @@
+#pragma once
+
+#include "AutoTuner_base.h"
+#include "Utilities/TimeBasedSystem.h"
+#include "Utilities/StatespaceSystem.h"
+#include <array>
+#include <cmath>
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * State space system with dimensions known at compile time.
+	 * All matrices and vectors are stored in std::arrays inside the object,
+	 * a time step does not allocate any memory.
+	 * The matrices are stored row-major: element (row, col) of A is located at A[row * NStates + col].
+	 *
+	 * Supported integration solvers:
+	 * - ForwardEuler:  x += (A*x + B*u) * dt
+	 * - BackwardEuler: (I - dt*A) * x(k) = x(k-1) + dt*B*u, the factorization is cached for the last dt
+	 * - Bilinear:      x += (xDot + xDot(k-1)) * dt/2, the same as StatespaceSystem
+	 * - Rk4:           4th-order Runge-Kutta
+	 * - Discretized:   x = A*x + B*u, the matrices are already discrete
+	 * - Custom:        processTimeStepCustom() gets called
+	 *
+	 * @tparam NStates number of states
+	 * @tparam NIn number of inputs
+	 * @tparam NOut number of outputs
+	 */
+	template<size_t NStates, size_t NIn, size_t NOut>
+	class StaticStatespaceSystem : public TimeBasedSystem
+	{
+	public:
+		typedef std::array<double, NStates * NStates> MatrixA;
+		typedef std::array<double, NStates * NIn> MatrixB;
+		typedef std::array<double, NOut * NStates> MatrixC;
+		typedef std::array<double, NOut * NIn> MatrixD;
+		typedef std::array<double, NStates> StateVector;
+		typedef std::array<double, NIn> InputVector;
+		typedef std::array<double, NOut> OutputVector;
+
+		static constexpr size_t s_stateCount = NStates;
+		static constexpr size_t s_inputCount = NIn;
+		static constexpr size_t s_outputCount = NOut;
+
+		StaticStatespaceSystem()
+			: TimeBasedSystem()
+		{
+			m_A.fill(0.0);
+			m_B.fill(0.0);
+			m_C.fill(0.0);
+			m_D.fill(0.0);
+			reset();
+			setIntegrationSolver(getDefaultIntegrationSolver());
+			setDifferentiationSolver(getDefaultDifferentiationSolver());
+		}
+		StaticStatespaceSystem(const MatrixA& A, const MatrixB& B, const MatrixC& C, const MatrixD& D)
+			: StaticStatespaceSystem()
+		{
+			setStateSpaceMatrices(A, B, C, D);
+		}
+		StaticStatespaceSystem(const StaticStatespaceSystem& other) = default;
+		TimeBasedSystem* clone() override
+		{
+			return new StaticStatespaceSystem(*this);
+		}
+
+		void setStateSpaceMatrices(const MatrixA& A, const MatrixB& B, const MatrixC& C, const MatrixD& D)
+		{
+			m_A = A;
+			m_B = B;
+			m_C = C;
+			m_D = D;
+			m_isFactorized = false;
+			reset();
+		}
+
+		/**
+		 * @brief
+		 * Copies the matrices from dynamically sized matrices
+		 * @return false if the dimensions do not match the template parameters
+		 */
+		bool setStateSpaceMatrices(
+			const MatlabAPI::Matrix& A,
+			const MatlabAPI::Matrix& B,
+			const MatlabAPI::Matrix& C,
+			const MatlabAPI::Matrix& D)
+		{
+			if (A.getRows() != NStates || A.getCols() != NStates ||
+				B.getRows() != NStates || B.getCols() != NIn ||
+				C.getRows() != NOut || C.getCols() != NStates ||
+				D.getRows() != NOut || D.getCols() != NIn)
+			{
+				return false;
+			}
+			MatrixA a;
+			MatrixB b;
+			MatrixC c;
+			MatrixD d;
+			copyMatrix(A, a.data(), NStates, NStates);
+			copyMatrix(B, b.data(), NStates, NIn);
+			copyMatrix(C, c.data(), NOut, NStates);
+			copyMatrix(D, d.data(), NOut, NIn);
+			setStateSpaceMatrices(a, b, c, d);
+			return true;
+		}
+
+		/**
+		 * @brief
+		 * Takes over the matrices and the integration solver of a dynamically sized system
+		 * @return false if the dimensions do not match the template parameters
+		 */
+		bool setFrom(const StatespaceSystem& system)
+		{
+			if (!setStateSpaceMatrices(system.getMatrixA(), system.getMatrixB(), system.getMatrixC(), system.getMatrixD()))
+				return false;
+			setIntegrationSolver(system.getIntegrationSolver());
+			return true;
+		}
+
+		const MatrixA& getMatrixA() const { return m_A; }
+		const MatrixB& getMatrixB() const { return m_B; }
+		const MatrixC& getMatrixC() const { return m_C; }
+		const MatrixD& getMatrixD() const { return m_D; }
+
+		void reset() override
+		{
+			m_x.fill(0.0);
+			m_u.fill(0.0);
+			m_lastXdot.fill(0.0);
+		}
+
+		void setInputSignals(double u) override
+		{
+			m_u.fill(u);
+		}
+		void setInputSignal(size_t input, double value) override
+		{
+			if (input < NIn)
+				m_u[input] = value;
+		}
+		void setInputSignals(const std::vector<double>& u) override
+		{
+			size_t inputSize = std::min(u.size(), NIn);
+			for (size_t i = 0; i < inputSize; ++i)
+				m_u[i] = u[i];
+		}
+		void setInputSignals(const InputVector& u)
+		{
+			m_u = u;
+		}
+
+		/**
+		 * @brief
+		 * Advances the system by the given time delta.
+		 */
+		void update(double deltaTime) override
+		{
+			switch (getIntegrationSolver())
+			{
+				case IntegrationSolver::ForwardEuler:	processTimeStepForwardEuler(deltaTime);		break;
+				case IntegrationSolver::BackwardEuler:	processTimeStepBackwardEuler(deltaTime);	break;
+				case IntegrationSolver::Bilinear:		processTimeStepBilinear(deltaTime);			break;
+				case IntegrationSolver::Rk4:			processTimeStepRk4(deltaTime);				break;
+				case IntegrationSolver::Discretized:	processTimeStepDiscretized();				break;
+				case IntegrationSolver::Custom:			processTimeStepCustom(deltaTime);			break;
+			}
+		}
+
+		std::vector<double> getInputs() const override
+		{
+			return std::vector<double>(m_u.begin(), m_u.end());
+		}
+		std::vector<double> getOutputs() const override
+		{
+			OutputVector y = getOutputVector();
+			return std::vector<double>(y.begin(), y.end());
+		}
+		OutputVector getOutputVector() const
+		{
+			OutputVector y;
+			for (size_t i = 0; i < NOut; ++i)
+				y[i] = computeOutput(i);
+			return y;
+		}
+		double getOutput(size_t index) const override
+		{
+			if (index < NOut)
+				return computeOutput(index);
+			return 0.0;
+		}
+		double getInput(size_t index) const override
+		{
+			if (index < NIn)
+				return m_u[index];
+			return 0.0;
+		}
+
+		void setStates(double x)
+		{
+			m_x.fill(x);
+		}
+		void setStates(const StateVector& x)
+		{
+			m_x = x;
+		}
+		const StateVector& getStates() const
+		{
+			return m_x;
+		}
+
+	protected:
+		virtual void processTimeStepCustom(double deltaTime) {}
+
+		/**
+		 * @brief
+		 * Computes xDot = A*x + B*u
+		 */
+		void getDerivative(const StateVector& x, StateVector& xDot) const
+		{
+			for (size_t i = 0; i < NStates; ++i)
+			{
+				double sum = 0;
+				for (size_t j = 0; j < NStates; ++j)
+					sum += m_A[i * NStates + j] * x[j];
+				for (size_t j = 0; j < NIn; ++j)
+					sum += m_B[i * NIn + j] * m_u[j];
+				xDot[i] = sum;
+			}
+		}
+
+		void processTimeStepDiscretized()
+		{
+			StateVector x;
+			getDerivative(m_x, x);
+			m_x = x;
+		}
+		void processTimeStepForwardEuler(double deltaTime)
+		{
+			StateVector xDot;
+			getDerivative(m_x, xDot);
+			for (size_t i = 0; i < NStates; ++i)
+				m_x[i] += xDot[i] * deltaTime;
+		}
+		void processTimeStepBackwardEuler(double deltaTime)
+		{
+			if (!m_isFactorized || m_factorizedTimeStep != deltaTime)
+				factorize(deltaTime);
+
+			// Right hand side: x(k-1) + dt*B*u
+			StateVector rhs;
+			for (size_t i = 0; i < NStates; ++i)
+			{
+				double sum = 0;
+				for (size_t j = 0; j < NIn; ++j)
+					sum += m_B[i * NIn + j] * m_u[j];
+				rhs[m_pivot[i]] = m_x[i] + deltaTime * sum;
+			}
+			solveFactorized(rhs, m_x);
+		}
+		void processTimeStepBilinear(double deltaTime)
+		{
+			StateVector xDot;
+			getDerivative(m_x, xDot);
+			double halfTimeStep = deltaTime / 2.0;
+			for (size_t i = 0; i < NStates; ++i)
+				m_x[i] += (xDot[i] + m_lastXdot[i]) * halfTimeStep;
+			m_lastXdot = xDot;
+		}
+		void processTimeStepRk4(double deltaTime)
+		{
+			double timestep2 = deltaTime / 2.0;
+			StateVector k1, k2, k3, k4, tmp;
+
+			getDerivative(m_x, k1);
+			for (size_t i = 0; i < NStates; ++i)
+				tmp[i] = m_x[i] + k1[i] * timestep2;
+			getDerivative(tmp, k2);
+			for (size_t i = 0; i < NStates; ++i)
+				tmp[i] = m_x[i] + k2[i] * timestep2;
+			getDerivative(tmp, k3);
+			for (size_t i = 0; i < NStates; ++i)
+				tmp[i] = m_x[i] + k3[i] * deltaTime;
+			getDerivative(tmp, k4);
+
+			double timestep6 = deltaTime / 6.0;
+			for (size_t i = 0; i < NStates; ++i)
+				m_x[i] += (k1[i] + k2[i] * 2.0 + k3[i] * 2.0 + k4[i]) * timestep6;
+		}
+
+		StateVector m_x;
+		InputVector m_u;
+
+	private:
+		double computeOutput(size_t index) const
+		{
+			double sum = 0;
+			for (size_t j = 0; j < NStates; ++j)
+				sum += m_C[index * NStates + j] * m_x[j];
+			for (size_t j = 0; j < NIn; ++j)
+				sum += m_D[index * NIn + j] * m_u[j];
+			return sum;
+		}
+
+		/**
+		 * @brief
+		 * LU decomposition of (I - dt*A) with partial pivoting, stored in m_lu.
+		 * m_pivot[i] is the row of the permuted system that original row i ends up in.
+		 */
+		void factorize(double deltaTime)
+		{
+			for (size_t i = 0; i < NStates; ++i)
+				for (size_t j = 0; j < NStates; ++j)
+					m_lu[i * NStates + j] = (i == j ? 1.0 : 0.0) - deltaTime * m_A[i * NStates + j];
+
+			std::array<size_t, NStates> rowOfPosition;
+			for (size_t i = 0; i < NStates; ++i)
+				rowOfPosition[i] = i;
+
+			for (size_t k = 0; k < NStates; ++k)
+			{
+				size_t pivotRow = k;
+				double pivotValue = std::abs(m_lu[k * NStates + k]);
+				for (size_t i = k + 1; i < NStates; ++i)
+				{
+					double value = std::abs(m_lu[i * NStates + k]);
+					if (value > pivotValue)
+					{
+						pivotValue = value;
+						pivotRow = i;
+					}
+				}
+				if (pivotRow != k)
+				{
+					for (size_t j = 0; j < NStates; ++j)
+						std::swap(m_lu[k * NStates + j], m_lu[pivotRow * NStates + j]);
+					std::swap(rowOfPosition[k], rowOfPosition[pivotRow]);
+				}
+				double diagonal = m_lu[k * NStates + k];
+				if (diagonal == 0.0)
+					continue; // Singular, the solve produces inf/nan like a division by zero would
+				for (size_t i = k + 1; i < NStates; ++i)
+				{
+					double factor = m_lu[i * NStates + k] / diagonal;
+					m_lu[i * NStates + k] = factor;
+					for (size_t j = k + 1; j < NStates; ++j)
+						m_lu[i * NStates + j] -= factor * m_lu[k * NStates + j];
+				}
+			}
+			for (size_t i = 0; i < NStates; ++i)
+				m_pivot[rowOfPosition[i]] = i;
+			m_factorizedTimeStep = deltaTime;
+			m_isFactorized = true;
+		}
+
+		/**
+		 * @brief
+		 * Solves L*U*x = b, b must already be permuted
+		 */
+		void solveFactorized(const StateVector& b, StateVector& x) const
+		{
+			StateVector y;
+			for (size_t i = 0; i < NStates; ++i)
+			{
+				double sum = b[i];
+				for (size_t j = 0; j < i; ++j)
+					sum -= m_lu[i * NStates + j] * y[j];
+				y[i] = sum;
+			}
+			for (size_t i = NStates; i-- > 0;)
+			{
+				double sum = y[i];
+				for (size_t j = i + 1; j < NStates; ++j)
+					sum -= m_lu[i * NStates + j] * x[j];
+				x[i] = sum / m_lu[i * NStates + i];
+			}
+		}
+
+		static void copyMatrix(const MatlabAPI::Matrix& source, double* target, size_t rows, size_t cols)
+		{
+			for (size_t i = 0; i < rows; ++i)
+				for (size_t j = 0; j < cols; ++j)
+					target[i * cols + j] = source(i, j);
+		}
+
+		MatrixA m_A;
+		MatrixB m_B;
+		MatrixC m_C;
+		MatrixD m_D;
+
+		StateVector m_lastXdot;
+
+		// Backward Euler factorization of (I - dt*A)
+		MatrixA m_lu;
+		std::array<size_t, NStates> m_pivot;
+		double m_factorizedTimeStep = 0;
+		bool m_isFactorized = false;
+	};
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <algorithm>
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Work-stealing thread pool.
+	 * A job is split into many small tasks. Each worker owns a task queue, works on its own
+	 * tasks first and steals from the other workers once its queue is empty.
+	 * Slow tasks therefore do not stall the remaining workers like fixed chunks would.
+	 *
+	 * The workers are started once and live as long as the scheduler.
+	 * A worker that waits for a nested job keeps executing tasks in the meantime.
+	 *
+	 * Several solvers can share one scheduler. Each job belongs to a Group, for example one solver.
+	 * A free worker serves the waiting jobs of the highest priority first and rotates between jobs of equal priority,
+	 * so concurrent solvers share the cores fairly instead of oversubscribing the machine with their own threads.
+	 */
+	class AUTO_TUNER_API TaskScheduler
+	{
+	public:
+		/**
+		 * @brief
+		 * Function executed by a task
+		 * @param begin first index of the range
+		 * @param end index after the last element of the range
+		 * @param workerIndex index of the executing worker, in range [0, getWorkerCount())
+		 */
+		typedef std::function<void(size_t begin, size_t end, size_t workerIndex)> RangeFunc;
+
+		/**
+		 * @brief
+		 * Priority and concurrency limit shared by all jobs of one client, for example one solver.
+		 * The settings may be changed while jobs of the group are running, they apply to the next task a worker takes.
+		 */
+		class AUTO_TUNER_API Group
+		{
+		public:
+			/**
+			 * @param priority jobs of a higher priority get served first
+			 * @param maxConcurrency maximal number of workers executing tasks of the group at the same time, 0 is unlimited
+			 */
+			Group(int priority = 0, size_t maxConcurrency = 0)
+				: m_priority(priority)
+				, m_maxConcurrency(maxConcurrency)
+			{}
+			Group(const Group&) = delete;
+			Group& operator=(const Group&) = delete;
+
+			void setPriority(int priority) { m_priority.store(priority, std::memory_order_relaxed); }
+			int getPriority() const { return m_priority.load(std::memory_order_relaxed); }
+
+			void setMaxConcurrency(size_t maxConcurrency) { m_maxConcurrency.store(maxConcurrency, std::memory_order_relaxed); }
+			size_t getMaxConcurrency() const { return m_maxConcurrency.load(std::memory_order_relaxed); }
+
+			/**
+			 * @return number of workers executing tasks of the group right now
+			 */
+			size_t getActiveWorkerCount() const { return m_activeWorkers.load(std::memory_order_relaxed); }
+
+		private:
+			friend TaskScheduler;
+			bool tryAcquire();
+			void release() { m_activeWorkers.fetch_sub(1, std::memory_order_release); }
+
+			std::atomic<int> m_priority;
+			std::atomic<size_t> m_maxConcurrency;
+			std::atomic<size_t> m_activeWorkers{ 0 };
+		};
+
+		struct WorkerStatistics
+		{
+			size_t executedTasks = 0;
+			size_t stolenTasks = 0;
+			double busyTime = 0;	// Seconds spent executing tasks
+			double utilisation = 0;	// busyTime / time since the last statistics reset
+		};
+
+		/**
+		 * @param workerCount number of worker threads. 0 uses std::thread::hardware_concurrency()
+		 */
+		TaskScheduler(size_t workerCount = 0);
+		TaskScheduler(const TaskScheduler&) = delete;
+		TaskScheduler& operator=(const TaskScheduler&) = delete;
+		~TaskScheduler();
+
+		/**
+		 * @brief
+		 * Gets the scheduler shared by all solvers that do not have their own scheduler assigned.
+		 */
+		static TaskScheduler& getDefault();
+
+		size_t getWorkerCount() const { return m_workers.size(); }
+
+		/**
+		 * @brief
+		 * Gets the number of workers that may execute tasks of the group at the same time
+		 * @param group nullptr is the default group, which has no limit
+		 */
+		size_t getConcurrency(const Group* group = nullptr) const;
+
+		/**
+		 * @brief
+		 * Splits the range [0, count) into tasks of <grainSize> elements and executes them on the workers.
+		 * Blocks until all tasks are done. Exceptions thrown by a task are rethrown here.
+		 * @param grainSize elements per task. 0 chooses a size that creates several tasks per worker
+		 * @param group priority and concurrency limit of the job.
+		 *              nullptr uses the group of the task the calling thread executes, or the default group of the scheduler
+		 */
+		void parallelFor(size_t count, size_t grainSize, const RangeFunc& func, Group* group = nullptr);
+
+		/**
+		 * @brief
+		 * Gets the index of the worker that runs the calling thread.
+		 * @return the worker index or getWorkerCount() if the calling thread is not a worker of this scheduler
+		 */
+		size_t getCurrentWorkerIndex() const;
+
+		std::vector<WorkerStatistics> getWorkerStatistics() const;
+		void resetStatistics();
+
+	private:
+		struct Job
+		{
+			const RangeFunc* func = nullptr;
+			Group* group = nullptr;
+			std::atomic<size_t> remainingTasks{ 0 };
+
+			// Range not yet handed out, for jobs submitted from outside of the pool. Guarded by m_injectMutex
+			size_t nextBegin = 0;
+			size_t count = 0;
+			size_t grainSize = 0;
+
+			std::mutex mutex;
+			std::condition_variable finished;
+			bool isFinished = false;
+			std::exception_ptr exception;
+		};
+		struct Task
+		{
+			Job* job = nullptr;
+			size_t begin = 0;
+			size_t end = 0;
+			bool countsForGroup = false;	// The task holds one of the concurrency slots of its group
+		};
+		struct Worker
+		{
+			std::thread thread;
+			std::mutex mutex;
+			std::deque<Task> tasks;
+
+			std::atomic<size_t> executedTasks{ 0 };
+			std::atomic<size_t> stolenTasks{ 0 };
+			std::atomic<long long> busyNanoseconds{ 0 };
+		};
+
+		void workerLoop(size_t workerIndex);
+		void wakeUpWorkers();
+		bool popTask(size_t workerIndex, Task& task);
+		bool popInjectedTask(Task& task);
+		bool tryTakeTask(Task& task);
+		void executeTask(const Task& task, size_t workerIndex);
+		void waitForJob(Job& job, size_t workerIndex);
+
+		std::vector<Worker*> m_workers;
+
+		// Jobs submitted from threads outside of the pool, served by priority and in turns
+		std::mutex m_injectMutex;
+		std::vector<Job*> m_injectedJobs;
+		size_t m_nextInjectedJob = 0;
+
+		Group m_defaultGroup;
+
+		std::mutex m_sleepMutex;
+		std::condition_variable m_wakeUp;
+		std::atomic<size_t> m_queuedTasks{ 0 };
+		std::atomic<size_t> m_wakeUpCount{ 0 };	// Changes when a queued task may have become executable
+		std::atomic<bool> m_stop{ false };
+
+		std::chrono::steady_clock::time_point m_statisticsStart;
+	};
+}
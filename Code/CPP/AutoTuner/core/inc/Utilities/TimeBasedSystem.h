@@ -2,6 +2,7 @@
 
 #include "AutoTuner_base.h"
 #include "MatlabAPI.h"
+#include <complex>
 
 namespace AutoTuner
 {
@@ -32,6 +33,20 @@ namespace AutoTuner
 			Custom
 		};
 
+		/**
+		 * @brief
+		 * Methods to create the discretized model used by IntegrationSolver::Discretized
+		 * None: The model matrices are already discrete and are used as they are
+		 * ZeroOrderHold: Exact discretization for inputs held constant over a time step
+		 * Tustin: Trapezoidal rule with the input held constant over a time step
+		 */
+		enum class C2DMethod
+		{
+			None,
+			ZeroOrderHold,
+			Tustin
+		};
+
 		static void setDefaultIntegrationSolver(IntegrationSolver solver);
 		static IntegrationSolver getDefaultIntegrationSolver();
 
@@ -43,6 +58,7 @@ namespace AutoTuner
 		{
 			m_solver = other.m_solver;
 			m_diffSolver = other.m_diffSolver;
+			m_c2dMethod = other.m_c2dMethod;
 		}
 		virtual ~TimeBasedSystem();
 
@@ -60,6 +76,12 @@ namespace AutoTuner
 		}
 		DifferentiationSolver getDifferentiationSolver() const { return m_diffSolver; }
 
+		virtual void setC2DMethod(C2DMethod method)
+		{
+			m_c2dMethod = method;
+		}
+		C2DMethod getC2DMethod() const { return m_c2dMethod; }
+
 		
 
 		virtual void reset() {}
@@ -80,6 +102,18 @@ namespace AutoTuner
 		virtual double getOutput(size_t index) const = 0;
 		virtual double getInput(size_t index) const = 0;
 
+		/**
+		 * @brief
+		 * Evaluates the transfer function from an input to an output at s = j * omega.
+		 * Systems with a linear model override this, so FrequencyResponse does not have to simulate a sweep.
+		 * @param omega angular frequency in rad/s
+		 * @return false if the system has no analytic frequency response
+		 */
+		virtual bool getFrequencyResponse(double omega, size_t inputIndex, size_t outputIndex, std::complex<double>& response)
+		{
+			return false;
+		}
+
 
 		static std::string integrationSolverToString(IntegrationSolver solver)
 		{
@@ -95,6 +129,17 @@ namespace AutoTuner
 			}
 			return "Unknown Solver"s;
 		}
+		static std::string c2dMethodToString(C2DMethod method)
+		{
+			using namespace std::string_literals;
+			switch (method)
+			{
+			case C2DMethod::None:				return "None"s;
+			case C2DMethod::ZeroOrderHold:		return "Zero-Order Hold"s;
+			case C2DMethod::Tustin:				return "Tustin"s;
+			}
+			return "Unknown Method"s;
+		}
 		static std::string differentiationSolverToString(DifferentiationSolver solver)
 		{
 			using namespace std::string_literals;
@@ -171,6 +216,7 @@ namespace AutoTuner
 	private:
 		IntegrationSolver m_solver;
 		DifferentiationSolver m_diffSolver;
+		C2DMethod m_c2dMethod = C2DMethod::None;
 		static IntegrationSolver s_defaultSolver;
 		static DifferentiationSolver s_defaultDiffSolver;
 	};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "AutoTunerEngine_base.h"
+#include <atomic>
+#include <cstdint>
+
+namespace AutoTuner
+{
+	/**
+	 * @brief
+	 * Lock-free triple buffer for one writer thread and one reader thread.
+	 * The writer fills its buffer and publishes it, the reader always gets the newest published buffer.
+	 * Neither side ever waits for the other one, values published in between two reads get skipped.
+	 *
+	 * The buffers are reused, the writer gets back a buffer that is up to two publishes old.
+	 * It has to overwrite all values it wants to publish.
+	 */
+	template<typename T>
+	class TripleBuffer
+	{
+	public:
+		TripleBuffer() = default;
+		TripleBuffer(const TripleBuffer&) = delete;
+		TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+		/**
+		 * @brief
+		 * Gets the buffer the writer may fill, writer thread only
+		 */
+		T& getWriteBuffer() { return m_buffers[m_writeIndex]; }
+
+		/**
+		 * @brief
+		 * Hands the write buffer over to the reader and takes the unused buffer as the new write buffer
+		 */
+		void publish()
+		{
+			uint8_t previous = m_shared.exchange(static_cast<uint8_t>(m_writeIndex | s_newDataBit), std::memory_order_acq_rel);
+			m_writeIndex = previous & s_indexMask;
+		}
+
+		/**
+		 * @brief
+		 * Takes the newest published buffer as the read buffer, reader thread only
+		 * @return true if a new buffer was published since the last call
+		 */
+		bool update()
+		{
+			if (!hasNewData())
+				return false;
+			uint8_t previous = m_shared.exchange(m_readIndex, std::memory_order_acq_rel);
+			m_readIndex = previous & s_indexMask;
+			return true;
+		}
+		bool hasNewData() const { return (m_shared.load(std::memory_order_relaxed) & s_newDataBit) != 0; }
+
+		/**
+		 * @brief
+		 * Gets the buffer of the last update(), stays valid until the next update()
+		 */
+		const T& getReadBuffer() const { return m_buffers[m_readIndex]; }
+		T& getReadBuffer() { return m_buffers[m_readIndex]; }
+
+	private:
+		static constexpr uint8_t s_indexMask = 0x03;
+		static constexpr uint8_t s_newDataBit = 0x04;
+
+		T m_buffers[3];
+
+		// Index of the buffer that is neither read nor written, plus the new data flag.
+		// Writer and reader indices sit on their own cache lines, so the sides do not invalidate each other.
+		alignas(64) std::atomic<uint8_t> m_shared{ 1 };
+		alignas(64) uint8_t m_writeIndex = 0;
+		alignas(64) uint8_t m_readIndex = 2;
+	};
+}
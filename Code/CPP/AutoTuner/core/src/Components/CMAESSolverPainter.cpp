@@ -0,0 +1,87 @@
+#include "Components/CMAESSolverPainter.h"
+
+namespace AutoTuner
+{
+	CMAESSolverPainter::CMAESSolverPainter(const std::string& name)
+		: SolverPainter(name)
+	{
+
+	}
+
+	void CMAESSolverPainter::onSnapshotChanged(const SolverSnapshot& snapshot) const
+	{
+		size_t begin = snapshot.history.size() - m_averageScoresHistory.size();
+		m_sigmaHistory.clear();
+		for (size_t i = begin; i < snapshot.history.size(); ++i)
+			m_sigmaHistory.push_back(snapshot.history[i].stepSize);
+	}
+
+	void CMAESSolverPainter::drawComponent(sf::RenderTarget& target, sf::RenderStates states) const
+	{
+		const SolverSnapshot* snapshot = updatePlotData();
+		ImGui::Begin("CMA-ES Solver");
+
+		int dataSize = m_averageScoresHistory.size();
+		if (ImPlot::BeginPlot("Average score history", ImVec2(-1, 200))) {
+			ImPlot::SetupAxes("Iteration", "Average score");
+
+			if (dataSize > 0) {
+				double xMin = m_averageScoresHistoryTimeline[0];
+				double xMax = m_averageScoresHistoryTimeline[m_averageScoresHistoryTimeline.size() - 1];
+				ImPlot::SetupAxisLimits(ImAxis_X1, xMin, xMax, ImPlotCond_Always);
+
+				auto yBegin = m_averageScoresHistory.begin();
+				auto yEnd = m_averageScoresHistory.end();
+				ImPlot::SetupAxisLimits(ImAxis_Y1,
+					*std::min_element(yBegin, yEnd),
+					*std::max_element(yBegin, yEnd),
+					ImPlotCond_Always);
+
+				ImPlot::PlotLine("Average score",
+					m_averageScoresHistoryTimeline.data(),
+					m_averageScoresHistory.data(),
+					m_averageScoresHistory.size());
+			}
+
+			ImPlot::EndPlot();
+		}
+
+		if (ImPlot::BeginPlot("Step size history", ImVec2(-1, 200))) {
+			ImPlot::SetupAxes("Iteration", "Sigma");
+
+			if (dataSize > 0) {
+				double xMin = m_averageScoresHistoryTimeline[0];
+				double xMax = m_averageScoresHistoryTimeline[m_averageScoresHistoryTimeline.size() - 1];
+				ImPlot::SetupAxisLimits(ImAxis_X1, xMin, xMax, ImPlotCond_Always);
+				ImPlot::SetupAxisLimits(ImAxis_Y1,
+					*std::min_element(m_sigmaHistory.begin(), m_sigmaHistory.end()),
+					*std::max_element(m_sigmaHistory.begin(), m_sigmaHistory.end()),
+					ImPlotCond_Always);
+
+				ImPlot::PlotLine("Sigma",
+					m_averageScoresHistoryTimeline.data(),
+					m_sigmaHistory.data(),
+					m_sigmaHistory.size());
+			}
+
+			ImPlot::EndPlot();
+		}
+
+		if (m_scoreParts.size() > 1)
+		{
+			if (ImPlot::BeginPlot("Score parts", ImVec2(-1, 200))) {
+				ImPlot::SetupAxes("Category", "Value");
+				ImPlot::SetupAxisTicks(ImAxis_X1, 0, m_scoreParts.size() - 1, m_scoreParts.size(), m_scorePartsLabels.data());
+				ImPlot::PlotBars("Data", m_scoreParts.data(), m_scoreParts.size(), 0.5f);
+				ImPlot::EndPlot();
+			}
+		}
+
+
+		ImGui::End();
+
+
+		if (snapshot)
+			drawAgentGrid(target, states, snapshot->generation);
+	}
+}
@@ -0,0 +1,76 @@
+#include "Components/DifferentialEvolutionSolverPainter.h"
+
+namespace AutoTuner
+{
+	DifferentialEvolutionSolverPainter::DifferentialEvolutionSolverPainter(const std::string& name)
+		: SolverPainter(name)
+	{
+
+	}
+
+	void DifferentialEvolutionSolverPainter::drawComponent(sf::RenderTarget& target, sf::RenderStates states) const
+	{
+		const SolverSnapshot* snapshot = updatePlotData();
+		ImGui::Begin("Differential Evolution Solver");
+
+		if (ImPlot::BeginPlot("Average score history", ImVec2(-1, 200))) {
+			ImPlot::SetupAxes("Iteration", "Average score");
+			int dataSize = m_averageScoresHistory.size();
+
+			if (dataSize > 0) {
+
+				// Set axis limits based on actual x values
+				double xMin = m_averageScoresHistoryTimeline[0];
+				double xMax = m_averageScoresHistoryTimeline[m_averageScoresHistoryTimeline.size() - 1];
+
+				ImPlot::SetupAxisLimits(ImAxis_X1, xMin, xMax, ImPlotCond_Always);
+
+				// Auto-fit Y axis for visible data
+				auto yBegin = m_averageScoresHistory.begin();
+				auto yEnd = m_averageScoresHistory.end();
+				ImPlot::SetupAxisLimits(ImAxis_Y1,
+					*std::min_element(yBegin, yEnd),
+					*std::max_element(yBegin, yEnd),
+					ImPlotCond_Always);
+
+				// Plot only the visible window
+				ImPlot::PlotLine("Average score",
+					m_averageScoresHistoryTimeline.data(),
+					m_averageScoresHistory.data(),
+					m_averageScoresHistory.size());
+			}
+
+			ImPlot::EndPlot();
+		}
+
+		if (m_scoreParts.size() > 1)
+		{
+			// Create a plot
+			if (ImPlot::BeginPlot("Score parts", ImVec2(-1, 200))) {
+				// Convert std::string labels to const char* (ImPlot needs this form)
+				// Set up x positions for each bar
+				ImPlot::SetupAxes("Category", "Value");
+				ImPlot::SetupAxisTicks(ImAxis_X1, 0, m_scoreParts.size() - 1, m_scoreParts.size(), m_scorePartsLabels.data());
+
+				// Draw bars
+				ImPlot::PlotBars("Data", m_scoreParts.data(), m_scoreParts.size(), 0.5f); // 0.5f = bar width
+
+				ImPlot::EndPlot();
+			}
+		}
+
+		if (snapshot && snapshot->surrogateStatistics.candidates > 0)
+		{
+			ImGui::Text("Surrogate: %zu of %zu candidates tested, %zu tests saved, hit rate %.1f%%",
+				snapshot->surrogateStatistics.evaluations, snapshot->surrogateStatistics.candidates,
+				snapshot->surrogateStatistics.getSavedEvaluations(), snapshot->surrogateStatistics.getHitRate() * 100.0);
+		}
+
+
+		ImGui::End();
+
+
+		if (snapshot)
+			drawAgentGrid(target, states, snapshot->generation);
+	}
+}
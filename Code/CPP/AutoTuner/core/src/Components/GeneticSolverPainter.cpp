@@ -0,0 +1,138 @@
+#include "Components/GeneticSolverPainter.h"
+#include "implot_internal.h"
+
+namespace AutoTuner
+{
+	GeneticSolverPainter::GeneticSolverPainter(const std::string& name)
+		: SolverPainter(name)
+	{
+
+	}
+
+	void GeneticSolverPainter::onSnapshotChanged(const SolverSnapshot& snapshot) const
+	{
+		const PopulationStore::Generation& generation = snapshot.generation;
+		const size_t agentCount = generation.getAgentCount();
+		double sumScore = 0;
+		for (size_t i = 0; i < agentCount; ++i)
+			sumScore += generation.getScore(i);
+
+		m_piChartLabelStrings.resize(agentCount);
+		m_piChartLabels.resize(agentCount);
+		m_piChartData.resize(agentCount);
+		for (size_t i = 0; i < agentCount; ++i)
+		{
+			double score = generation.getScore(i);
+			m_piChartLabelStrings[i] = "Agent " + std::to_string(i) + " (Score: " + std::to_string(score) + ")";
+			m_piChartLabels[i] = m_piChartLabelStrings[i].c_str();
+			m_piChartData[i] = static_cast<float>(score * 100.0 / sumScore);
+		}
+	}
+
+	void GeneticSolverPainter::drawComponent(sf::RenderTarget& target, sf::RenderStates states) const
+	{
+		const SolverSnapshot* snapshot = updatePlotData();
+		ImGui::Begin("Genetic Solver Population");
+
+		if (ImPlot::BeginPlot("Pie Chart", ImVec2(400, 400), ImPlotFlags_NoLegend)) {
+			const int n = (int)m_piChartData.size()*2;
+			static std::vector<ImVec4> colors;
+			colors.resize(n);
+
+			static ImPlotColormap cmap = -1;
+
+			if (cmap == -1) {
+				colors.resize(n);
+				ImVec4 startColor = ImVec4(0.0f, 0.2f, 0.8f, 1.0f); // dark blue
+				ImVec4 endColor = ImVec4(0.4f, 0.7f, 1.0f, 1.0f); // light blue
+				for (int i = 0; i < n; ++i) {
+					float t = (float)i / (float)std::max(1, n - 1);
+					colors[i].x = startColor.x + t * (endColor.x - startColor.x);
+					colors[i].y = startColor.y + t * (endColor.y - startColor.y);
+					colors[i].z = startColor.z + t * (endColor.z - startColor.z);
+					colors[i].w = 1.0f;
+				}
+
+				// Register the colormap once
+				cmap = ImPlot::AddColormap("BlueGradient", colors.data(), n);
+			}
+
+			// Use this colormap temporarily
+			ImPlot::PushColormap(cmap);
+			ImPlot::GetCurrentPlot()->Items.ColormapIdx = 0;
+
+			ImPlot::PlotPieChart(
+				m_piChartLabels.data(),
+				m_piChartData.data(),
+				m_piChartLabels.size(),
+				0.5, 0.5,   // center
+				0.4,        // radius
+				"%.1f%%",   // label format
+				90.0        // start angle
+			);
+
+			ImPlot::PopColormap();
+			ImPlot::EndPlot();
+		}
+
+
+		if (ImPlot::BeginPlot("Average score history", ImVec2(-1, 200))) {
+			ImPlot::SetupAxes("Iteration", "Average score");
+			int dataSize = m_averageScoresHistory.size();
+
+			if (dataSize > 0) {
+
+				// Set axis limits based on actual x values
+				double xMin = m_averageScoresHistoryTimeline[0];
+				double xMax = m_averageScoresHistoryTimeline[m_averageScoresHistoryTimeline.size()-1];
+
+				ImPlot::SetupAxisLimits(ImAxis_X1, xMin, xMax, ImPlotCond_Always);
+
+				// Auto-fit Y axis for visible data
+				auto yBegin = m_averageScoresHistory.begin();
+				auto yEnd = m_averageScoresHistory.end();
+				ImPlot::SetupAxisLimits(ImAxis_Y1,
+					*std::min_element(yBegin, yEnd),
+					*std::max_element(yBegin, yEnd),
+					ImPlotCond_Always);
+
+				// Plot only the visible window
+				ImPlot::PlotLine("Average score",
+					m_averageScoresHistoryTimeline.data(),
+					m_averageScoresHistory.data(),
+					m_averageScoresHistory.size());
+			}
+
+			ImPlot::EndPlot();
+		}
+
+		if (m_scoreParts.size() > 1)
+		{
+			// Create a plot
+			if (ImPlot::BeginPlot("Score parts", ImVec2(-1, 200))) {
+				// Convert std::string labels to const char* (ImPlot needs this form)
+				// Set up x positions for each bar
+				ImPlot::SetupAxes("Category", "Value");
+				ImPlot::SetupAxisTicks(ImAxis_X1, 0, m_scoreParts.size() - 1, m_scoreParts.size(), m_scorePartsLabels.data());
+
+				// Draw bars
+				ImPlot::PlotBars("Data", m_scoreParts.data(), m_scoreParts.size(), 0.5f); // 0.5f = bar width
+
+				ImPlot::EndPlot();
+			}
+		}
+
+		if (snapshot && snapshot->surrogateStatistics.candidates > 0)
+		{
+			ImGui::Text("Surrogate: %zu of %zu candidates tested, %zu tests saved, hit rate %.1f%%",
+				snapshot->surrogateStatistics.evaluations, snapshot->surrogateStatistics.candidates,
+				snapshot->surrogateStatistics.getSavedEvaluations(), snapshot->surrogateStatistics.getHitRate() * 100.0);
+		}
+
+		ImGui::End();
+
+
+		if (snapshot)
+			drawAgentGrid(target, states, snapshot->generation);
+	}
+}
@@ -0,0 +1,96 @@
+#include "Components/NSGA2SolverPainter.h"
+
+namespace AutoTuner
+{
+	NSGA2SolverPainter::NSGA2SolverPainter(const std::string& name)
+		: SolverPainter(name)
+	{
+
+	}
+
+	void NSGA2SolverPainter::onSnapshotChanged(const SolverSnapshot& snapshot) const
+	{
+		m_frontX.clear();
+		m_frontY.clear();
+		for (const std::vector<double>& scoreParts : snapshot.paretoFrontScoreParts)
+		{
+			if (scoreParts.size() < 2)
+				return;
+			m_frontX.push_back(scoreParts[0]);
+			m_frontY.push_back(scoreParts[1]);
+		}
+	}
+
+	void NSGA2SolverPainter::drawComponent(sf::RenderTarget& target, sf::RenderStates states) const
+	{
+		const SolverSnapshot* snapshot = updatePlotData();
+		ImGui::Begin("NSGA-II Solver");
+
+		if (ImPlot::BeginPlot("Average score history", ImVec2(-1, 200))) {
+			ImPlot::SetupAxes("Iteration", "Average score");
+			int dataSize = m_averageScoresHistory.size();
+
+			if (dataSize > 0) {
+
+				// Set axis limits based on actual x values
+				double xMin = m_averageScoresHistoryTimeline[0];
+				double xMax = m_averageScoresHistoryTimeline[m_averageScoresHistoryTimeline.size() - 1];
+
+				ImPlot::SetupAxisLimits(ImAxis_X1, xMin, xMax, ImPlotCond_Always);
+
+				// Auto-fit Y axis for visible data
+				auto yBegin = m_averageScoresHistory.begin();
+				auto yEnd = m_averageScoresHistory.end();
+				ImPlot::SetupAxisLimits(ImAxis_Y1,
+					*std::min_element(yBegin, yEnd),
+					*std::max_element(yBegin, yEnd),
+					ImPlotCond_Always);
+
+				// Plot only the visible window
+				ImPlot::PlotLine("Average score",
+					m_averageScoresHistoryTimeline.data(),
+					m_averageScoresHistory.data(),
+					m_averageScoresHistory.size());
+			}
+
+			ImPlot::EndPlot();
+		}
+
+		if (m_frontX.size() > 0 && m_scorePartsLabels.size() >= 2)
+		{
+			if (ImPlot::BeginPlot("Pareto front", ImVec2(-1, 200))) {
+				ImPlot::SetupAxes(m_scorePartsLabels[0], m_scorePartsLabels[1]);
+				ImPlot::SetupAxisLimits(ImAxis_X1,
+					*std::min_element(m_frontX.begin(), m_frontX.end()),
+					*std::max_element(m_frontX.begin(), m_frontX.end()),
+					ImPlotCond_Always);
+				ImPlot::SetupAxisLimits(ImAxis_Y1,
+					*std::min_element(m_frontY.begin(), m_frontY.end()),
+					*std::max_element(m_frontY.begin(), m_frontY.end()),
+					ImPlotCond_Always);
+				ImPlot::PlotScatter("Front", m_frontX.data(), m_frontY.data(), m_frontX.size());
+
+				ImPlot::EndPlot();
+			}
+		}
+
+		if (m_scoreParts.size() > 1)
+		{
+			if (ImPlot::BeginPlot("Score parts", ImVec2(-1, 200))) {
+				ImPlot::SetupAxes("Category", "Value");
+				ImPlot::SetupAxisTicks(ImAxis_X1, 0, m_scoreParts.size() - 1, m_scoreParts.size(), m_scorePartsLabels.data());
+
+				ImPlot::PlotBars("Data", m_scoreParts.data(), m_scoreParts.size(), 0.5f); // 0.5f = bar width
+
+				ImPlot::EndPlot();
+			}
+		}
+
+
+		ImGui::End();
+
+
+		if (snapshot)
+			drawAgentGrid(target, states, snapshot->generation);
+	}
+}
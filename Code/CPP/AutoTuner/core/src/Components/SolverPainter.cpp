@@ -0,0 +1,111 @@
+#include "Components/SolverPainter.h"
+
+namespace AutoTuner
+{
+	SolverPainter::SolverPainter(const std::string& name)
+		: QSFML::Components::Drawable(name)
+	{
+
+	}
+	SolverPainter::~SolverPainter()
+	{
+		clearScorePartsLabels();
+	}
+
+	const SolverSnapshot* SolverPainter::updatePlotData() const
+	{
+		const SolverSnapshot* snapshot = m_snapshot.get();
+		if (!snapshot || snapshot->version == m_plottedVersion)
+			return snapshot;
+		m_plottedVersion = snapshot->version;
+
+		updateScorePartsLabels(snapshot->scorePartsLabels);
+		collectScoreParts(snapshot->generation);
+		collectHistory(*snapshot);
+		onSnapshotChanged(*snapshot);
+		return snapshot;
+	}
+
+	void SolverPainter::drawAgentGrid(sf::RenderTarget& target, sf::RenderStates states, const PopulationStore::Generation& generation) const
+	{
+		if (m_agentToColorFunc == nullptr)
+			return;
+		const size_t agentCount = generation.getAgentCount();
+		size_t gridColumns = std::max<size_t>(1, static_cast<size_t>(std::sqrt(agentCount)));
+		for (size_t i = 0; i < agentCount; ++i)
+		{
+			generation.getParameters(i, m_agentParameters);
+			sf::Color color = m_agentToColorFunc(m_agentParameters);
+			double size = generation.getScore(i) * 0.1;
+			if (size < 1)
+				size = 1;
+			if (size > 10)
+				size = 10;
+			sf::RectangleShape rect(sf::Vector2f(size, size));
+			rect.setFillColor(color);
+
+			size_t gridPosX = i % gridColumns;
+			size_t gridPosY = i / gridColumns;
+			rect.setPosition(static_cast<float>(gridPosX * 11), static_cast<float>(gridPosY * 11));
+			target.draw(rect, states);
+		}
+	}
+
+	void SolverPainter::updateScorePartsLabels(const std::vector<std::string>& labels) const
+	{
+		if (labels == m_labels)
+			return;
+		m_labels = labels;
+		clearScorePartsLabels();
+		m_scorePartsLabels.reserve(labels.size());
+		for (const auto& label : labels)
+		{
+			char* s = new char[label.size() + 1];
+			memcpy(s, label.c_str(), label.size() + 1);
+			m_scorePartsLabels.push_back(s);
+		}
+		m_scoreParts = std::vector<double>(labels.size(), 0.0);
+	}
+
+	void SolverPainter::collectScoreParts(const PopulationStore::Generation& generation) const
+	{
+		std::fill(m_scoreParts.begin(), m_scoreParts.end(), 0.0);
+		size_t scorePartCount = std::min(m_scoreParts.size(), generation.getScorePartCount());
+		double sumScores = 0.0;
+		for (size_t j = 0; j < scorePartCount; ++j)
+		{
+			const double* parts = generation.getScorePartRow(j);
+			for (size_t i = 0; i < generation.getAgentCount(); ++i)
+				m_scoreParts[j] += parts[i];
+			sumScores += m_scoreParts[j];
+		}
+		if (sumScores != 0)
+		{
+			for (size_t i = 0; i < m_scoreParts.size(); ++i)
+			{
+				m_scoreParts[i] /= sumScores;
+			}
+		}
+	}
+
+	void SolverPainter::collectHistory(const SolverSnapshot& snapshot) const
+	{
+		size_t begin = snapshot.history.size() > m_historySize ? snapshot.history.size() - m_historySize : 0;
+		m_averageScoresHistory.clear();
+		m_averageScoresHistoryTimeline.clear();
+		for (size_t i = begin; i < snapshot.history.size(); ++i)
+		{
+			m_averageScoresHistory.push_back(snapshot.history[i].averageScore);
+			m_averageScoresHistoryTimeline.push_back(static_cast<double>(snapshot.history[i].epoch));
+		}
+	}
+
+	void SolverPainter::clearScorePartsLabels() const
+	{
+		for (size_t i = 0; i < m_scorePartsLabels.size(); ++i)
+		{
+			delete[] m_scorePartsLabels[i];
+		}
+		m_scorePartsLabels.clear();
+	}
+}
@@ -0,0 +1,45 @@
+#include "GameObjects/SolverObject.h"
+#include "Components/GeneticSolverPainter.h"
+#include "Components/DifferentialEvolutionSolverPainter.h"
+#include "Components/CMAESSolverPainter.h"
+#include "Components/NSGA2SolverPainter.h"
+
+namespace AutoTuner
+{
+	SolverObject::SolverObject(Solver* solver,
+		const std::string& name,
+		GameObject* parent)
+		: QSFML::Objects::GameObject(name.empty() && solver ? solver->getName() : name, parent)
+		, m_solver(solver)
+	{
+		m_painter = createPainter(m_solver);
+		if (m_painter)
+			addComponent(m_painter);
+		m_worker.setSolver(m_solver);
+	}
+	SolverObject::~SolverObject()
+	{
+		m_worker.setSolver(nullptr);	// Stops the worker thread before the solver goes away
+		delete m_solver;
+	}
+
+	void SolverObject::update()
+	{
+		// Only the handle changes hands, the painter reads the snapshot when it draws
+		if (m_worker.updateSnapshot() && m_painter)
+			m_painter->setSnapshot(m_worker.getSnapshot());
+	}
+
+	SolverPainter* SolverObject::createPainter(const Solver* solver)
+	{
+		if (dynamic_cast<const GeneticSolver*>(solver))
+			return new GeneticSolverPainter();
+		if (dynamic_cast<const DifferentialEvolutionSolver*>(solver))
+			return new DifferentialEvolutionSolverPainter();
+		if (dynamic_cast<const CMAESSolver*>(solver))
+			return new CMAESSolverPainter();
+		if (dynamic_cast<const NSGA2Solver*>(solver))
+			return new NSGA2SolverPainter();
+		return nullptr;
+	}
+}
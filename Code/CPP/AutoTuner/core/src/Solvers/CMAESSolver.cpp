@@ -0,0 +1,462 @@
+#include "Solvers/CMAESSolver.h"
+#include "Utilities/LinearAlgebra.h"
+
+namespace AutoTuner
+{
+	CMAESSolver::CMAESSolver()
+		: Solver("CMAESSolver")
+	{
+	}
+	CMAESSolver::~CMAESSolver()
+	{
+	}
+
+
+	void CMAESSolver::setInitialParameters(const std::vector<std::vector<double>>& parameterList)
+	{
+		m_lastRoundBestIndividual = Individual();
+		clearAlltimeBestParameters();
+		m_populationSampled = false;
+		m_populationTested = false;
+
+		m_parameterCount = parameterList.size() > 0 ? parameterList[0].size() : 0;
+		const size_t n = m_parameterCount;
+		if (n == 0)
+		{
+			m_population.resize(0, 0, m_scorePartCount);
+			return;
+		}
+
+		// Mean and spread of the initial parameters define the search region
+		const double count = static_cast<double>(parameterList.size());
+		m_initialMean.assign(n, 0.0);
+		m_initialScale.assign(n, 0.0);
+		for (const auto& parameters : parameterList)
+			for (size_t p = 0; p < n; ++p)
+				m_initialMean[p] += parameters[p] / count;
+		for (const auto& parameters : parameterList)
+			for (size_t p = 0; p < n; ++p)
+				m_initialScale[p] += (parameters[p] - m_initialMean[p]) * (parameters[p] - m_initialMean[p]) / count;
+
+		double meanVariance = 0;
+		for (size_t p = 0; p < n; ++p)
+		{
+			m_initialScale[p] = std::sqrt(m_initialScale[p]);
+			// A single initial agent gives no spread, start with 10% of the value
+			if (!(m_initialScale[p] > 0))
+				m_initialScale[p] = 0.1 * std::max(std::abs(m_initialMean[p]), 1.0);
+			meanVariance += m_initialScale[p] * m_initialScale[p] / static_cast<double>(n);
+		}
+		// sigma carries the overall scale, C0 the relative scale of each parameter
+		m_initialSigma = std::sqrt(meanVariance);
+		for (size_t p = 0; p < n; ++p)
+			m_initialScale[p] /= m_initialSigma;
+
+		if (m_requestedPopulationSize > 0)
+			m_defaultLambda = std::max<size_t>(m_requestedPopulationSize, 2);
+		else
+			m_defaultLambda = 4 + static_cast<size_t>(3.0 * std::log(static_cast<double>(n)));
+
+		m_largeLambda = m_defaultLambda;
+		m_smallRegimeRun = false;
+		m_largeRegimeEvaluations = 0;
+		m_smallRegimeEvaluations = 0;
+		m_restartCount = 0;
+		m_evaluationCount = 0;
+
+		startRun(m_initialMean, m_initialSigma * m_stepSizeFactor, m_defaultLambda);
+		samplePopulation();
+	}
+
+
+	void CMAESSolver::iterate()
+	{
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_1);
+		if (!m_populationTested)
+			return;
+
+		const PopulationStore::Generation& population = m_population.getCurrent();
+		notifyGeneration(population);
+
+		updateDistribution();
+		if (m_restartStrategy != RestartStrategy::None && shouldRestart())
+			restart();
+		samplePopulation();
+	}
+	void CMAESSolver::test()
+	{
+		if (!hasTestFunc() || m_population.empty() || !m_populationSampled || m_populationTested)
+			return;
+
+		PopulationStore::Generation& population = m_population.getCurrent();
+		testGeneration(population);
+		m_populationTested = true;
+
+		m_evaluationCount += m_lambda;
+		if (m_smallRegimeRun)
+			m_smallRegimeEvaluations += m_lambda;
+		else
+			m_largeRegimeEvaluations += m_lambda;
+
+		updateBestIndividuals();
+		// Only the best half gets selected, anything worse than the whole last generation can stop
+		updateRacingThreshold(population);
+	}
+
+	void CMAESSolver::startRun(const std::vector<double>& mean, double sigma, size_t lambda)
+	{
+		const size_t n = m_parameterCount;
+		const double dn = static_cast<double>(n);
+
+		m_lambda = lambda;
+		m_mu = std::max<size_t>(lambda / 2, 1);
+
+		// Log-linear positive recombination weights
+		m_weights.resize(m_mu);
+		double sumWeights = 0;
+		for (size_t i = 0; i < m_mu; ++i)
+		{
+			m_weights[i] = std::log((static_cast<double>(lambda) + 1.0) / 2.0) - std::log(static_cast<double>(i + 1));
+			sumWeights += m_weights[i];
+		}
+		double sumSquaredWeights = 0;
+		for (size_t i = 0; i < m_mu; ++i)
+		{
+			m_weights[i] /= sumWeights;
+			sumSquaredWeights += m_weights[i] * m_weights[i];
+		}
+		m_muEff = 1.0 / sumSquaredWeights;
+
+		// Default strategy parameters, see Hansen: The CMA Evolution Strategy: A Tutorial
+		m_cSigma = (m_muEff + 2.0) / (dn + m_muEff + 5.0);
+		m_dSigma = 1.0 + 2.0 * std::max(0.0, std::sqrt((m_muEff - 1.0) / (dn + 1.0)) - 1.0) + m_cSigma;
+		m_cC = (4.0 + m_muEff / dn) / (dn + 4.0 + 2.0 * m_muEff / dn);
+		m_c1 = 2.0 / ((dn + 1.3) * (dn + 1.3) + m_muEff);
+		m_cMu = std::min(1.0 - m_c1, 2.0 * (m_muEff - 2.0 + 1.0 / m_muEff) / ((dn + 2.0) * (dn + 2.0) + m_muEff));
+		m_chiN = std::sqrt(dn) * (1.0 - 1.0 / (4.0 * dn) + 1.0 / (21.0 * dn * dn));
+
+		m_mean = mean;
+		m_sigma = sigma;
+		m_covariance.assign(n * n, 0.0);
+		m_eigenVectors = LinearAlgebra::identity(n);
+		m_eigenValuesSqrt = m_initialScale;
+		m_transform.assign(n * n, 0.0);
+		for (size_t p = 0; p < n; ++p)
+		{
+			m_covariance[p * n + p] = m_initialScale[p] * m_initialScale[p];
+			m_transform[p * n + p] = m_initialScale[p];
+		}
+		m_pathSigma.assign(n, 0.0);
+		m_pathC.assign(n, 0.0);
+		m_meanStep.assign(n, 0.0);
+		m_tmpVector.assign(n, 0.0);
+
+		m_z.assign(n * lambda, 0.0);
+		m_y.assign(n * lambda, 0.0);
+		m_selectedY.assign(n * m_mu, 0.0);
+		m_ranking.resize(lambda);
+
+		m_generation = 0;
+		m_eigenGeneration = 0;
+		m_bestScoreHistory.clear();
+
+		m_population.resize(lambda, n, m_scorePartCount);
+		m_populationSampled = false;
+		m_populationTested = false;
+		// The threshold of the last run says nothing about the new region
+		resetRacingThreshold();
+	}
+
+	void CMAESSolver::samplePopulation()
+	{
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_3);
+		const size_t n = m_parameterCount;
+		const size_t lambda = m_lambda;
+		if (n == 0 || lambda == 0)
+			return;
+
+		PopulationStore::Generation& population = m_population.getCurrent();
+		m_random.fillGaussian(m_z.data(), m_z.size());
+
+		// y = B * D * z, row p of y is a linear combination of the rows of z
+		for (size_t p = 0; p < n; ++p)
+		{
+			double* y = m_y.data() + p * lambda;
+			std::fill(y, y + lambda, 0.0);
+			for (size_t j = 0; j < n; ++j)
+			{
+				const double factor = m_transform[p * n + j];
+				if (factor == 0)
+					continue;
+				const double* z = m_z.data() + j * lambda;
+				for (size_t k = 0; k < lambda; ++k)
+					y[k] += factor * z[k];
+			}
+
+			double* x = population.getParameterRow(p);
+			const double mean = m_mean[p];
+			const double sigma = m_sigma;
+			for (size_t k = 0; k < lambda; ++k)
+				x[k] = mean + sigma * y[k];
+		}
+		m_populationSampled = true;
+		m_populationTested = false;
+	}
+
+	void CMAESSolver::updateDistribution()
+	{
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_4);
+		const size_t n = m_parameterCount;
+		const size_t lambda = m_lambda;
+		const size_t mu = m_mu;
+		const PopulationStore::Generation& population = m_population.getCurrent();
+		const double* scores = population.getScores();
+
+		for (size_t i = 0; i < lambda; ++i)
+			m_ranking[i] = i;
+		// NaN scores rank last
+		std::stable_sort(m_ranking.begin(), m_ranking.end(), [&](size_t a, size_t b)
+			{
+				if (std::isnan(scores[a]))
+					return false;
+				if (std::isnan(scores[b]))
+					return true;
+				return isBetter(scores[a], scores[b]);
+			});
+		m_bestScoreHistory.push_back(scores[m_ranking[0]]);
+
+		// Gather the selected samples and move the mean
+		for (size_t p = 0; p < n; ++p)
+		{
+			const double* y = m_y.data() + p * lambda;
+			double* selected = m_selectedY.data() + p * mu;
+			double step = 0;
+			for (size_t i = 0; i < mu; ++i)
+			{
+				selected[i] = y[m_ranking[i]];
+				step += m_weights[i] * selected[i];
+			}
+			m_meanStep[p] = step;
+			m_mean[p] += m_sigma * step;
+		}
+
+		// Step size path, uses C^(-1/2) * meanStep = B * D^-1 * B^T * meanStep
+		for (size_t i = 0; i < n; ++i)
+		{
+			double sum = 0;
+			for (size_t p = 0; p < n; ++p)
+				sum += m_eigenVectors[p * n + i] * m_meanStep[p];
+			m_tmpVector[i] = sum / m_eigenValuesSqrt[i];
+		}
+		const double sigmaPathFactor = std::sqrt(m_cSigma * (2.0 - m_cSigma) * m_muEff);
+		double pathSigmaNorm = 0;
+		for (size_t p = 0; p < n; ++p)
+		{
+			double sum = 0;
+			for (size_t i = 0; i < n; ++i)
+				sum += m_eigenVectors[p * n + i] * m_tmpVector[i];
+			m_pathSigma[p] = (1.0 - m_cSigma) * m_pathSigma[p] + sigmaPathFactor * sum;
+			pathSigmaNorm += m_pathSigma[p] * m_pathSigma[p];
+		}
+		pathSigmaNorm = std::sqrt(pathSigmaNorm);
+
+		// Stalls the rank one update while the step size path is too long
+		const double pathCorrection = std::sqrt(1.0 - std::pow(1.0 - m_cSigma, 2.0 * static_cast<double>(m_generation + 1)));
+		const bool hSigma = pathSigmaNorm / pathCorrection / m_chiN < 1.4 + 2.0 / (static_cast<double>(n) + 1.0);
+		const double cPathFactor = hSigma ? std::sqrt(m_cC * (2.0 - m_cC) * m_muEff) : 0.0;
+		for (size_t p = 0; p < n; ++p)
+			m_pathC[p] = (1.0 - m_cC) * m_pathC[p] + cPathFactor * m_meanStep[p];
+
+		// C = a * C + c1 * pc * pc^T + cmu * sum(w_i * y_i * y_i^T)
+		const double oldFactor = 1.0 - m_c1 - m_cMu + (hSigma ? 0.0 : m_c1 * m_cC * (2.0 - m_cC));
+		for (size_t p = 0; p < n; ++p)
+		{
+			const double* selectedP = m_selectedY.data() + p * mu;
+			for (size_t q = p; q < n; ++q)
+			{
+				const double* selectedQ = m_selectedY.data() + q * mu;
+				double rankMu = 0;
+				for (size_t i = 0; i < mu; ++i)
+					rankMu += m_weights[i] * selectedP[i] * selectedQ[i];
+				double value = oldFactor * m_covariance[p * n + q]
+					+ m_c1 * m_pathC[p] * m_pathC[q]
+					+ m_cMu * rankMu;
+				m_covariance[p * n + q] = value;
+				m_covariance[q * n + p] = value;
+			}
+		}
+
+		// The change is limited to a factor of e per generation, protects against a bad first generation
+		m_sigma *= std::exp(std::min(1.0, (m_cSigma / m_dSigma) * (pathSigmaNorm / m_chiN - 1.0)));
+		++m_generation;
+
+		// The decomposition costs O(n^3), C changes slowly enough to do it only every few generations
+		const double eigenInterval = static_cast<double>(lambda) / ((m_c1 + m_cMu) * static_cast<double>(n) * 10.0);
+		if (static_cast<double>(m_generation - m_eigenGeneration) >= eigenInterval)
+			updateEigenDecomposition();
+	}
+	void CMAESSolver::updateEigenDecomposition()
+	{
+		const size_t n = m_parameterCount;
+		m_eigenGeneration = m_generation;
+		std::vector<double> eigenValues;
+		std::vector<double> eigenVectors;
+		if (!LinearAlgebra::symmetricEigen(m_covariance, n, eigenValues, eigenVectors))
+			return;
+
+		m_eigenVectors = std::move(eigenVectors);
+		for (size_t i = 0; i < n; ++i)
+			m_eigenValuesSqrt[i] = std::sqrt(std::max(eigenValues[i], std::numeric_limits<double>::min()));
+		for (size_t p = 0; p < n; ++p)
+			for (size_t j = 0; j < n; ++j)
+				m_transform[p * n + j] = m_eigenVectors[p * n + j] * m_eigenValuesSqrt[j];
+	}
+
+	bool CMAESSolver::shouldRestart() const
+	{
+		const size_t n = m_parameterCount;
+		if (!std::isfinite(m_sigma) || m_sigma <= 0)
+			return true;
+
+		// TolX: the distribution got smaller than the resolution we care about
+		bool converged = true;
+		for (size_t p = 0; p < n && converged; ++p)
+		{
+			double spread = m_sigma * std::max(std::sqrt(m_covariance[p * n + p]), std::abs(m_pathC[p]));
+			if (spread >= s_tolX * m_initialSigma)
+				converged = false;
+		}
+		if (converged)
+			return true;
+
+		// Ill conditioned covariance matrix
+		auto minMax = std::minmax_element(m_eigenValuesSqrt.begin(), m_eigenValuesSqrt.end());
+		double condition = (*minMax.second / *minMax.first) * (*minMax.second / *minMax.first);
+		if (!(condition <= s_maxCondition))
+			return true;
+
+		// A step of 0.2 standard deviations no longer changes the mean
+		for (size_t p = 0; p < n; ++p)
+		{
+			if (m_mean[p] == m_mean[p] + 0.2 * m_sigma * std::sqrt(m_covariance[p * n + p]))
+				return true;
+		}
+
+		// TolFun: the best scores of the last generations and the scores of this generation are flat
+		const size_t historyLength = 10 + static_cast<size_t>(std::ceil(30.0 * static_cast<double>(n) / static_cast<double>(m_lambda)));
+		if (m_bestScoreHistory.size() >= historyLength)
+		{
+			double minScore = std::numeric_limits<double>::infinity();
+			double maxScore = -std::numeric_limits<double>::infinity();
+			for (size_t i = m_bestScoreHistory.size() - historyLength; i < m_bestScoreHistory.size(); ++i)
+			{
+				minScore = std::min(minScore, m_bestScoreHistory[i]);
+				maxScore = std::max(maxScore, m_bestScoreHistory[i]);
+			}
+			const double* scores = m_population.getCurrent().getScores();
+			for (size_t i = 0; i < m_lambda; ++i)
+			{
+				if (!std::isfinite(scores[i]))
+					continue;
+				minScore = std::min(minScore, scores[i]);
+				maxScore = std::max(maxScore, scores[i]);
+			}
+			if (maxScore - minScore <= s_tolFun * std::max(1.0, std::abs(minScore)))
+				return true;
+		}
+		return false;
+	}
+	void CMAESSolver::restart()
+	{
+		const size_t n = m_parameterCount;
+		++m_restartCount;
+
+		size_t lambda = m_largeLambda;
+		double sigma = m_initialSigma * m_stepSizeFactor;
+		m_smallRegimeRun = false;
+		if (m_restartStrategy == RestartStrategy::BIPOP && m_smallRegimeEvaluations < m_largeRegimeEvaluations)
+		{
+			// Small regime: population between the default and half of the large one, smaller step size
+			double u = m_random.nextDouble();
+			double ratio = 0.5 * static_cast<double>(m_largeLambda) / static_cast<double>(m_defaultLambda);
+			lambda = static_cast<size_t>(static_cast<double>(m_defaultLambda) * std::pow(std::max(ratio, 1.0), u * u));
+			lambda = std::max<size_t>(lambda, 2);
+			sigma *= std::pow(10.0, -2.0 * u);
+			m_smallRegimeRun = true;
+		}
+		else
+		{
+			m_largeLambda = std::min(m_largeLambda * 2, m_defaultLambda * s_maxLambdaFactor);
+			lambda = m_largeLambda;
+		}
+
+		// New start point, uniform in the region of the initial parameters
+		std::vector<double> mean(n);
+		for (size_t p = 0; p < n; ++p)
+		{
+			double halfWidth = std::sqrt(3.0) * m_initialSigma * m_initialScale[p];
+			mean[p] = m_initialMean[p] + m_random.getDouble(-halfWidth, halfWidth);
+		}
+		startRun(mean, sigma, lambda);
+	}
+
+	void CMAESSolver::updateBestIndividuals()
+	{
+		const PopulationStore::Generation& population = m_population.getCurrent();
+		if (population.getAgentCount() == 0)
+			return;
+		size_t bestIndex = 0;
+		for (size_t i = 1; i < population.getAgentCount(); ++i)
+		{
+			if (isBetter(population.getScore(i), population.getScore(bestIndex)))
+				bestIndex = i;
+		}
+		m_lastRoundBestIndividual.fitness = population.getScore(bestIndex);
+		population.getParameters(bestIndex, m_lastRoundBestIndividual.parameters);
+
+		if (isBetter(m_lastRoundBestIndividual.fitness, m_alltimeBestIndividual.fitness))
+		{
+			m_alltimeBestIndividual = m_lastRoundBestIndividual;
+		}
+	}
+
+	void CMAESSolver::setMutationAmount(double amount)
+	{
+		m_stepSizeFactor = amount;
+	}
+	double CMAESSolver::getMutationAmount() const
+	{
+		return m_stepSizeFactor;
+	}
+
+
+	void CMAESSolver::setScorePartsLabels(const std::vector<std::string>& labels)
+	{
+		Solver::setScorePartsLabels(labels);
+		m_scorePartCount = labels.size();
+		m_population.setScorePartCount(m_scorePartCount);
+	}
+
+	const std::vector<double>& CMAESSolver::getAlltimeBestParameters() const
+	{
+		return m_alltimeBestIndividual.parameters;
+	}
+	const std::vector<double>& CMAESSolver::getBestParameters() const
+	{
+		return m_lastRoundBestIndividual.parameters;
+	}
+
+	void CMAESSolver::clearAlltimeBestParameters()
+	{
+		m_alltimeBestIndividual = Individual();
+		if (m_optimizingDirection == OptimizingDirection::Minimize)
+		{
+			m_alltimeBestIndividual.fitness = std::numeric_limits<double>::infinity();
+		}
+		else
+		{
+			m_alltimeBestIndividual.fitness = -std::numeric_limits<double>::infinity();
+		}
+		notifyReset();
+	}
+}
@@ -0,0 +1,210 @@
+#include "Solvers/DifferentialEvolutionSolver.h"
+#include <cmath>
+
+namespace AutoTuner
+{
+	DifferentialEvolutionSolver::DifferentialEvolutionSolver()
+		: Solver("DifferentialEvolutionSolver")
+	{
+	}
+	DifferentialEvolutionSolver::~DifferentialEvolutionSolver()
+	{
+	}
+
+
+	void DifferentialEvolutionSolver::setInitialParameters(const std::vector<std::vector<double>>& parameterList)
+	{
+		size_t parameterCount = parameterList.size() > 0 ? parameterList[0].size() : 0;
+		m_population.resize(parameterList.size(), parameterCount, m_scorePartCount);
+		m_trials.resize(parameterList.size(), parameterCount, m_scorePartCount);
+		for (size_t i = 0; i < parameterList.size(); ++i)
+		{
+			m_population.getCurrent().setParameters(i, parameterList[i]);
+		}
+		m_populationTested = false;
+		m_trialsCreated = false;
+		m_trialsTested = false;
+
+		m_lastRoundBestIndividual = Individual();
+		clearAlltimeBestParameters();
+	}
+
+
+	void DifferentialEvolutionSolver::iterate()
+	{
+		if (!m_populationTested)
+			return;
+
+		if (m_trialsTested)
+			selectTrials();
+
+		const PopulationStore::Generation& population = m_population.getCurrent();
+		notifyGeneration(population);
+		updateBestIndividuals();
+		// A trial only replaces its parent, so it can stop once it is worse than the parents
+		updateRacingThreshold(population);
+
+		createTrials();
+	}
+	void DifferentialEvolutionSolver::test()
+	{
+		if (!hasTestFunc() || m_population.empty())
+			return;
+
+		if (!m_populationTested)
+		{
+			testGeneration(m_population.getCurrent());
+			trainSurrogate(m_population.getCurrent());
+			m_populationTested = true;
+		}
+		else if (m_trialsCreated && !m_trialsTested)
+		{
+			testGeneration(m_trials.getCurrent());
+			trainSurrogate(m_trials.getCurrent());
+			m_trialsTested = true;
+		}
+	}
+
+	void DifferentialEvolutionSolver::selectTrials()
+	{
+		PopulationStore::Generation& population = m_population.getCurrent();
+		const PopulationStore::Generation& trials = m_trials.getCurrent();
+		for (size_t i = 0; i < population.getAgentCount(); ++i)
+		{
+			double parentScore = population.getScore(i);
+			double trialScore = trials.getScore(i);
+			if (m_trialsScreened && isBetter(trialScore, parentScore))
+				++m_surrogateStatistics.hits;
+			// NaN counts as the worst score, a diverging trial never replaces a valid parent
+			if (std::isnan(parentScore) || (!std::isnan(trialScore) && !isBetter(parentScore, trialScore)))
+				population.copyAgent(trials, i, i);
+		}
+		m_trialsTested = false;
+		m_trialsCreated = false;
+	}
+	void DifferentialEvolutionSolver::createTrials()
+	{
+		const PopulationStore::Generation& population = m_population.getCurrent();
+		PopulationStore::Generation& trials = m_trials.getCurrent();
+		const size_t agentCount = population.getAgentCount();
+		const size_t parameterCount = population.getParameterCount();
+		if (agentCount == 0 || parameterCount == 0)
+			return;
+
+		m_trialsScreened = isSurrogateScreening();
+		if (!m_trialsScreened)
+		{
+			for (size_t i = 0; i < agentCount; ++i)
+				createTrial(i);
+		}
+		else
+		{
+			// Only the candidate with the best predicted score becomes the trial
+			const RBFSurrogate& surrogate = getSurrogate();
+			const size_t poolSize = getSurrogatePoolSize();
+			for (size_t i = 0; i < agentCount; ++i)
+			{
+				double bestPrediction = 0;
+				for (size_t c = 0; c < poolSize; ++c)
+				{
+					createTrial(i);
+					double prediction = surrogate.predict(trials.getParameterRow(0) + i, agentCount);
+					if (c == 0 || isBetter(prediction, bestPrediction))
+					{
+						bestPrediction = prediction;
+						trials.getParameters(i, m_bestCandidate);
+					}
+				}
+				trials.setParameters(i, m_bestCandidate);
+			}
+			m_surrogateStatistics.candidates += agentCount * poolSize;
+			m_surrogateStatistics.evaluations += agentCount;
+		}
+		m_trialsCreated = true;
+		m_trialsTested = false;
+	}
+	void DifferentialEvolutionSolver::createTrial(size_t agent)
+	{
+		const PopulationStore::Generation& population = m_population.getCurrent();
+		PopulationStore::Generation& trials = m_trials.getCurrent();
+		const size_t agentCount = population.getAgentCount();
+		const size_t parameterCount = population.getParameterCount();
+
+		// Distinct donors need at least 4 individuals, smaller populations reuse them
+		const bool distinctDonors = agentCount >= 4;
+		size_t r1, r2, r3;
+		do { r1 = m_random.getSizeT(0, agentCount - 1); } while (distinctDonors && r1 == agent);
+		do { r2 = m_random.getSizeT(0, agentCount - 1); } while (distinctDonors && (r2 == agent || r2 == r1));
+		do { r3 = m_random.getSizeT(0, agentCount - 1); } while (distinctDonors && (r3 == agent || r3 == r1 || r3 == r2));
+
+		size_t forcedParameter = m_random.getSizeT(0, parameterCount - 1);
+		for (size_t p = 0; p < parameterCount; ++p)
+		{
+			const double* x = population.getParameterRow(p);
+			double value = x[agent];
+			if (p == forcedParameter || m_random.getDouble(0.0, 1.0) < m_crossoverPropability)
+				value = x[r1] + m_mutationFactor * (x[r2] - x[r3]);
+			trials.setParameter(agent, p, value);
+		}
+	}
+	void DifferentialEvolutionSolver::updateBestIndividuals()
+	{
+		const PopulationStore::Generation& population = m_population.getCurrent();
+		if (population.getAgentCount() == 0)
+			return;
+		size_t bestIndex = 0;
+		for (size_t i = 1; i < population.getAgentCount(); ++i)
+		{
+			if (isBetter(population.getScore(i), population.getScore(bestIndex)))
+				bestIndex = i;
+		}
+		m_lastRoundBestIndividual.fitness = population.getScore(bestIndex);
+		population.getParameters(bestIndex, m_lastRoundBestIndividual.parameters);
+
+		if (isBetter(m_lastRoundBestIndividual.fitness, m_alltimeBestIndividual.fitness))
+		{
+			m_alltimeBestIndividual = m_lastRoundBestIndividual;
+		}
+	}
+
+	void DifferentialEvolutionSolver::setMutationAmount(double amount) 
+	{ 
+		m_mutationFactor = amount;
+	}
+	double DifferentialEvolutionSolver::getMutationAmount() const 
+	{ 
+		return m_mutationFactor;
+	}
+	
+
+	void DifferentialEvolutionSolver::setScorePartsLabels(const std::vector<std::string>& labels)
+	{
+		Solver::setScorePartsLabels(labels);
+		m_scorePartCount = labels.size();
+		m_population.setScorePartCount(m_scorePartCount);
+		m_trials.setScorePartCount(m_scorePartCount);
+	}
+
+	const std::vector<double>& DifferentialEvolutionSolver::getAlltimeBestParameters() const
+	{
+		return m_alltimeBestIndividual.parameters;
+	}
+	const std::vector<double>& DifferentialEvolutionSolver::getBestParameters() const
+	{
+		return m_lastRoundBestIndividual.parameters;
+	}
+
+	void DifferentialEvolutionSolver::clearAlltimeBestParameters()
+	{
+		m_alltimeBestIndividual = Individual();
+		if (m_optimizingDirection == OptimizingDirection::Minimize)
+		{
+			m_alltimeBestIndividual.fitness = std::numeric_limits<double>::infinity();
+		}
+		else
+		{
+			m_alltimeBestIndividual.fitness = -std::numeric_limits<double>::infinity();
+		}
+		notifyReset();
+	}
+}
@@ -0,0 +1,775 @@
+#include "Solvers/GeneticSolver.h"
+#include <thread>
+#include <numeric>
+
+namespace AutoTuner
+{
+	namespace
+	{
+		// Best surrogate candidate of each child slot of the pair a thread is breeding
+		struct ScreenedCandidate
+		{
+			double prediction = 0;
+			std::vector<double> parameters;
+			std::vector<double> mutationFactors;
+		};
+		thread_local ScreenedCandidate s_bestCandidates[2];
+
+		// Parents and child a thread is breeding in steady-state mode
+		thread_local PopulationStore s_steadyStateParents;
+		thread_local PopulationStore s_steadyStateChildren;
+	}
+
+	GeneticSolver::GeneticSolver(const std::string& name)
+		: Solver(name)
+	{
+		m_islands.resize(1);
+	}
+	GeneticSolver::~GeneticSolver()
+	{
+
+	}
+
+
+	void GeneticSolver::setInitialParameters(const std::vector<std::vector<double>>& parameterList)
+	{
+		size_t parameterCount = parameterList.size() > 0 ? parameterList[0].size() : 0;
+		m_steadyState = m_steadyStateRequested;
+		setupIslands(parameterList);
+		m_agentLocks.reset();
+		m_steadyStateChildCount = 0;
+		m_steadyStateReplacementCount = 0;
+		if (m_steadyState)
+			m_agentLocks = std::make_unique<std::mutex[]>(parameterList.size());
+
+		m_bestLastRoundAgent = Agent();
+		m_alltimeBestAgent = Agent();
+
+		if (m_optimizingDirection == OptimizingDirection::Minimize)
+		{
+			m_bestLastRoundAgent.score = std::numeric_limits<double>::infinity();
+			m_alltimeBestAgent.score = std::numeric_limits<double>::infinity();
+		}
+		for (Island& island : m_islands)
+		{
+			island.bestLastRoundAgent = m_bestLastRoundAgent;
+			island.alltimeBestAgent = m_alltimeBestAgent;
+		}
+
+
+		m_tauPrime = 1.0 / std::sqrt(2.0 * std::sqrt(static_cast<double>(parameterCount)));
+		m_tau = 1.0 / std::sqrt(2.0 * static_cast<double>(parameterCount));
+	}
+
+	/*void GeneticSolver::setPopulation(const std::vector<Agent>& population)
+	{
+		m_population = population;
+		if (m_population.size() == 0)
+			return;
+		for(size_t i=0; i< m_population.size(); ++i)
+		{
+			m_population[i].mutationFactors.resize(m_population[i].parameters.size(), 0.1);
+		}
+		
+		m_tauPrime = 1.0 / std::sqrt(2.0 * std::sqrt(static_cast<double>(parameterCount)));
+		m_tau = 1.0 / std::sqrt(2.0 * static_cast<double>(parameterCount));
+	}*/
+
+
+
+	void GeneticSolver::iterate()
+	{
+		if (m_islands.size() > 1)
+		{
+			// The islands already bred in test(), only the statistics are left
+			if (m_islandAggregate.empty())
+				return;
+			const PopulationStore::Generation& aggregate = m_islandAggregate.getCurrent();
+			notifyGeneration(aggregate);
+			m_lastPopulationScores.assign(aggregate.getScores(), aggregate.getScores() + aggregate.getAgentCount());
+			m_bestLastRoundAgent = m_islands[0].bestLastRoundAgent;
+			for (const Island& island : m_islands)
+			{
+				if (isBetter(island.bestLastRoundAgent.score, m_bestLastRoundAgent.score))
+					m_bestLastRoundAgent = island.bestLastRoundAgent;
+			}
+			return;
+		}
+
+		Island& island = m_islands[0];
+		if (island.population.empty())
+			return;
+
+		if (m_steadyState)
+		{
+			// The children were inserted in test() already, only the statistics are left
+			const PopulationStore::Generation& current = island.population.getCurrent();
+			notifyGeneration(current);
+			m_lastPopulationScores.assign(current.getScores(), current.getScores() + current.getAgentCount());
+			size_t bestIndex = 0;
+			for (size_t i = 1; i < current.getAgentCount(); ++i)
+			{
+				if (isBetter(current.getScore(i), current.getScore(bestIndex)))
+					bestIndex = i;
+			}
+			island.bestLastRoundAgent = getAgent(island, bestIndex);
+			m_bestLastRoundAgent = island.bestLastRoundAgent;
+			return;
+		}
+
+		sortIsland(island);
+
+		PopulationStore::Generation& current = island.population.getCurrent();
+		const size_t agentCount = current.getAgentCount();
+		double* scores = current.getScores();
+		notifyGeneration(current);
+
+		m_lastPopulationScores.assign(scores, scores + agentCount);
+
+		prepareSelection(island, m_random);
+		m_bestLastRoundAgent = island.bestLastRoundAgent;
+
+		m_offspringScreened = isSurrogateScreening();
+		if (m_offspringScreened)
+		{
+			// A screened child is a hit if it beats the median of its parent generation
+			std::vector<double> sortedScores = m_lastPopulationScores;
+			std::nth_element(sortedScores.begin(), sortedScores.begin() + agentCount / 2, sortedScores.end());
+			m_surrogateReferenceScore = sortedScores[agentCount / 2];
+			m_surrogateStatistics.candidates += agentCount * getSurrogatePoolSize();
+			m_surrogateStatistics.evaluations += agentCount;
+		}
+
+		const size_t pairCount = (agentCount + 1) / 2;
+#ifdef GENETIC_SOLVER_USE_THREAD_POOL
+		parallelFor(pairCount, m_breedingGrainSize,
+			[this, &island](size_t begin, size_t end, size_t)
+			{
+				breedPairs(island, begin, end);
+			});
+#else
+		breedPairs(island, 0, pairCount);
+#endif
+		++island.generation;
+
+		island.population.swapGenerations();
+	}
+	void GeneticSolver::prepareSelection(Island& island, RandomStream& random)
+	{
+		PopulationStore::Generation& current = island.population.getCurrent();
+		const size_t agentCount = current.getAgentCount();
+		double* scores = current.getScores();
+		double sumScores = 0.0;
+
+		switch (m_optimizingDirection)
+		{
+			case OptimizingDirection::Minimize:
+			{
+				double maxLoss = -std::numeric_limits<double>::infinity();
+				double minLoss = -maxLoss;
+				size_t bestIndex = 0;
+				for (size_t i = 0; i < agentCount; ++i)
+				{
+					maxLoss = std::max(maxLoss, scores[i]);
+					if (scores[i] < minLoss)
+					{
+						minLoss = scores[i];
+						bestIndex = i;
+					}
+				}
+				island.bestLastRoundAgent = getAgent(island, bestIndex);
+				double scoreOffest = 0;
+				if (minLoss < 0)
+				{
+					// Move all scores into positive range
+					scoreOffest = -minLoss;
+					maxLoss -= minLoss;
+				}
+
+				// Invert scores for minimization
+				for (size_t i = 0; i < agentCount; ++i)
+				{
+					scores[i] = maxLoss - (scores[i] + scoreOffest) + m_minimizingStaticOffset;
+					sumScores += scores[i];
+				}
+
+				
+				break;
+			}
+			case  OptimizingDirection::Maximize:
+			{
+				size_t bestIndex = 0;
+				double bestScore = -std::numeric_limits<double>::infinity();
+				for (size_t i = 0; i < agentCount; ++i)
+				{
+					sumScores += scores[i];
+
+					if (scores[i] > bestScore)
+					{
+						bestScore = scores[i];
+						bestIndex = i;
+					}
+				}
+				island.bestLastRoundAgent = getAgent(island, bestIndex);
+				break;
+			}
+		}
+
+		
+
+		island.globalNoise = m_tauPrime * random.getDouble(-1, 1);
+		const size_t pairCount = (agentCount + 1) / 2;
+		island.selectionTable.setMethod(m_selectionMethod);
+		island.selectionTable.setTournamentSize(m_tournamentSize);
+		island.selectionTable.build(scores, agentCount, pairCount * 2, random);
+	}
+	void GeneticSolver::breedPairs(Island& island, size_t begin, size_t end)
+	{
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_3);
+		const size_t agentCount = island.population.getAgentCount();
+		// Island 0 uses the same streams as a single population
+		const uint32_t islandStreamBits = static_cast<uint32_t>(island.index) << 20;
+		const size_t candidateCount = m_offspringScreened ? getSurrogatePoolSize() : 1;
+		for (size_t pair = begin; pair < end; ++pair)
+		{
+			// Each pair has its own stream, so the result does not depend on how the pairs are split over the threads
+			RandomStream random = createRandomStream(static_cast<uint32_t>(island.generation), islandStreamBits | static_cast<uint32_t>(pair + 1));
+
+			// For odd population sizes the last pair only has room for one child
+			size_t offspring1 = pair * 2;
+			size_t offspring2 = std::min(offspring1 + 1, agentCount - 1);
+
+			for (size_t candidate = 0; candidate < candidateCount; ++candidate)
+			{
+				auto [parent1, parent2] = selectParents(island, pair, random);
+				crossover(island.population.getCurrent(), parent1, parent2, island.population.getNext(), offspring1, offspring2, random);
+				mutate(island.population.getNext(), offspring1, island.globalNoise, random);
+				if (offspring2 != offspring1)
+					mutate(island.population.getNext(), offspring2, island.globalNoise, random);
+				if (candidateCount > 1)
+					keepBestCandidates(island, offspring1, offspring2, candidate);
+			}
+			if (candidateCount > 1)
+				restoreBestCandidates(island, offspring1, offspring2);
+		}
+	}
+	void GeneticSolver::keepBestCandidates(Island& island, size_t offspring1, size_t offspring2, size_t candidate)
+	{
+		const PopulationStore::Generation& next = island.population.getNext();
+		const size_t agentCount = next.getAgentCount();
+		const size_t offsprings[2] = { offspring1, offspring2 };
+		for (size_t c = 0; c < 2; ++c)
+		{
+			// Each child slot keeps the candidate with the best predicted score on its own
+			double prediction = getSurrogate().predict(next.getParameterRow(0) + offsprings[c], agentCount);
+			ScreenedCandidate& best = s_bestCandidates[c];
+			if (candidate == 0 || isBetter(prediction, best.prediction))
+			{
+				best.prediction = prediction;
+				next.getParameters(offsprings[c], best.parameters);
+				next.getMutationFactors(offsprings[c], best.mutationFactors);
+			}
+		}
+	}
+	void GeneticSolver::restoreBestCandidates(Island& island, size_t offspring1, size_t offspring2)
+	{
+		PopulationStore::Generation& next = island.population.getNext();
+		const size_t offsprings[2] = { offspring1, offspring2 };
+		for (size_t c = 0; c < 2; ++c)
+		{
+			const ScreenedCandidate& best = s_bestCandidates[c];
+			next.setParameters(offsprings[c], best.parameters);
+			for (size_t p = 0; p < best.mutationFactors.size(); ++p)
+				next.setMutationFactor(offsprings[c], p, best.mutationFactors[p]);
+		}
+	}
+
+	void GeneticSolver::test()
+	{
+		if (!hasTestFunc() || m_islands[0].population.empty())
+			return;
+
+		if (m_islands.size() > 1)
+		{
+			m_threadsBusy = true;
+			const size_t step = m_islandStep++;
+			// One task per island, an island never waits for another one during the step
+			parallelFor(m_islands.size(), 1,
+				[this, step](size_t begin, size_t end, size_t)
+				{
+					for (size_t i = begin; i < end; ++i)
+						runIslandStep(m_islands[i], step);
+				});
+			m_threadsBusy = false;
+
+			for (const Island& island : m_islands)
+			{
+				if (isBetter(island.alltimeBestAgent.score, m_alltimeBestAgent.score))
+					m_alltimeBestAgent = island.alltimeBestAgent;
+			}
+			aggregateIslands();
+			updateRacingThreshold(m_islandAggregate.getCurrent());
+			return;
+		}
+
+		Island& island = m_islands[0];
+		if (m_steadyState && island.tested)
+		{
+			runSteadyState(island);
+			return;
+		}
+		island.tested = true;
+		m_threadsBusy = true;
+#ifdef GENETIC_SOLVER_USE_THREAD_POOL
+		testGeneration(island.population.getCurrent());
+#else
+		testAgents(island.population.getCurrent(), 0, island.population.getAgentCount());
+#endif
+		m_threadsBusy = false;
+		updateRacingThreshold(island.population.getCurrent());
+
+		const PopulationStore::Generation& tested = island.population.getCurrent();
+		if (m_offspringScreened)
+		{
+			for (size_t i = 0; i < tested.getAgentCount(); ++i)
+			{
+				if (isBetter(tested.getScore(i), m_surrogateReferenceScore))
+					++m_surrogateStatistics.hits;
+			}
+			m_offspringScreened = false;
+		}
+		trainSurrogate(tested);
+
+		updateAlltimeBest(island);
+		m_alltimeBestAgent = island.alltimeBestAgent;
+	}
+	void GeneticSolver::updateAlltimeBest(Island& island)
+	{
+		const PopulationStore::Generation& current = island.population.getCurrent();
+		size_t bestIndex = current.getAgentCount();
+		double bestScore = island.alltimeBestAgent.score;
+		for (size_t i = 0; i < current.getAgentCount(); ++i)
+		{
+			double score = current.getScore(i);
+			if ((m_optimizingDirection == OptimizingDirection::Maximize && score > bestScore) ||
+				(m_optimizingDirection == OptimizingDirection::Minimize && score < bestScore))
+			{
+				bestScore = score;
+				bestIndex = i;
+			}
+		}
+		if (bestIndex < current.getAgentCount())
+			island.alltimeBestAgent = getAgent(island, bestIndex);
+	}
+
+	GeneticSolver::Agent GeneticSolver::getAgent(const Island& island, size_t index) const
+	{
+		const PopulationStore::Generation& current = island.population.getCurrent();
+		Agent agent;
+		agent.score = current.getScore(index);
+		current.getParameters(index, agent.parameters);
+		current.getMutationFactors(index, agent.mutationFactors);
+		current.getScoreParts(index, agent.scoreParts);
+		return agent;
+	}
+
+	void GeneticSolver::sortPopulation()
+	{
+		for (Island& island : m_islands)
+			sortIsland(island);
+	}
+	void GeneticSolver::sortIsland(Island& island)
+	{
+		const PopulationStore::Generation& current = island.population.getCurrent();
+		const double* scores = current.getScores();
+		island.sortOrder.resize(current.getAgentCount());
+		std::iota(island.sortOrder.begin(), island.sortOrder.end(), 0);
+		std::sort(island.sortOrder.begin(), island.sortOrder.end(),
+			[scores](size_t a, size_t b)
+			{
+				return scores[a] > scores[b];
+			});
+		island.population.getNext().gather(current, island.sortOrder);
+		island.population.swapGenerations();
+	}
+	std::pair<size_t, size_t> GeneticSolver::selectParents(const Island& island, size_t pair, RandomStream& random) const
+	{
+		size_t parent1 = island.selectionTable.draw(pair * 2, random);
+		size_t parent2 = parent1;
+		// Find a second parent, different from the first one if possible
+		for (size_t tryCount = 0; tryCount <= m_maxSelectionTryCount && parent2 == parent1; ++tryCount)
+			parent2 = island.selectionTable.draw(pair * 2 + 1, random, tryCount);
+		return { parent1, parent2 };
+	}
+	void GeneticSolver::mutate(PopulationStore::Generation& offsprings, size_t offspring, double globalNoise, RandomStream& random)
+	{
+		for (size_t i=0; i<offsprings.getParameterCount(); ++i)
+		{
+			double mutationFactor = m_mutationAmount;
+			if (m_useAdaptiveMutation)
+			{
+				mutationFactor = offsprings.getMutationFactor(offspring, i);
+				mutationFactor *= std::exp(globalNoise + m_tau * random.getDouble(-1, 1));
+				offsprings.setMutationFactor(offspring, i, mutationFactor);
+			}
+
+			double randVal = random.getDouble(0.0, 1.0);
+			if (randVal < m_mutationPropability)
+			{
+				double parameter = offsprings.getParameter(offspring, i);
+				double mutation = random.getDouble(-1,1) * mutationFactor;
+#ifdef GENETIC_SOLVER_USE_INDIVIDUAL_PARAMETER_MUTATION_RATE
+				mutation *= std::abs(parameter+0.1);
+#endif
+				offsprings.setParameter(offspring, i, parameter + mutation);
+			}
+		}
+	}
+	void GeneticSolver::crossover(const PopulationStore::Generation& current, size_t parent1, size_t parent2,
+		PopulationStore::Generation& next, size_t offspring1, size_t offspring2, RandomStream& random)
+	{
+		size_t paramCount = current.getParameterCount();
+		size_t crossoverPoint = paramCount > 1 ? random.getSizeT(1, paramCount - 1) : 0;
+
+		for (size_t p = 0; p < paramCount; ++p)
+		{
+			const double* parents = current.getParameterRow(p);
+			double* offsprings = next.getParameterRow(p);
+			if (p < crossoverPoint)
+			{
+				offsprings[offspring1] = parents[parent1];
+				offsprings[offspring2] = parents[parent2];
+			}
+			else
+			{
+				offsprings[offspring1] = parents[parent2];
+				offsprings[offspring2] = parents[parent1];
+			}
+		}
+
+		if (m_useAdaptiveMutation)
+		{
+			for (size_t p = 0; p < paramCount; ++p)
+			{
+				const double* parents = current.getMutationFactorRow(p);
+				double* offsprings = next.getMutationFactorRow(p);
+				if (p < crossoverPoint)
+				{
+					offsprings[offspring1] = parents[parent1];
+					offsprings[offspring2] = parents[parent2];
+				}
+				else
+				{
+					offsprings[offspring1] = parents[parent2];
+					offsprings[offspring2] = parents[parent1];
+				}
+			}
+		}
+	}
+
+	void GeneticSolver::setupIslands(const std::vector<std::vector<double>>& parameterList)
+	{
+		const size_t agentCount = parameterList.size();
+		const size_t parameterCount = agentCount > 0 ? parameterList[0].size() : 0;
+		const size_t islandCount = m_steadyState ? 1 : std::clamp<size_t>(m_requestedIslandCount, 1, std::max<size_t>(1, agentCount / 2));
+
+		m_migrationQueues.clear();
+		m_islands.clear();
+		m_islands.resize(islandCount);
+		m_islandStep = 0;
+		m_migrationCount = 0;
+		for (size_t i = 0; i < islandCount; ++i)
+		{
+			Island& island = m_islands[i];
+			const size_t begin = i * agentCount / islandCount;
+			const size_t end = (i + 1) * agentCount / islandCount;
+			island.index = i;
+			island.agentOffset = begin;
+			island.random = createRandomStream(s_islandStream, static_cast<uint32_t>(i));
+			island.population.resize(end - begin, parameterCount, m_scorePartCount);
+			PopulationStore::Generation& generation = island.population.getCurrent();
+			for (size_t a = begin; a < end; ++a)
+			{
+				generation.setParameters(a - begin, parameterList[a]);
+				for (size_t p = 0; p < parameterCount; ++p)
+					generation.setMutationFactor(a - begin, p, 0.1);
+			}
+		}
+
+		if (islandCount == 1)
+		{
+			m_islandAggregate.resize(0, 0, m_scorePartCount);
+			return;
+		}
+		m_islandAggregate.resize(agentCount, parameterCount, m_scorePartCount);
+		if (m_migrationInterval == 0 || m_migrantCount == 0)
+			return;
+
+		// A queue holds the migrants of the last step and of the running one
+		const size_t sendsPerStep = (m_islandGenerationsPerStep + m_migrationInterval - 1) / m_migrationInterval;
+		const size_t queueCapacity = 2 * sendsPerStep * m_migrantCount;
+		for (size_t i = 0; i < islandCount; ++i)
+		{
+			std::vector<size_t> targets;
+			switch (m_islandTopology)
+			{
+				case IslandTopology::Ring:
+					targets.push_back((i + 1) % islandCount);
+					break;
+				case IslandTopology::BidirectionalRing:
+					targets.push_back((i + 1) % islandCount);
+					if (islandCount > 2)
+						targets.push_back((i + islandCount - 1) % islandCount);
+					break;
+				case IslandTopology::FullyConnected:
+					for (size_t t = 0; t < islandCount; ++t)
+						if (t != i)
+							targets.push_back(t);
+					break;
+			}
+			for (size_t target : targets)
+			{
+				m_migrationQueues.push_back(std::make_unique<MigrantQueue>(queueCapacity));
+				m_islands[i].outbound.push_back(m_migrationQueues.back().get());
+				m_islands[target].inbound.push_back(m_migrationQueues.back().get());
+			}
+		}
+	}
+	void GeneticSolver::runIslandStep(Island& island, size_t step)
+	{
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_2);
+		receiveMigrants(island, step);
+		const size_t pairCount = (island.population.getAgentCount() + 1) / 2;
+		for (size_t g = 0; g < m_islandGenerationsPerStep; ++g)
+		{
+			if (island.tested)
+			{
+				insertMigrants(island);
+				if (m_migrationInterval > 0 && (island.generation + 1) % m_migrationInterval == 0)
+					sendMigrants(island, step);
+
+				sortIsland(island);
+				prepareSelection(island, island.random);
+				breedPairs(island, 0, pairCount);
+				++island.generation;
+				island.population.swapGenerations();
+			}
+
+			PopulationStore::Generation& current = island.population.getCurrent();
+			testAgents(current, 0, current.getAgentCount(), island.agentOffset);
+			island.tested = true;
+
+			updateAlltimeBest(island);
+			size_t bestIndex = 0;
+			for (size_t i = 1; i < current.getAgentCount(); ++i)
+			{
+				if (isBetter(current.getScore(i), current.getScore(bestIndex)))
+					bestIndex = i;
+			}
+			island.bestLastRoundAgent = getAgent(island, bestIndex);
+		}
+	}
+	void GeneticSolver::receiveMigrants(Island& island, size_t step)
+	{
+		for (MigrantQueue* queue : island.inbound)
+		{
+			// Migrants of the running step stay queued until the next step, their arrival would depend on the timing
+			while (Migrant* migrant = queue->front())
+			{
+				if (migrant->step >= step)
+					break;
+				island.arrivedMigrants.push_back(std::move(migrant->agent));
+				queue->pop();
+			}
+		}
+	}
+	void GeneticSolver::insertMigrants(Island& island)
+	{
+		if (island.arrivedMigrants.empty())
+			return;
+		PopulationStore::Generation& current = island.population.getCurrent();
+		const size_t agentCount = current.getAgentCount();
+		const double* scores = current.getScores();
+
+		// The migrants replace the worst agents, the best agent of the island always stays
+		const size_t count = std::min(island.arrivedMigrants.size(), agentCount - 1);
+		island.sortOrder.resize(agentCount);
+		std::iota(island.sortOrder.begin(), island.sortOrder.end(), 0);
+		std::partial_sort(island.sortOrder.begin(), island.sortOrder.begin() + count, island.sortOrder.end(),
+			[this, scores](size_t a, size_t b)
+			{
+				if (std::isnan(scores[a]))
+					return !std::isnan(scores[b]);
+				if (std::isnan(scores[b]))
+					return false;
+				return isBetter(scores[b], scores[a]);
+			});
+
+		for (size_t m = 0; m < count; ++m)
+		{
+			const Agent& migrant = island.arrivedMigrants[m];
+			const size_t target = island.sortOrder[m];
+			current.setParameters(target, migrant.parameters);
+			for (size_t p = 0; p < migrant.mutationFactors.size(); ++p)
+				current.setMutationFactor(target, p, migrant.mutationFactors[p]);
+			if (migrant.scoreParts.size() == current.getScorePartCount())
+				current.setScoreParts(target, migrant.scoreParts);
+			current.setScore(target, migrant.score);
+		}
+		m_migrationCount += count;
+		island.arrivedMigrants.clear();
+	}
+	void GeneticSolver::sendMigrants(Island& island, size_t step)
+	{
+		if (island.outbound.empty() || m_migrantCount == 0)
+			return;
+		const PopulationStore::Generation& current = island.population.getCurrent();
+		const size_t agentCount = current.getAgentCount();
+		const double* scores = current.getScores();
+
+		const size_t count = std::min(m_migrantCount, agentCount);
+		island.sortOrder.resize(agentCount);
+		std::iota(island.sortOrder.begin(), island.sortOrder.end(), 0);
+		std::partial_sort(island.sortOrder.begin(), island.sortOrder.begin() + count, island.sortOrder.end(),
+			[this, scores](size_t a, size_t b)
+			{
+				if (std::isnan(scores[b]))
+					return !std::isnan(scores[a]);
+				if (std::isnan(scores[a]))
+					return false;
+				return isBetter(scores[a], scores[b]);
+			});
+
+		for (size_t m = 0; m < count; ++m)
+		{
+			Agent agent = getAgent(island, island.sortOrder[m]);
+			// The queues are sized for the migrants of two steps, a full queue drops the migrant
+			for (MigrantQueue* queue : island.outbound)
+				queue->push({ agent, step });
+		}
+	}
+	void GeneticSolver::aggregateIslands()
+	{
+		PopulationStore::Generation& aggregate = m_islandAggregate.getCurrent();
+		for (const Island& island : m_islands)
+		{
+			const PopulationStore::Generation& current = island.population.getCurrent();
+			for (size_t i = 0; i < current.getAgentCount(); ++i)
+				aggregate.copyAgent(current, i, island.agentOffset + i);
+		}
+	}
+
+	void GeneticSolver::runSteadyState(Island& island)
+	{
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_2);
+		const size_t agentCount = island.population.getAgentCount();
+		const size_t evaluations = m_steadyStateEvaluationsPerStep > 0 ? m_steadyStateEvaluationsPerStep : agentCount;
+		const size_t endChild = m_steadyStateChildCount.load() + evaluations;
+
+		// Each task tests its children with the agent index of the task,
+		// so a test function can keep per agent state without two workers sharing it
+		const size_t taskCount = std::clamp<size_t>(getConcurrency(), 1, agentCount);
+		m_threadsBusy = true;
+		parallelFor(taskCount, 1,
+			[this, &island, endChild](size_t begin, size_t end, size_t)
+			{
+				for (size_t task = begin; task < end; ++task)
+				{
+					// A worker breeds the next child as soon as its last one is inserted, nobody waits for the slowest evaluation
+					for (size_t child = m_steadyStateChildCount.fetch_add(1); child < endChild; child = m_steadyStateChildCount.fetch_add(1))
+						breedSteadyState(island, child, task);
+				}
+			});
+		m_threadsBusy = false;
+		// Every task overshoots the counter once when it runs out of children
+		m_steadyStateChildCount = endChild;
+
+		const PopulationStore::Generation& current = island.population.getCurrent();
+		updateRacingThreshold(current);
+		updateAlltimeBest(island);
+		m_alltimeBestAgent = island.alltimeBestAgent;
+	}
+	void GeneticSolver::breedSteadyState(Island& island, size_t child, size_t task)
+	{
+		PopulationStore::Generation& population = island.population.getCurrent();
+		const size_t parameterCount = population.getParameterCount();
+		const size_t scorePartCount = population.getScorePartCount();
+		if (s_steadyStateParents.getAgentCount() != 2 ||
+			s_steadyStateParents.getParameterCount() != parameterCount ||
+			s_steadyStateParents.getScorePartCount() != scorePartCount)
+		{
+			s_steadyStateParents.resize(2, parameterCount, scorePartCount);
+			s_steadyStateChildren.resize(1, parameterCount, scorePartCount);
+		}
+		PopulationStore::Generation& parents = s_steadyStateParents.getCurrent();
+		PopulationStore::Generation& children = s_steadyStateChildren.getCurrent();
+
+		// The child index only decides the stream, the selected parents depend on the timing anyway
+		RandomStream random = createRandomStream(s_steadyStateStream, static_cast<uint32_t>(child));
+
+		size_t parent1 = drawSteadyStateTournament(population, false, random);
+		size_t parent2 = parent1;
+		for (size_t tryCount = 0; tryCount <= m_maxSelectionTryCount && parent2 == parent1; ++tryCount)
+			parent2 = drawSteadyStateTournament(population, false, random);
+		{
+			std::lock_guard<std::mutex> lock(m_agentLocks[parent1]);
+			parents.copyAgent(population, parent1, 0);
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_agentLocks[parent2]);
+			parents.copyAgent(population, parent2, 1);
+		}
+
+		// Only one child per evaluation, a second one would double the time until the worker takes new parents
+		const double globalNoise = m_tauPrime * random.getDouble(-1, 1);
+		crossover(parents, 0, 1, children, 0, 0, random);
+		mutate(children, 0, globalNoise, random);
+		testAgents(children, 0, 1, task);
+
+		if (insertSteadyStateChild(population, children, 0, random))
+			++m_steadyStateReplacementCount;
+	}
+	size_t GeneticSolver::drawSteadyStateTournament(const PopulationStore::Generation& population, bool worst, RandomStream& random) const
+	{
+		const size_t agentCount = population.getAgentCount();
+		size_t selected = random.getSizeT(0, agentCount - 1);
+		double selectedScore;
+		{
+			std::lock_guard<std::mutex> lock(m_agentLocks[selected]);
+			selectedScore = population.getScore(selected);
+		}
+		for (size_t i = 1; i < m_tournamentSize; ++i)
+		{
+			size_t candidate = random.getSizeT(0, agentCount - 1);
+			double score;
+			{
+				std::lock_guard<std::mutex> lock(m_agentLocks[candidate]);
+				score = population.getScore(candidate);
+			}
+			// NaN scores lose every tournament
+			bool candidateWins = worst ? (std::isnan(score) || isBetter(selectedScore, score))
+				: (std::isnan(selectedScore) || isBetter(score, selectedScore));
+			if (candidateWins)
+			{
+				selected = candidate;
+				selectedScore = score;
+			}
+		}
+		return selected;
+	}
+	bool GeneticSolver::insertSteadyStateChild(PopulationStore::Generation& population, const PopulationStore::Generation& children, size_t child, RandomStream& random)
+	{
+		const double score = children.getScore(child);
+		if (std::isnan(score))
+			return false;
+		const size_t loser = drawSteadyStateTournament(population, true, random);
+
+		// Another worker may have replaced the loser since the tournament, the comparison is repeated under the lock
+		std::lock_guard<std::mutex> lock(m_agentLocks[loser]);
+		const double loserScore = population.getScore(loser);
+		if (!std::isnan(loserScore) && !isBetter(score, loserScore))
+			return false;
+		population.copyAgent(children, child, loser);
+		return true;
+	}
+}
@@ -0,0 +1,444 @@
+#include "Solvers/NSGA2Solver.h"
+#include "Solvers/SolverSnapshot.h"
+
+namespace AutoTuner
+{
+	namespace
+	{
+		/**
+		 * @return 1 if agent a dominates agent b, -1 if b dominates a, 0 otherwise
+		 */
+		inline int compareDomination(const double* objectives, size_t objectiveCount, size_t stride, size_t a, size_t b)
+		{
+			bool aBetter = false;
+			bool bBetter = false;
+			for (size_t k = 0; k < objectiveCount; ++k)
+			{
+				const double* row = objectives + k * stride;
+				if (row[a] < row[b])
+					aBetter = true;
+				else if (row[b] < row[a])
+					bBetter = true;
+				if (aBetter && bBetter)
+					return 0;
+			}
+			if (aBetter)
+				return 1;
+			if (bBetter)
+				return -1;
+			return 0;
+		}
+	}
+
+	NSGA2Solver::NSGA2Solver()
+		: Solver("NSGA2Solver")
+	{
+	}
+	NSGA2Solver::~NSGA2Solver()
+	{
+	}
+
+
+	void NSGA2Solver::setInitialParameters(const std::vector<std::vector<double>>& parameterList)
+	{
+		size_t parameterCount = parameterList.size() > 0 ? parameterList[0].size() : 0;
+		m_population.resize(parameterList.size(), parameterCount, m_scorePartCount);
+		m_offspring.resize(parameterList.size(), parameterCount, m_scorePartCount);
+		for (size_t i = 0; i < parameterList.size(); ++i)
+		{
+			m_population.getCurrent().setParameters(i, parameterList[i]);
+		}
+		m_parentRank.assign(parameterList.size(), 0);
+		m_parentCrowding.assign(parameterList.size(), 0.0);
+		m_populationTested = false;
+		m_offspringCreated = false;
+		m_offspringTested = false;
+		m_parentsRanked = false;
+		m_generation = 0;
+		resetRacingThreshold();
+
+		m_paretoFront.clear();
+		m_lastRoundBestIndividual = Individual();
+		clearAlltimeBestParameters();
+	}
+
+
+	void NSGA2Solver::iterate()
+	{
+		if (!m_populationTested)
+			return;
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_3);
+
+		if (m_offspringTested)
+			selectSurvivors();
+		else if (!m_parentsRanked)
+			rankParents();
+
+		const PopulationStore::Generation& population = m_population.getCurrent();
+		updateBestIndividuals();
+		updateParetoFront();
+		notifyGeneration(population);
+
+		createOffspring();
+		++m_generation;
+	}
+	void NSGA2Solver::test()
+	{
+		if (!hasTestFunc() || m_population.empty())
+			return;
+
+		if (!m_populationTested)
+		{
+			testGeneration(m_population.getCurrent());
+			m_populationTested = true;
+		}
+		else if (m_offspringCreated && !m_offspringTested)
+		{
+			testGeneration(m_offspring.getCurrent());
+			m_offspringTested = true;
+		}
+	}
+
+	void NSGA2Solver::loadObjectives(const PopulationStore::Generation& generation, size_t offset)
+	{
+		const size_t agentCount = generation.getAgentCount();
+		const double sign = m_optimizingDirection == OptimizingDirection::Minimize ? 1.0 : -1.0;
+		for (size_t k = 0; k < m_objectiveCount; ++k)
+		{
+			// Without score parts, or with an unknown part, the summed score is the objective
+			const double* values = generation.getScores();
+			size_t part = m_objectiveScoreParts.empty() ? k : m_objectiveScoreParts[k];
+			if (part < generation.getScorePartCount())
+				values = generation.getScorePartRow(part);
+			double* row = m_objectives.data() + k * m_objectiveStride + offset;
+			for (size_t i = 0; i < agentCount; ++i)
+			{
+				// A NaN objective ranks behind every real value
+				double value = sign * values[i];
+				row[i] = std::isnan(value) ? std::numeric_limits<double>::infinity() : value;
+			}
+		}
+	}
+	void NSGA2Solver::sortNonDominated(size_t count)
+	{
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_4);
+		m_dominationCount.assign(count, 0);
+		if (m_dominatedAgents.size() < count)
+			m_dominatedAgents.resize(count);
+		m_rank.assign(count, 0);
+
+		// Each agent compares itself against all others, so the rows are independent
+		parallelFor(count, 0,
+			[this, count](size_t begin, size_t end, size_t)
+			{
+				const double* objectives = m_objectives.data();
+				for (size_t i = begin; i < end; ++i)
+				{
+					std::vector<size_t>& dominated = m_dominatedAgents[i];
+					dominated.clear();
+					size_t dominatedBy = 0;
+					for (size_t j = 0; j < count; ++j)
+					{
+						if (i == j)
+							continue;
+						int comparison = compareDomination(objectives, m_objectiveCount, m_objectiveStride, i, j);
+						if (comparison > 0)
+							dominated.push_back(j);
+						else if (comparison < 0)
+							++dominatedBy;
+					}
+					m_dominationCount[i] = dominatedBy;
+				}
+			});
+
+		m_fronts.clear();
+		std::vector<size_t> front;
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (m_dominationCount[i] == 0)
+				front.push_back(i);
+		}
+		size_t rank = 0;
+		while (!front.empty())
+		{
+			std::vector<size_t> nextFront;
+			for (size_t p : front)
+			{
+				m_rank[p] = rank;
+				for (size_t q : m_dominatedAgents[p])
+				{
+					if (--m_dominationCount[q] == 0)
+						nextFront.push_back(q);
+				}
+			}
+			m_fronts.push_back(std::move(front));
+			front = std::move(nextFront);
+			++rank;
+		}
+	}
+	void NSGA2Solver::computeCrowdingDistances(size_t count)
+	{
+		m_crowding.assign(count, 0.0);
+		parallelFor(m_fronts.size(), 1,
+			[this](size_t begin, size_t end, size_t)
+			{
+				thread_local std::vector<size_t> order;
+				for (size_t f = begin; f < end; ++f)
+				{
+					const std::vector<size_t>& front = m_fronts[f];
+					if (front.size() <= 2)
+					{
+						for (size_t i : front)
+							m_crowding[i] = std::numeric_limits<double>::infinity();
+						continue;
+					}
+					for (size_t k = 0; k < m_objectiveCount; ++k)
+					{
+						const double* row = m_objectives.data() + k * m_objectiveStride;
+						order = front;
+						std::sort(order.begin(), order.end(),
+							[row](size_t a, size_t b)
+							{
+								if (row[a] != row[b])
+									return row[a] < row[b];
+								return a < b;
+							});
+						m_crowding[order.front()] = std::numeric_limits<double>::infinity();
+						m_crowding[order.back()] = std::numeric_limits<double>::infinity();
+						double range = row[order.back()] - row[order.front()];
+						if (!(range > 0) || std::isinf(range))
+							continue;
+						for (size_t i = 1; i + 1 < order.size(); ++i)
+							m_crowding[order[i]] += (row[order[i + 1]] - row[order[i - 1]]) / range;
+					}
+				}
+			});
+	}
+	void NSGA2Solver::rankParents()
+	{
+		const PopulationStore::Generation& population = m_population.getCurrent();
+		const size_t agentCount = population.getAgentCount();
+		m_objectiveCount = m_objectiveScoreParts.empty() ? std::max<size_t>(population.getScorePartCount(), 1) : m_objectiveScoreParts.size();
+		m_objectiveStride = agentCount;
+		m_objectives.resize(m_objectiveCount * m_objectiveStride);
+		loadObjectives(population, 0);
+		sortNonDominated(agentCount);
+		computeCrowdingDistances(agentCount);
+		m_parentRank.assign(m_rank.begin(), m_rank.end());
+		m_parentCrowding.assign(m_crowding.begin(), m_crowding.end());
+		m_parentsRanked = true;
+	}
+	void NSGA2Solver::selectSurvivors()
+	{
+		const PopulationStore::Generation& parents = m_population.getCurrent();
+		const PopulationStore::Generation& offspring = m_offspring.getCurrent();
+		const size_t agentCount = parents.getAgentCount();
+		m_objectiveCount = m_objectiveScoreParts.empty() ? std::max<size_t>(parents.getScorePartCount(), 1) : m_objectiveScoreParts.size();
+		m_objectiveStride = 2 * agentCount;
+		m_objectives.resize(m_objectiveCount * m_objectiveStride);
+		loadObjectives(parents, 0);
+		loadObjectives(offspring, agentCount);
+		sortNonDominated(m_objectiveStride);
+		computeCrowdingDistances(m_objectiveStride);
+
+		// Whole fronts as long as they fit, the front that doesn't fit gets cut by crowding distance
+		m_survivors.clear();
+		for (std::vector<size_t>& front : m_fronts)
+		{
+			if (m_survivors.size() + front.size() <= agentCount)
+			{
+				m_survivors.insert(m_survivors.end(), front.begin(), front.end());
+				if (m_survivors.size() == agentCount)
+					break;
+				continue;
+			}
+			std::stable_sort(front.begin(), front.end(),
+				[this](size_t a, size_t b) { return m_crowding[a] > m_crowding[b]; });
+			m_survivors.insert(m_survivors.end(), front.begin(), front.begin() + (agentCount - m_survivors.size()));
+			break;
+		}
+
+		PopulationStore::Generation& next = m_population.getNext();
+		for (size_t i = 0; i < agentCount; ++i)
+		{
+			size_t source = m_survivors[i];
+			if (source < agentCount)
+				next.copyAgent(parents, source, i);
+			else
+				next.copyAgent(offspring, source - agentCount, i);
+			m_parentRank[i] = m_rank[source];
+			m_parentCrowding[i] = m_crowding[source];
+		}
+		m_population.swapGenerations();
+		m_parentsRanked = true;
+		m_offspringCreated = false;
+		m_offspringTested = false;
+	}
+	void NSGA2Solver::createOffspring()
+	{
+		const PopulationStore::Generation& parents = m_population.getCurrent();
+		const size_t agentCount = parents.getAgentCount();
+		const size_t parameterCount = parents.getParameterCount();
+		if (agentCount == 0 || parameterCount == 0)
+			return;
+
+		const size_t pairCount = (agentCount + 1) / 2;
+		const double mutationPropability = m_mutationPropability > 0 ? m_mutationPropability : 1.0 / static_cast<double>(parameterCount);
+		const double exponent = 1.0 / (m_crossoverDistributionIndex + 1.0);
+		const uint32_t generation = static_cast<uint32_t>(m_generation);
+
+		// Each pair has its own random stream, so the offspring don't depend on the thread count
+		parallelFor(pairCount, 0,
+			[this, &parents, agentCount, parameterCount, mutationPropability, exponent, generation](size_t begin, size_t end, size_t)
+			{
+				PopulationStore::Generation& offspring = m_offspring.getCurrent();
+				for (size_t pair = begin; pair < end; ++pair)
+				{
+					RandomStream random = createRandomStream(generation, static_cast<uint32_t>(pair + 1));
+					size_t parent1 = selectParent(random);
+					size_t parent2 = selectParent(random);
+					size_t child1 = 2 * pair;
+					size_t child2 = std::min(child1 + 1, agentCount - 1);
+					bool crossover = random.nextDouble() < m_crossoverPropability;
+					for (size_t p = 0; p < parameterCount; ++p)
+					{
+						const double* x = parents.getParameterRow(p);
+						double value1 = x[parent1];
+						double value2 = x[parent2];
+						if (crossover && random.nextDouble() < 0.5)
+						{
+							// Simulated binary crossover, the children spread around the parents like one point crossover of bit strings
+							double u = random.nextDouble();
+							double beta = u <= 0.5 ? std::pow(2.0 * u, exponent) : std::pow(1.0 / (2.0 * (1.0 - u)), exponent);
+							double mean = 0.5 * (value1 + value2);
+							double halfSpread = 0.5 * beta * (value1 - value2);
+							value1 = mean + halfSpread;
+							value2 = mean - halfSpread;
+						}
+						if (random.nextDouble() < mutationPropability)
+							value1 += random.getDouble(-1, 1) * m_mutationAmount;
+						if (random.nextDouble() < mutationPropability)
+							value2 += random.getDouble(-1, 1) * m_mutationAmount;
+						offspring.setParameter(child1, p, value1);
+						if (child2 != child1)
+							offspring.setParameter(child2, p, value2);
+					}
+				}
+			});
+		m_offspringCreated = true;
+		m_offspringTested = false;
+	}
+	size_t NSGA2Solver::selectParent(RandomStream& random) const
+	{
+		// Binary tournament, the lower rank wins, on the same rank the less crowded agent
+		const size_t agentCount = m_parentRank.size();
+		size_t a = random.getSizeT(0, agentCount - 1);
+		size_t b = random.getSizeT(0, agentCount - 1);
+		if (m_parentRank[a] != m_parentRank[b])
+			return m_parentRank[a] < m_parentRank[b] ? a : b;
+		return m_parentCrowding[b] > m_parentCrowding[a] ? b : a;
+	}
+	void NSGA2Solver::updateBestIndividuals()
+	{
+		const PopulationStore::Generation& population = m_population.getCurrent();
+		if (population.getAgentCount() == 0)
+			return;
+		size_t bestIndex = 0;
+		for (size_t i = 1; i < population.getAgentCount(); ++i)
+		{
+			if (isBetter(population.getScore(i), population.getScore(bestIndex)))
+				bestIndex = i;
+		}
+		m_lastRoundBestIndividual.fitness = population.getScore(bestIndex);
+		population.getParameters(bestIndex, m_lastRoundBestIndividual.parameters);
+
+		if (isBetter(m_lastRoundBestIndividual.fitness, m_alltimeBestIndividual.fitness))
+		{
+			m_alltimeBestIndividual = m_lastRoundBestIndividual;
+		}
+	}
+	void NSGA2Solver::updateParetoFront()
+	{
+		const PopulationStore::Generation& population = m_population.getCurrent();
+		m_paretoFront.clear();
+		for (size_t i = 0; i < population.getAgentCount(); ++i)
+		{
+			if (m_parentRank[i] != 0)
+				continue;
+			ParetoSolution solution;
+			population.getParameters(i, solution.parameters);
+			population.getScoreParts(i, solution.scoreParts);
+			solution.score = population.getScore(i);
+			m_paretoFront.push_back(std::move(solution));
+		}
+	}
+
+	std::vector<double> NSGA2Solver::getWeightedBestParameters(const std::vector<double>& weights) const
+	{
+		const ParetoSolution* best = nullptr;
+		double bestScore = 0;
+		for (const ParetoSolution& solution : m_paretoFront)
+		{
+			double score = 0;
+			size_t count = std::min(weights.size(), solution.scoreParts.size());
+			for (size_t k = 0; k < count; ++k)
+				score += weights[k] * solution.scoreParts[k];
+			if (!best || isBetter(score, bestScore))
+			{
+				best = &solution;
+				bestScore = score;
+			}
+		}
+		if (!best)
+			return {};
+		return best->parameters;
+	}
+
+	void NSGA2Solver::setMutationAmount(double amount)
+	{
+		m_mutationAmount = amount;
+	}
+	double NSGA2Solver::getMutationAmount() const
+	{
+		return m_mutationAmount;
+	}
+
+
+	void NSGA2Solver::setScorePartsLabels(const std::vector<std::string>& labels)
+	{
+		Solver::setScorePartsLabels(labels);
+		m_scorePartCount = labels.size();
+		m_population.setScorePartCount(m_scorePartCount);
+		m_offspring.setScorePartCount(m_scorePartCount);
+	}
+
+	const std::vector<double>& NSGA2Solver::getAlltimeBestParameters() const
+	{
+		return m_alltimeBestIndividual.parameters;
+	}
+	const std::vector<double>& NSGA2Solver::getBestParameters() const
+	{
+		return m_lastRoundBestIndividual.parameters;
+	}
+
+	void NSGA2Solver::clearAlltimeBestParameters()
+	{
+		m_alltimeBestIndividual = Individual();
+		if (m_optimizingDirection == OptimizingDirection::Minimize)
+		{
+			m_alltimeBestIndividual.fitness = std::numeric_limits<double>::infinity();
+		}
+		else
+		{
+			m_alltimeBestIndividual.fitness = -std::numeric_limits<double>::infinity();
+		}
+		notifyReset();
+	}
+	void NSGA2Solver::writeSnapshot(SolverSnapshot& snapshot) const
+	{
+		Solver::writeSnapshot(snapshot);
+		snapshot.paretoFrontScoreParts.resize(m_paretoFront.size());
+		for (size_t i = 0; i < m_paretoFront.size(); ++i)
+			snapshot.paretoFrontScoreParts[i] = m_paretoFront[i].scoreParts;
+	}
+}
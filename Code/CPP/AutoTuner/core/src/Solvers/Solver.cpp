@@ -0,0 +1,243 @@
+#include "Solvers/Solver.h"
+#include "Solvers/SolverSnapshot.h"
+#include "Utilities/SimdDouble.h"
+
+namespace AutoTuner
+{
+	// Aborts of the calling thread, tells testAgents() which scores are only bounds
+	static thread_local size_t t_raceLostCount = 0;
+
+	Solver::Solver(const std::string& name)
+		: m_name(name)
+	{
+
+	}
+
+	size_t Solver::run(size_t epochCount, const std::function<bool(size_t)>& callback)
+	{
+		for (size_t epoch = 0; epoch < epochCount; ++epoch)
+		{
+			test();
+			iterate();
+			if (callback && !callback(epoch))
+				return epoch + 1;
+		}
+		return epochCount;
+	}
+
+	void Solver::writeSnapshot(SolverSnapshot& snapshot) const
+	{
+		snapshot.scorePartsLabels = m_scorePartsLabels;
+		snapshot.bestParameters = getBestParameters();
+		snapshot.alltimeBestParameters = getAlltimeBestParameters();
+		snapshot.surrogateStatistics = m_surrogateStatistics;
+
+		snapshot.stepSize = getStepSize();
+
+		// A pooled snapshot may still hold the values of another solver type
+		snapshot.paretoFrontScoreParts.clear();
+	}
+
+	void Solver::setRacingEnabled(bool enabled)
+	{
+		m_racingEnabled = enabled;
+		if (!enabled)
+			m_racingThreshold.store(std::numeric_limits<double>::infinity());
+	}
+
+	bool Solver::isRaceLost(double partialScore) const
+	{
+		if (partialScore <= m_racingThreshold.load(std::memory_order_relaxed))
+			return false;
+		m_racingAbortCount.fetch_add(1, std::memory_order_relaxed);
+		++t_raceLostCount;
+		return true;
+	}
+
+	void Solver::setSurrogatePoolSize(size_t poolSize)
+	{
+		m_surrogatePoolSize = std::max<size_t>(poolSize, 1);
+		if (m_surrogatePoolSize == 1)
+			m_surrogate.clear();
+	}
+
+	void Solver::testGeneration(PopulationStore::Generation& generation)
+	{
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_2);
+		if (!hasTestFunc() || generation.getAgentCount() == 0)
+			return;
+
+		size_t grainSize = m_testGrainSize;
+		if (grainSize == 0 && useBatchTestFunc())
+		{
+			// A batch function vectorises over the agents of a block, one block per worker keeps the lanes busy
+			size_t agentCount = generation.getAgentCount();
+			size_t workerCount = getConcurrency();
+			grainSize = SimdDouble::getPaddedCount((agentCount + workerCount - 1) / workerCount);
+		}
+		parallelFor(generation.getAgentCount(), grainSize,
+			[this, &generation](size_t begin, size_t end, size_t)
+			{
+				testAgents(generation, begin, end);
+			});
+	}
+	void Solver::testAgents(PopulationStore::Generation& generation, size_t begin, size_t end, size_t agentIndexOffset)
+	{
+		end = std::min(end, generation.getAgentCount());
+		if (begin >= end)
+			return;
+		if (useBatchTestFunc())
+		{
+			if (m_fitnessCache.isEnabled())
+			{
+				testAgentsBatchCached(generation, begin, end, agentIndexOffset);
+				return;
+			}
+			PopulationStore::AgentBlock block = generation.getBlock(begin, end - begin);
+			block.indexOffset = agentIndexOffset;
+			m_parametersBatchTestFunc(block);
+			generation.sumScoreParts(begin, end);
+			return;
+		}
+
+		thread_local std::vector<double> parameters;
+		if (!m_fitnessCache.isEnabled())
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				generation.getParameters(i, parameters);
+				generation.setScoreParts(i, m_parametersTestFunc(parameters, i + agentIndexOffset));
+			}
+			return;
+		}
+
+		thread_local std::vector<double> scoreParts;
+		for (size_t i = begin; i < end; ++i)
+		{
+			generation.getParameters(i, parameters);
+			if (!m_fitnessCache.lookup(parameters, scoreParts))
+			{
+				size_t raceLostCount = t_raceLostCount;
+				scoreParts = m_parametersTestFunc(parameters, i + agentIndexOffset);
+				if (t_raceLostCount == raceLostCount)
+					m_fitnessCache.insert(parameters, scoreParts);
+			}
+			generation.setScoreParts(i, scoreParts);
+		}
+	}
+	void Solver::testAgentsBatchCached(PopulationStore::Generation& generation, size_t begin, size_t end, size_t agentIndexOffset)
+	{
+		thread_local std::vector<double> parameters;
+		thread_local std::vector<double> scoreParts;
+		thread_local std::vector<size_t> misses;
+		thread_local std::vector<unsigned char> raceLost;
+		misses.clear();
+		for (size_t i = begin; i < end; ++i)
+		{
+			generation.getParameters(i, parameters);
+			if (m_fitnessCache.lookup(parameters, scoreParts))
+				generation.setScoreParts(i, scoreParts);
+			else
+				misses.push_back(i);
+		}
+		if (misses.empty())
+			return;
+
+		raceLost.assign(end - begin, 0);
+		size_t raceLostCount = t_raceLostCount;
+		if (misses.size() == end - begin)
+		{
+			PopulationStore::AgentBlock block = generation.getBlock(begin, end - begin);
+			block.indexOffset = agentIndexOffset;
+			block.raceLost = raceLost.data();
+			m_parametersBatchTestFunc(block);
+			generation.sumScoreParts(begin, end);
+		}
+		else
+		{
+			// Only the missed agents get simulated, compacted into a block of their own
+			thread_local PopulationStore missStore;
+			if (missStore.getAgentCount() != misses.size() ||
+				missStore.getParameterCount() != generation.getParameterCount() ||
+				missStore.getScorePartCount() != generation.getScorePartCount())
+				missStore.resize(misses.size(), generation.getParameterCount(), generation.getScorePartCount());
+			PopulationStore::Generation& missed = missStore.getCurrent();
+			for (size_t m = 0; m < misses.size(); ++m)
+			{
+				generation.getParameters(misses[m], parameters);
+				missed.setParameters(m, parameters);
+			}
+			PopulationStore::AgentBlock block = missed.getBlock(0, misses.size());
+			block.raceLost = raceLost.data();
+			m_parametersBatchTestFunc(block);
+			for (size_t m = 0; m < misses.size(); ++m)
+			{
+				missed.getScoreParts(m, scoreParts);
+				generation.setScoreParts(misses[m], scoreParts);
+			}
+			// The flags are indexed like the compacted block, move them to the agents of the generation
+			for (size_t m = misses.size(); m-- > 0;)
+			{
+				unsigned char lost = raceLost[m];
+				raceLost[m] = 0;
+				raceLost[misses[m] - begin] = lost;
+			}
+		}
+
+		// Scores bounded by racing are not cached. A function that stopped agents without marking them
+		// leaves it unknown which scores are bounds, then nothing of the block gets cached.
+		if (t_raceLostCount != raceLostCount &&
+			std::find(raceLost.begin(), raceLost.end(), 1) == raceLost.end())
+			return;
+		for (size_t i : misses)
+		{
+			if (raceLost[i - begin])
+				continue;
+			generation.getParameters(i, parameters);
+			generation.getScoreParts(i, scoreParts);
+			m_fitnessCache.insert(parameters, scoreParts);
+		}
+	}
+	void Solver::trainSurrogate(const PopulationStore::Generation& generation)
+	{
+		if (m_surrogatePoolSize <= 1)
+			return;
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_4);
+		// Scores of an older context don't describe the current test anymore
+		uint64_t contextVersion = getFitnessContextVersion();
+		if (contextVersion != m_surrogateContextVersion)
+		{
+			m_surrogate.clear();
+			m_surrogateContextVersion = contextVersion;
+		}
+		// Points beyond half the capacity would be dropped by the next rebuild anyway, a large generation is thinned out
+		const size_t agentCount = generation.getAgentCount();
+		const size_t maxPoints = std::max<size_t>(m_surrogate.getCapacity() / 2, 1);
+		const size_t stride = (agentCount + maxPoints - 1) / maxPoints;
+		for (size_t i = 0; i < agentCount; i += stride)
+		{
+			generation.getParameters(i, m_surrogateParameters);
+			m_surrogate.add(m_surrogateParameters, generation.getScore(i));
+		}
+		m_surrogate.fit();
+	}
+	void Solver::updateRacingThreshold(const PopulationStore::Generation& generation)
+	{
+		const size_t agentCount = generation.getAgentCount();
+		if (!m_racingEnabled || m_optimizingDirection != OptimizingDirection::Minimize || agentCount == 0)
+		{
+			m_racingThreshold.store(std::numeric_limits<double>::infinity());
+			return;
+		}
+		const double* scores = generation.getScores();
+		m_racingScores.assign(scores, scores + agentCount);
+		size_t rank = static_cast<size_t>(std::ceil(m_racingQuantile * static_cast<double>(agentCount)));
+		rank = std::clamp<size_t>(rank, 1, agentCount) - 1;
+		std::nth_element(m_racingScores.begin(), m_racingScores.begin() + rank, m_racingScores.end());
+		double threshold = m_racingScores[rank];
+		// A NaN score must not disable the cut off
+		if (std::isnan(threshold))
+			threshold = std::numeric_limits<double>::infinity();
+		m_racingThreshold.store(threshold);
+	}
+}
\ No newline at end of file
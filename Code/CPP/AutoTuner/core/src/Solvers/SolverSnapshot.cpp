@@ -0,0 +1,32 @@
+#include "Solvers/SolverSnapshot.h"
+
+namespace AutoTuner
+{
+	SolverSnapshot::HistoryEntry SolverSnapshot::createHistoryEntry(const PopulationStore::Generation& generation, size_t epoch,
+		double stepSize, Solver::OptimizingDirection direction)
+	{
+		HistoryEntry entry;
+		entry.epoch = epoch;
+		entry.stepSize = stepSize;
+		const size_t agentCount = generation.getAgentCount();
+		if (agentCount == 0)
+			return entry;
+
+		const bool minimize = direction == Solver::OptimizingDirection::Minimize;
+		entry.bestScore = generation.getScore(0);
+		entry.worstScore = entry.bestScore;
+		double sumScore = 0;
+		for (size_t i = 0; i < agentCount; ++i)
+		{
+			double score = generation.getScore(i);
+			sumScore += score;
+			if (minimize ? score < entry.bestScore : score > entry.bestScore)
+				entry.bestScore = score;
+			if (minimize ? score > entry.worstScore : score < entry.worstScore)
+				entry.worstScore = score;
+		}
+		entry.averageScore = sumScore / static_cast<double>(agentCount);
+		return entry;
+	}
+
+}
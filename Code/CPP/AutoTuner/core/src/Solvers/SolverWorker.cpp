@@ -0,0 +1,144 @@
+#include "Solvers/SolverWorker.h"
+#include <algorithm>
+
+namespace AutoTuner
+{
+	SolverWorker::SolverWorker(Solver* solver)
+	{
+		setSolver(solver);
+	}
+	SolverWorker::~SolverWorker()
+	{
+		setSolver(nullptr);
+	}
+
+	void SolverWorker::setSolver(Solver* solver)
+	{
+		stop();
+		if (m_solver && m_solver->getObserver() == this)
+			m_solver->setObserver(nullptr);
+		m_solver = solver;
+		if (m_solver)
+			m_solver->setObserver(this);
+		// The pooled snapshots must not extend the history of the last solver
+		++m_resetCount;
+		m_history.clear();
+		m_epoch.store(0, std::memory_order_relaxed);
+	}
+
+	void SolverWorker::start(size_t epochCount)
+	{
+		if (!m_solver || m_running.load(std::memory_order_acquire))
+			return;
+		if (m_thread.joinable())
+			m_thread.join();	// The last run ended by itself
+
+		m_stopRequested.store(false, std::memory_order_relaxed);
+		m_running.store(true, std::memory_order_release);
+		m_thread = std::thread(&SolverWorker::threadFunction, this, epochCount);
+	}
+
+	void SolverWorker::stop()
+	{
+		m_stopRequested.store(true, std::memory_order_relaxed);
+		if (m_thread.joinable())
+			m_thread.join();
+	}
+
+	void SolverWorker::threadFunction(size_t epochCount)
+	{
+		m_runEpochCount = epochCount;
+		m_runEpoch = 0;
+		m_stopAfterEpoch = false;
+		m_generationPublished = true;
+		m_solver->run(std::numeric_limits<size_t>::max(), [this](size_t)
+			{
+				++m_runEpoch;
+				if (m_stopAfterEpoch || (m_runEpochCount && m_runEpoch >= m_runEpochCount))
+					return false;
+				// A stop that came after the generation got skipped runs one more epoch, which then gets published
+				return !(m_stopRequested.load(std::memory_order_relaxed) && m_generationPublished);
+			});
+		m_running.store(false, std::memory_order_release);
+	}
+
+	void SolverWorker::onGeneration(const Solver& solver, const PopulationStore::Generation& generation)
+	{
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_3);
+		size_t epoch = m_epoch.fetch_add(1, std::memory_order_relaxed);
+		if (generation.getAgentCount() > 0)
+			addHistoryEntry(SolverSnapshot::createHistoryEntry(generation, epoch, solver.getStepSize(), solver.getOptimizingDirection()));
+
+		if (m_running.load(std::memory_order_acquire))
+		{
+			if (m_epochCallback && !m_epochCallback(epoch + 1, generation))
+				m_stopAfterEpoch = true;
+			if (m_stopRequested.load(std::memory_order_relaxed))
+				m_stopAfterEpoch = true;
+			bool lastEpoch = m_stopAfterEpoch || (m_runEpochCount && m_runEpoch + 1 >= m_runEpochCount);
+
+			// Copying the generation only pays off once the reader took the last snapshot
+			m_generationPublished = lastEpoch || m_snapshotRequested.exchange(false, std::memory_order_relaxed);
+			if (!m_generationPublished)
+				return;
+		}
+
+		std::shared_ptr<SolverSnapshot> snapshot = m_snapshotPool.acquire();
+		snapshot->epoch = epoch;
+		snapshot->generation = generation;	// Reuses the capacity of the pooled snapshot
+		solver.writeSnapshot(*snapshot);
+		writeHistory(*snapshot);
+		publish(snapshot);
+	}
+
+	void SolverWorker::addHistoryEntry(const SolverSnapshot::HistoryEntry& entry)
+	{
+		m_history.push_back(entry);
+		// Trimming only once the history doubled keeps the epochs free of moving the whole history
+		if (m_history.size() >= 2 * std::max<size_t>(m_historySize, 1))
+			m_history.erase(m_history.begin(), m_history.begin() + (m_history.size() - m_historySize));
+	}
+
+	void SolverWorker::writeHistory(SolverSnapshot& snapshot) const
+	{
+		// A pooled snapshot still holds the history of its last use, only the newer entries get appended.
+		// The epochs of the history increase, the entries older than the kept history drop out by the trimming below.
+		std::vector<SolverSnapshot::HistoryEntry>& history = snapshot.history;
+		auto begin = m_history.begin();
+		if (snapshot.resetCount != m_resetCount || history.empty())
+			history.clear();
+		else
+		{
+			begin = std::upper_bound(m_history.begin(), m_history.end(), history.back().epoch,
+				[](size_t epoch, const SolverSnapshot::HistoryEntry& entry) { return epoch < entry.epoch; });
+		}
+		history.insert(history.end(), begin, m_history.end());
+		if (history.size() > m_historySize)
+			history.erase(history.begin(), history.begin() + (history.size() - m_historySize));
+	}
+
+	void SolverWorker::onReset(const Solver& solver)
+	{
+		++m_resetCount;
+		m_history.clear();
+		m_epoch.store(0, std::memory_order_relaxed);
+
+		// Lets the reader see the reset even if the worker is stopped and no generation follows
+		std::shared_ptr<SolverSnapshot> snapshot = m_snapshotPool.acquire();
+		snapshot->epoch = 0;
+		snapshot->generation = PopulationStore::Generation();
+		snapshot->history.clear();
+		solver.writeSnapshot(*snapshot);
+		publish(snapshot);
+	}
+
+	void SolverWorker::publish(const std::shared_ptr<SolverSnapshot>& snapshot)
+	{
+		snapshot->version = ++m_version;
+		snapshot->resetCount = m_resetCount;
+
+		// Drops the handle published two times before, its snapshot returns to the pool unless a reader still holds it
+		m_snapshots.getWriteBuffer() = snapshot;
+		m_snapshots.publish();
+	}
+}
@@ -0,0 +1,124 @@
+#include "Utilities/FitnessCache.h"
+#include <cstring>
+
+namespace AutoTuner
+{
+	FitnessCache::FitnessCache(size_t capacity, size_t shardCount)
+	{
+		m_shards.resize(std::max<size_t>(1, shardCount));
+		for (auto& shard : m_shards)
+			shard = std::make_unique<Shard>();
+		setCapacity(capacity);
+	}
+
+	void FitnessCache::setCapacity(size_t capacity)
+	{
+		m_capacity = capacity;
+		m_shardCapacity = (capacity + m_shards.size() - 1) / m_shards.size();
+		clear();
+	}
+
+	bool FitnessCache::lookup(const std::vector<double>& parameters, std::vector<double>& scoreParts)
+	{
+		if (!isEnabled())
+			return false;
+		Key key = makeKey(parameters);
+		Shard& shard = getShard(key);
+		{
+			std::lock_guard<std::mutex> lock(shard.mutex);
+			auto it = shard.entries.find(key);
+			if (it != shard.entries.end())
+			{
+				scoreParts = it->second;
+				++m_hitCount;
+				return true;
+			}
+		}
+		++m_missCount;
+		return false;
+	}
+	void FitnessCache::insert(const std::vector<double>& parameters, const std::vector<double>& scoreParts)
+	{
+		if (!isEnabled())
+			return;
+		Key key = makeKey(parameters);
+		Shard& shard = getShard(key);
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		auto it = shard.entries.find(key);
+		if (it != shard.entries.end())
+		{
+			it->second = scoreParts;
+			return;
+		}
+
+		if (shard.insertionOrder.size() < m_shardCapacity)
+		{
+			shard.insertionOrder.push_back(key);
+		}
+		else
+		{
+			Key& oldest = shard.insertionOrder[shard.nextEviction];
+			shard.entries.erase(oldest);
+			oldest = key;
+			shard.nextEviction = (shard.nextEviction + 1) % shard.insertionOrder.size();
+		}
+		shard.entries.emplace(std::move(key), scoreParts);
+	}
+
+	void FitnessCache::clear()
+	{
+		for (auto& shard : m_shards)
+		{
+			std::lock_guard<std::mutex> lock(shard->mutex);
+			shard->entries.clear();
+			shard->insertionOrder.clear();
+			shard->insertionOrder.reserve(m_shardCapacity);
+			shard->nextEviction = 0;
+		}
+	}
+	size_t FitnessCache::size() const
+	{
+		size_t count = 0;
+		for (const auto& shard : m_shards)
+		{
+			std::lock_guard<std::mutex> lock(shard->mutex);
+			count += shard->entries.size();
+		}
+		return count;
+	}
+	void FitnessCache::resetCounters()
+	{
+		m_hitCount.store(0);
+		m_missCount.store(0);
+	}
+
+	size_t FitnessCache::KeyHash::operator()(const Key& key) const
+	{
+		// splitmix64 finalizer over all words
+		uint64_t hash = key.contextVersion ^ 0x9E3779B97F4A7C15ull;
+		for (uint64_t word : key.bits)
+		{
+			hash ^= word + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+			hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+			hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+			hash ^= hash >> 31;
+		}
+		return static_cast<size_t>(hash);
+	}
+
+	FitnessCache::Key FitnessCache::makeKey(const std::vector<double>& parameters) const
+	{
+		Key key;
+		key.contextVersion = m_contextVersion.load();
+		key.bits.resize(parameters.size());
+		if (!parameters.empty())
+			std::memcpy(key.bits.data(), parameters.data(), parameters.size() * sizeof(double));
+		return key;
+	}
+	FitnessCache::Shard& FitnessCache::getShard(const Key& key)
+	{
+		// The low bits select the bucket inside the map, use the high bits for the shard
+		uint64_t hash = KeyHash()(key);
+		return *m_shards[(hash >> 48) % m_shards.size()];
+	}
+}
@@ -1,4 +1,6 @@
 ﻿#include "Utilities/FrequencyResponse.h"
+#include "Utilities/LinearAlgebra.h"
+#include <memory>
 
 
 namespace AutoTuner
@@ -21,6 +23,60 @@ namespace AutoTuner
 		size_t n_points = n_decades * m_pointsPerDecade;
         std::vector<double> frequencies = logspace(startFrequency, endFrequency, n_points);
 
+		switch (m_method)
+		{
+			case Method::Analytic:
+			{
+				getAnalyticResponse(system, frequencies, data);
+				break;
+			}
+			case Method::Auto:
+			{
+				if (getAnalyticResponse(system, frequencies, data))
+					break;
+				getParallelSweepResponse(system, frequencies, data);
+				break;
+			}
+			case Method::TimeDomainSweep:
+			{
+				getSweepResponse(system, frequencies, data);
+				break;
+			}
+			case Method::ParallelSweep:
+			{
+				getParallelSweepResponse(system, frequencies, data);
+				break;
+			}
+			case Method::Multisine:
+			case Method::Chirp:
+			{
+				getIdentifiedResponse(system, frequencies, m_method, data);
+				break;
+			}
+		}
+		computeMargins(data);
+		return data;
+	}
+
+	bool FrequencyResponse::getAnalyticResponse(TimeBasedSystem& system, const std::vector<double>& frequencies, FrequencyResponseData& data) const
+	{
+		data.responsePoints.clear();
+		data.responsePoints.reserve(frequencies.size());
+		for (double freq : frequencies)
+		{
+			std::complex<double> gain;
+			if (!system.getFrequencyResponse(2.0 * M_PI * freq, m_inputIndex, m_outputIndex, gain))
+			{
+				data.responsePoints.clear();
+				return false;
+			}
+			data.responsePoints.push_back({ freq, gain });
+		}
+		return true;
+	}
+
+	void FrequencyResponse::getSweepResponse(TimeBasedSystem& system, const std::vector<double>& frequencies, FrequencyResponseData& data) const
+	{
 		system.reset();
 
         for (double freq : frequencies) {
@@ -63,7 +119,354 @@ namespace AutoTuner
 
             data.responsePoints.push_back({ freq, output_phasor / input_phasor });
         }
+	}
+
+	void FrequencyResponse::getParallelSweepResponse(TimeBasedSystem& system, const std::vector<double>& frequencies, FrequencyResponseData& data) const
+	{
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_5);
+		data.responsePoints.resize(frequencies.size());
+
+		// Each task sweeps a run of neighbouring frequencies upwards on its own clone.
+		// A point starts from the settled state of the previous one, which is close to its own steady state,
+		// only the first point of a run starts from rest. The runs do not depend on the worker count.
+		const size_t runLength = std::max<size_t>(1, m_sweepRunLength);
+		const size_t runCount = (frequencies.size() + runLength - 1) / runLength;
+		getTaskScheduler().parallelFor(runCount, 1,
+			[&](size_t begin, size_t end, size_t)
+			{
+				for (size_t run = begin; run < end; ++run)
+				{
+					std::unique_ptr<TimeBasedSystem> clone(system.clone());
+					clone->reset();
+					size_t last = std::min(frequencies.size(), (run + 1) * runLength);
+					for (size_t i = run * runLength; i < last; ++i)
+						data.responsePoints[i] = { frequencies[i], measureGain(*clone, frequencies[i]) };
+				}
+			}, m_taskGroup);
+	}
+
+	std::complex<double> FrequencyResponse::measureGain(TimeBasedSystem& system, double frequency) const
+	{
+		// Integer number of samples per period, so every period starts at phase 0
+		size_t samplesPerPeriod = std::max<size_t>(1000, static_cast<size_t>(std::ceil(100.0 / frequency)));
+		double dt = 1.0 / (frequency * samplesPerPeriod);
+		double omega = 2.0 * M_PI * frequency;
+
+		// e^(j*omega*t) of one period, advanced by one complex multiplication per sample
+		std::vector<std::complex<double>> oscillator(samplesPerPeriod);
+		const std::complex<double> rotation(std::cos(omega * dt), std::sin(omega * dt));
+		oscillator[0] = 1.0;
+		for (size_t i = 1; i < samplesPerPeriod; ++i)
+			oscillator[i] = oscillator[i - 1] * rotation;
+
+		const size_t measuringPeriods = std::max<size_t>(1, m_measuringPeriods);
+		std::vector<double> inputs(measuringPeriods * samplesPerPeriod);
+		std::vector<double> outputs(measuringPeriods * samplesPerPeriod);
+		auto runPeriod = [&](size_t slot)
+			{
+				double* input = inputs.data() + slot * samplesPerPeriod;
+				double* output = outputs.data() + slot * samplesPerPeriod;
+				for (size_t i = 0; i < samplesPerPeriod; ++i)
+				{
+					input[i] = m_signalGain * oscillator[i].imag();
+					system.setInputSignal(m_inputIndex, input[i]);
+					system.update(dt);
+					output[i] = system.getOutput(m_outputIndex);
+				}
+			};
+
+		// The fit removes a slowly decaying transient, a faster one changes the phasor between two periods.
+		// The number of periods is fixed, so a point costs at most (maxSettlingPeriods + measuringPeriods) * samplesPerPeriod updates.
+		std::complex<double> lastOutputPhasor;
+		bool settled = false;
+		for (size_t period = 0; period < m_maxSettlingPeriods; ++period)
+		{
+			runPeriod(0);
+			std::complex<double> inputPhasor, outputPhasor;
+			fitPhasors(oscillator, inputs.data(), outputs.data(), 1, inputPhasor, outputPhasor);
+			if (period > 0 && std::abs(outputPhasor - lastOutputPhasor) <= m_settlingTolerance * std::abs(outputPhasor))
+			{
+				settled = true;
+				break;
+			}
+			lastOutputPhasor = outputPhasor;
+		}
+
+		// The period that passed the settling check is already steady, it counts as the first measured period
+		for (size_t slot = settled ? 1 : 0; slot < measuringPeriods; ++slot)
+			runPeriod(slot);
+
+		// The input is fitted with the same model, errors of the oscillator cancel out in the ratio
+		std::complex<double> inputPhasor, outputPhasor;
+		fitPhasors(oscillator, inputs.data(), outputs.data(), measuringPeriods, inputPhasor, outputPhasor);
+		if (inputPhasor == 0.0)
+			return 0;
+
+		// The output is read at the end of a step, the input was held over the whole step.
+		// Shifting by half a step refers both to the middle of the step.
+		return outputPhasor / inputPhasor * std::polar(1.0, -M_PI * frequency * dt);
+	}
+
+	void FrequencyResponse::fitPhasors(const std::vector<std::complex<double>>& oscillator, const double* input, const double* output,
+		size_t periods, std::complex<double>& inputPhasor, std::complex<double>& outputPhasor)
+	{
+		// Least squares fit of p.real * sin + p.imag * cos + c0 + c1 * s + c2 * s^2 with s in [-1, 1]
+		constexpr size_t n = 5;
+		const size_t count = periods * oscillator.size();
+		std::vector<double> normal(n * n, 0.0);
+		std::vector<double> rhs(n * 2, 0.0);
+		double basis[n];
+		for (size_t i = 0; i < count; ++i)
+		{
+			const std::complex<double>& phase = oscillator[i % oscillator.size()];
+			double s = count > 1 ? 2.0 * i / (count - 1) - 1.0 : 0.0;
+			basis[0] = phase.imag();
+			basis[1] = phase.real();
+			basis[2] = 1.0;
+			basis[3] = s;
+			basis[4] = s * s;
+			for (size_t row = 0; row < n; ++row)
+			{
+				for (size_t col = row; col < n; ++col)
+					normal[row * n + col] += basis[row] * basis[col];
+				rhs[row * 2] += basis[row] * input[i];
+				rhs[row * 2 + 1] += basis[row] * output[i];
+			}
+		}
+		for (size_t row = 1; row < n; ++row)
+			for (size_t col = 0; col < row; ++col)
+				normal[row * n + col] = normal[col * n + row];
+
+		if (!LinearAlgebra::solve(normal, n, rhs, 2))
+		{
+			inputPhasor = 0;
+			outputPhasor = 0;
+			return;
+		}
+		inputPhasor = { rhs[0], rhs[2] };
+		outputPhasor = { rhs[1], rhs[3] };
+	}
+
+	void FrequencyResponse::getIdentifiedResponse(TimeBasedSystem& system, const std::vector<double>& frequencies, Method method, FrequencyResponseData& data) const
+	{
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_5);
+		data.responsePoints.clear();
+		if (frequencies.empty() || frequencies[0] <= 0)
+			return;
+		data.responsePoints.reserve(frequencies.size());
+
+		// The period of one run grows with the ratio of its highest to its lowest frequency,
+		// splitting the range keeps each run short
+		size_t begin = 0;
+		while (begin < frequencies.size())
+		{
+			double limit = frequencies[begin] * std::pow(10.0, m_identificationDecadesPerRun) * (1.0 + 1e-9);
+			size_t end = begin + 1;
+			while (end < frequencies.size() && (m_identificationDecadesPerRun <= 0 || frequencies[end] <= limit))
+				++end;
+			std::vector<double> runFrequencies(frequencies.begin() + begin, frequencies.begin() + end);
+			identifyRun(system, runFrequencies, method, data);
+			begin = end;
+		}
+	}
 
+	void FrequencyResponse::identifyRun(TimeBasedSystem& system, const std::vector<double>& frequencies, Method method, FrequencyResponseData& data) const
+	{
+		// The base frequency is chosen, so that neighbouring log spaced points land on different lines
+		size_t firstLine = 1;
+		if (frequencies.size() > 1 && frequencies[1] > frequencies[0])
+			firstLine = std::max<size_t>(1, static_cast<size_t>(std::ceil(frequencies[0] / (frequencies[1] - frequencies[0]))));
+		double baseFrequency = frequencies[0] / firstLine;
+		std::vector<size_t> lines;
+		lines.reserve(frequencies.size());
+		for (double freq : frequencies)
+		{
+			size_t line = static_cast<size_t>(std::llround(freq / baseFrequency));
+			if (!lines.empty())
+				line = std::max(line, lines.back() + 1);
+			lines.push_back(line);
+		}
+
+		size_t sampleCount = 1;
+		while (sampleCount < lines.back() * m_identificationOversampling || sampleCount <= 2 * lines.back())
+			sampleCount *= 2;
+		double period = 1.0 / baseFrequency;
+		double dt = period / sampleCount;
+
+		// One period of the excitation
+		std::vector<double> excitation(sampleCount, 0.0);
+		switch (method)
+		{
+			case Method::Chirp:
+			{
+				// Instantaneous frequency rises exponentially from the first to the last line over one period
+				double startFrequency = lines.front() * baseFrequency;
+				double endFrequency = lines.back() * baseFrequency;
+				double rate = std::log(endFrequency / startFrequency);
+				for (size_t i = 0; i < sampleCount; ++i)
+				{
+					double t = i * dt;
+					double phase = rate > 0 ?
+						2.0 * M_PI * startFrequency * period / rate * (std::exp(rate * t / period) - 1.0) :
+						2.0 * M_PI * startFrequency * t;
+					excitation[i] = std::sin(phase);
+				}
+				break;
+			}
+			default:
+			{
+				// Schroeder phases keep the crest factor low, built with an inverse FFT
+				std::vector<std::complex<double>> spectrum(sampleCount);
+				double lineCount = static_cast<double>(lines.size());
+				for (size_t k = 0; k < lines.size(); ++k)
+				{
+					double phase = -M_PI * k * (k + 1) / lineCount;
+					spectrum[lines[k]] = std::polar(1.0, phase - M_PI / 2.0);
+					spectrum[sampleCount - lines[k]] = std::conj(spectrum[lines[k]]);
+				}
+				fft(spectrum, true);
+				for (size_t i = 0; i < sampleCount; ++i)
+					excitation[i] = spectrum[i].real();
+				break;
+			}
+		}
+		double peak = 0;
+		for (double value : excitation)
+			peak = std::max(peak, std::abs(value));
+		if (peak > 0)
+		{
+			for (double& value : excitation)
+				value *= m_signalGain / peak;
+		}
+
+		// The response to a periodic input becomes periodic, so the measured period has no leakage
+		// The first period fades the excitation in, a step onto the excitation would also excite modes outside of the run
+		system.reset();
+		for (size_t p = 0; p < m_identificationSettlingPeriods; ++p)
+		{
+			for (size_t i = 0; i < sampleCount; ++i)
+			{
+				double fade = p == 0 ? 0.5 - 0.5 * std::cos(M_PI * i / sampleCount) : 1.0;
+				system.setInputSignal(m_inputIndex, fade * excitation[i]);
+				system.update(dt);
+			}
+		}
+		double lastOutput = system.getOutput(m_outputIndex);
+		std::vector<double> outputSamples(sampleCount);
+		double outputPeak = 0;
+		for (size_t i = 0; i < sampleCount; ++i)
+		{
+			system.setInputSignal(m_inputIndex, excitation[i]);
+			system.update(dt);
+			outputSamples[i] = system.getOutput(m_outputIndex);
+			outputPeak = std::max(outputPeak, std::abs(outputSamples[i]));
+		}
+		std::vector<std::complex<double>> input(excitation.begin(), excitation.end());
+		std::vector<std::complex<double>> output(outputSamples.begin(), outputSamples.end());
+		fft(input, false);
+		fft(output, false);
+
+		// A transient of the upper runs, which last only a short time, may not have decayed within the settling periods.
+		// A settled output ends the period where the previous one ended.
+		// The excitation is periodic, only the output needs the fit. Lines above a quarter of the sample count stay out of the model,
+		// the oversampling leaves them without signal, so they tell the trend apart from the lines.
+		if (std::abs(outputSamples.back() - lastOutput) > m_settlingTolerance * outputPeak)
+			removeTrend(outputSamples, sampleCount / 4, output);
+
+		// The output is read at the end of a step, the input was held over the whole step.
+		// Shifting by half a step refers both to the middle of the step.
+		for (size_t line : lines)
+		{
+			double frequency = line * baseFrequency;
+			std::complex<double> gain = input[line] != 0.0 ? output[line] / input[line] : 0.0;
+			gain *= std::polar(1.0, -M_PI * frequency * dt);
+			data.responsePoints.push_back({ frequency, gain });
+		}
+	}
+
+	void FrequencyResponse::removeTrend(const std::vector<double>& samples, size_t highestLine, std::vector<std::complex<double>>& spectrum)
+	{
+		// Least squares fit of the sines of the lines 1 to highestLine plus the trend c0 + c1 * s + c2 * s^2, s in [-1, 1].
+		// The sines are orthogonal over the period, so eliminating them leaves a 3x3 system for the trend:
+		//   (P^T P - sum_k |P[k]|^2 / (N/2)) * c = P^T x - sum_k Re(conj(P[k]) * X[k]) / (N/2)
+		// The fitted line k is X[k] - sum_p c_p * P_p[k].
+		constexpr size_t trendOrder = 3;
+		const size_t sampleCount = samples.size();
+		const double halfCount = sampleCount / 2.0;
+
+		std::vector<std::vector<std::complex<double>>> trendSpectra(trendOrder, std::vector<std::complex<double>>(sampleCount));
+		std::vector<double> normal(trendOrder * trendOrder, 0.0);
+		std::vector<double> rhs(trendOrder, 0.0);
+		for (size_t i = 0; i < sampleCount; ++i)
+		{
+			double s = 2.0 * i / (sampleCount - 1) - 1.0;
+			const double trend[trendOrder] = { 1.0, s, s * s };
+			for (size_t p = 0; p < trendOrder; ++p)
+			{
+				trendSpectra[p][i] = trend[p];
+				for (size_t q = 0; q < trendOrder; ++q)
+					normal[p * trendOrder + q] += trend[p] * trend[q];
+				rhs[p] += trend[p] * samples[i];
+			}
+		}
+		for (std::vector<std::complex<double>>& trendSpectrum : trendSpectra)
+			fft(trendSpectrum, false);
+
+		for (size_t k = 1; k <= highestLine; ++k)
+		{
+			for (size_t p = 0; p < trendOrder; ++p)
+			{
+				std::complex<double> line = std::conj(trendSpectra[p][k]);
+				for (size_t q = 0; q < trendOrder; ++q)
+					normal[p * trendOrder + q] -= (line * trendSpectra[q][k]).real() / halfCount;
+				rhs[p] -= (line * spectrum[k]).real() / halfCount;
+			}
+		}
+		if (!LinearAlgebra::solve(normal, trendOrder, rhs, 1))
+			return;
+
+		for (size_t k = 1; k <= highestLine; ++k)
+			for (size_t p = 0; p < trendOrder; ++p)
+				spectrum[k] -= rhs[p] * trendSpectra[p][k];
+	}
+
+	void FrequencyResponse::fft(std::vector<std::complex<double>>& data, bool inverse)
+	{
+		size_t n = data.size();
+		for (size_t i = 1, j = 0; i < n; ++i)
+		{
+			size_t bit = n >> 1;
+			for (; j & bit; bit >>= 1)
+				j ^= bit;
+			j ^= bit;
+			if (i < j)
+				std::swap(data[i], data[j]);
+		}
+
+		// Twiddle factors of the largest stage, the smaller stages use every n/length-th of them
+		std::vector<std::complex<double>> twiddles(n / 2);
+		double sign = inverse ? 1.0 : -1.0;
+		for (size_t k = 0; k < n / 2; ++k)
+			twiddles[k] = std::polar(1.0, sign * 2.0 * M_PI * k / n);
+
+		for (size_t length = 2; length <= n; length <<= 1)
+		{
+			size_t stride = n / length;
+			for (size_t i = 0; i < n; i += length)
+			{
+				for (size_t k = 0; k < length / 2; ++k)
+				{
+					std::complex<double> even = data[i + k];
+					std::complex<double> odd = data[i + k + length / 2] * twiddles[k * stride];
+					data[i + k] = even + odd;
+					data[i + k + length / 2] = even - odd;
+				}
+			}
+		}
+	}
+
+	void FrequencyResponse::computeMargins(FrequencyResponseData& data)
+	{
 		// Find crossing frequency, gain margin, and phase margin
         bool crossedOver = false;
         double lastGain = 0;
@@ -98,11 +501,8 @@ namespace AutoTuner
             lastGain = magnitude;
 			lastImag = point.gain.imag();
         }
-
-		return data;
 	}
 
-
 	std::complex<double> FrequencyResponse::computePhasor(const std::vector<double>& signal, double freq, double dt) 
 	{
 		double omega = 2.0 * M_PI * freq;
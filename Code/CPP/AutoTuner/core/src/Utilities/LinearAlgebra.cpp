@@ -0,0 +1,346 @@
+#include "Utilities/LinearAlgebra.h"
+#include <cmath>
+#include <algorithm>
+
+namespace AutoTuner
+{
+	std::vector<double> LinearAlgebra::identity(size_t n)
+	{
+		std::vector<double> result(n * n, 0.0);
+		for (size_t i = 0; i < n; ++i)
+			result[i * n + i] = 1.0;
+		return result;
+	}
+
+	void LinearAlgebra::multiply(const std::vector<double>& a, const std::vector<double>& b,
+		size_t rows, size_t inner, size_t cols, std::vector<double>& result)
+	{
+		result.assign(rows * cols, 0.0);
+		for (size_t i = 0; i < rows; ++i)
+		{
+			for (size_t k = 0; k < inner; ++k)
+			{
+				double aik = a[i * inner + k];
+				if (aik == 0.0)
+					continue;
+				for (size_t j = 0; j < cols; ++j)
+					result[i * cols + j] += aik * b[k * cols + j];
+			}
+		}
+	}
+
+	bool LinearAlgebra::luDecompose(std::vector<double>& a, size_t n, std::vector<size_t>& pivot)
+	{
+		pivot.resize(n);
+		for (size_t i = 0; i < n; ++i)
+			pivot[i] = i;
+
+		bool regular = true;
+		for (size_t k = 0; k < n; ++k)
+		{
+			size_t pivotRow = k;
+			double pivotValue = std::abs(a[k * n + k]);
+			for (size_t i = k + 1; i < n; ++i)
+			{
+				double value = std::abs(a[i * n + k]);
+				if (value > pivotValue)
+				{
+					pivotValue = value;
+					pivotRow = i;
+				}
+			}
+			if (pivotRow != k)
+			{
+				for (size_t j = 0; j < n; ++j)
+					std::swap(a[k * n + j], a[pivotRow * n + j]);
+				std::swap(pivot[k], pivot[pivotRow]);
+			}
+
+			double diagonal = a[k * n + k];
+			if (diagonal == 0.0)
+			{
+				regular = false;
+				continue;
+			}
+			for (size_t i = k + 1; i < n; ++i)
+			{
+				double factor = a[i * n + k] / diagonal;
+				a[i * n + k] = factor;
+				for (size_t j = k + 1; j < n; ++j)
+					a[i * n + j] -= factor * a[k * n + j];
+			}
+		}
+		return regular;
+	}
+
+	void LinearAlgebra::luSolve(const std::vector<double>& lu, const std::vector<size_t>& pivot, size_t n,
+		std::vector<double>& b, size_t cols)
+	{
+		std::vector<double> permuted(n * cols);
+		for (size_t i = 0; i < n; ++i)
+			for (size_t j = 0; j < cols; ++j)
+				permuted[i * cols + j] = b[pivot[i] * cols + j];
+
+		// Forward substitution with the unit lower triangle
+		for (size_t i = 0; i < n; ++i)
+			for (size_t k = 0; k < i; ++k)
+			{
+				double factor = lu[i * n + k];
+				for (size_t j = 0; j < cols; ++j)
+					permuted[i * cols + j] -= factor * permuted[k * cols + j];
+			}
+
+		// Backward substitution with the upper triangle
+		for (size_t i = n; i-- > 0;)
+		{
+			for (size_t k = i + 1; k < n; ++k)
+			{
+				double factor = lu[i * n + k];
+				for (size_t j = 0; j < cols; ++j)
+					permuted[i * cols + j] -= factor * permuted[k * cols + j];
+			}
+			double diagonal = lu[i * n + i];
+			for (size_t j = 0; j < cols; ++j)
+				permuted[i * cols + j] /= diagonal;
+		}
+		b = std::move(permuted);
+	}
+
+	bool LinearAlgebra::solve(std::vector<double> a, size_t n, std::vector<double>& b, size_t cols)
+	{
+		std::vector<size_t> pivot;
+		if (!luDecompose(a, n, pivot))
+			return false;
+		luSolve(a, pivot, n, b, cols);
+		return true;
+	}
+
+	std::vector<double> LinearAlgebra::expm(const std::vector<double>& a, size_t n)
+	{
+		if (n == 0)
+			return {};
+
+		// Scale A so that its norm is below 0.5, the Pade approximation is accurate to machine precision there
+		double norm = normInf(a, n, n);
+		int squarings = 0;
+		if (norm > 0.5)
+			squarings = std::max(0, static_cast<int>(std::ceil(std::log2(norm / 0.5))));
+		double scale = std::ldexp(1.0, -squarings);
+
+		std::vector<double> scaled(a);
+		for (double& value : scaled)
+			value *= scale;
+
+		// Diagonal Pade approximation of degree q: e^X ~ D(X)^-1 * N(X)
+		// N(X) = sum c_k X^k, D(X) = sum c_k (-X)^k
+		const int q = 6;
+		std::vector<double> numerator = identity(n);
+		std::vector<double> denominator = identity(n);
+		std::vector<double> power = identity(n);
+		std::vector<double> tmp;
+		double c = 1.0;
+		for (int k = 1; k <= q; ++k)
+		{
+			c = c * static_cast<double>(q - k + 1) / static_cast<double>(k * (2 * q - k + 1));
+			multiply(scaled, power, n, n, n, tmp);
+			power.swap(tmp);
+			double sign = (k % 2 == 0) ? 1.0 : -1.0;
+			for (size_t i = 0; i < n * n; ++i)
+			{
+				numerator[i] += c * power[i];
+				denominator[i] += sign * c * power[i];
+			}
+		}
+
+		if (!solve(denominator, n, numerator, n))
+			return identity(n);
+
+		for (int i = 0; i < squarings; ++i)
+		{
+			multiply(numerator, numerator, n, n, n, tmp);
+			numerator.swap(tmp);
+		}
+		return numerator;
+	}
+
+	double LinearAlgebra::normInf(const std::vector<double>& a, size_t rows, size_t cols)
+	{
+		double norm = 0;
+		for (size_t i = 0; i < rows; ++i)
+		{
+			double sum = 0;
+			for (size_t j = 0; j < cols; ++j)
+				sum += std::abs(a[i * cols + j]);
+			norm = std::max(norm, sum);
+		}
+		return norm;
+	}
+
+	void LinearAlgebra::hessenbergReduce(std::vector<double>& a, size_t n, std::vector<double>& q)
+	{
+		q = identity(n);
+		std::vector<double> v(n);
+		for (size_t k = 0; k + 2 < n; ++k)
+		{
+			// Householder vector that zeroes column k below the subdiagonal
+			size_t length = n - k - 1;
+			double norm = 0;
+			for (size_t i = 0; i < length; ++i)
+			{
+				v[i] = a[(k + 1 + i) * n + k];
+				norm += v[i] * v[i];
+			}
+			norm = std::sqrt(norm);
+			if (norm == 0.0)
+				continue;
+			double alpha = v[0] > 0 ? -norm : norm;
+			v[0] -= alpha;
+			double vNorm2 = 0;
+			for (size_t i = 0; i < length; ++i)
+				vNorm2 += v[i] * v[i];
+			if (vNorm2 == 0.0)
+				continue;
+			double beta = 2.0 / vNorm2;
+
+			// A = P * A
+			for (size_t j = k; j < n; ++j)
+			{
+				double sum = 0;
+				for (size_t i = 0; i < length; ++i)
+					sum += v[i] * a[(k + 1 + i) * n + j];
+				sum *= beta;
+				for (size_t i = 0; i < length; ++i)
+					a[(k + 1 + i) * n + j] -= sum * v[i];
+			}
+			// A = A * P, Q = Q * P
+			for (size_t i = 0; i < n; ++i)
+			{
+				double sumA = 0;
+				double sumQ = 0;
+				for (size_t j = 0; j < length; ++j)
+				{
+					sumA += a[i * n + k + 1 + j] * v[j];
+					sumQ += q[i * n + k + 1 + j] * v[j];
+				}
+				sumA *= beta;
+				sumQ *= beta;
+				for (size_t j = 0; j < length; ++j)
+				{
+					a[i * n + k + 1 + j] -= sumA * v[j];
+					q[i * n + k + 1 + j] -= sumQ * v[j];
+				}
+			}
+			a[(k + 1) * n + k] = alpha;
+			for (size_t i = 1; i < length; ++i)
+				a[(k + 1 + i) * n + k] = 0.0;
+		}
+	}
+
+	bool LinearAlgebra::solveShiftedHessenberg(const std::vector<double>& h, size_t n, std::complex<double> shift,
+		std::vector<std::complex<double>>& b)
+	{
+		std::vector<std::complex<double>> m(n * n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			for (size_t j = 0; j < n; ++j)
+				m[i * n + j] = -h[i * n + j];
+			m[i * n + i] += shift;
+		}
+
+		// Only the subdiagonal has to be eliminated, pivoting between row k and k + 1
+		for (size_t k = 0; k + 1 < n; ++k)
+		{
+			if (std::abs(m[(k + 1) * n + k]) > std::abs(m[k * n + k]))
+			{
+				for (size_t j = k; j < n; ++j)
+					std::swap(m[k * n + j], m[(k + 1) * n + j]);
+				std::swap(b[k], b[k + 1]);
+			}
+			if (m[k * n + k] == 0.0)
+				return false;
+			std::complex<double> factor = m[(k + 1) * n + k] / m[k * n + k];
+			for (size_t j = k + 1; j < n; ++j)
+				m[(k + 1) * n + j] -= factor * m[k * n + j];
+			b[k + 1] -= factor * b[k];
+		}
+
+		for (size_t i = n; i-- > 0;)
+		{
+			if (m[i * n + i] == 0.0)
+				return false;
+			std::complex<double> sum = b[i];
+			for (size_t j = i + 1; j < n; ++j)
+				sum -= m[i * n + j] * b[j];
+			b[i] = sum / m[i * n + i];
+		}
+		return true;
+	}
+
+	bool LinearAlgebra::symmetricEigen(const std::vector<double>& a, size_t n,
+		std::vector<double>& values, std::vector<double>& vectors)
+	{
+		std::vector<double> m = a;
+		vectors = identity(n);
+		values.resize(n);
+		const size_t maxSweeps = 64;
+		bool converged = n < 2;
+		for (size_t sweep = 0; sweep < maxSweeps && !converged; ++sweep)
+		{
+			double offDiagonal = 0;
+			double diagonal = 0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				diagonal += m[i * n + i] * m[i * n + i];
+				for (size_t j = i + 1; j < n; ++j)
+					offDiagonal += m[i * n + j] * m[i * n + j];
+			}
+			if (offDiagonal <= 1e-30 * diagonal || offDiagonal == 0)
+			{
+				converged = true;
+				break;
+			}
+
+			for (size_t p = 0; p < n; ++p)
+			{
+				for (size_t q = p + 1; q < n; ++q)
+				{
+					double apq = m[p * n + q];
+					if (apq == 0)
+						continue;
+					double app = m[p * n + p];
+					double aqq = m[q * n + q];
+					// Rotation angle that zeroes m(p, q)
+					double theta = (aqq - app) / (2.0 * apq);
+					double t = (theta >= 0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+					double c = 1.0 / std::sqrt(t * t + 1.0);
+					double s = t * c;
+
+					for (size_t k = 0; k < n; ++k)
+					{
+						double mkp = m[k * n + p];
+						double mkq = m[k * n + q];
+						m[k * n + p] = c * mkp - s * mkq;
+						m[k * n + q] = s * mkp + c * mkq;
+					}
+					for (size_t k = 0; k < n; ++k)
+					{
+						double mpk = m[p * n + k];
+						double mqk = m[q * n + k];
+						m[p * n + k] = c * mpk - s * mqk;
+						m[q * n + k] = s * mpk + c * mqk;
+					}
+					for (size_t k = 0; k < n; ++k)
+					{
+						double vkp = vectors[k * n + p];
+						double vkq = vectors[k * n + q];
+						vectors[k * n + p] = c * vkp - s * vkq;
+						vectors[k * n + q] = s * vkp + c * vkq;
+					}
+				}
+			}
+		}
+		for (size_t i = 0; i < n; ++i)
+			values[i] = m[i * n + i];
+		return converged;
+	}
+}
\ No newline at end of file
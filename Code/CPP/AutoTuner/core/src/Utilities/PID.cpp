@@ -160,6 +160,24 @@ namespace AutoTuner
 		return { m_outputValue };
 	}
 
+	bool PID::getFrequencyResponse(double omega, size_t inputIndex, size_t outputIndex, std::complex<double>& response)
+	{
+		if (inputIndex != 0 || outputIndex != 0 || omega <= 0)
+			return false;
+		std::complex<double> s(0.0, omega);
+		response = m_kp + m_ki / s;
+		switch (getDerivativeType())
+		{
+			case DerivativeType::Unfiltered:
+				response += m_kd * s;
+				break;
+			case DerivativeType::Filtered:
+				response += m_kd * m_kn * s / (s + m_kn);
+				break;
+		}
+		return true;
+	}
+
 	void PID::update(double deltaTime)
 	{
 		double proportional = m_kp * m_inputValue;
@@ -0,0 +1,208 @@
+#include "Utilities/PIDBatch.h"
+
+namespace AutoTuner
+{
+	PIDBatch::PIDBatch(size_t count)
+		: m_integrationSolver(TimeBasedSystem::getDefaultIntegrationSolver())
+		, m_differentiationSolver(TimeBasedSystem::getDefaultDifferentiationSolver())
+	{
+		resize(count);
+	}
+
+	void PIDBatch::resize(size_t count)
+	{
+		size_t oldCount = m_count;
+		size_t paddedCount = SimdDouble::getPaddedCount(count);
+		auto resizeRow = [oldCount, count, paddedCount](std::vector<double>& row, double defaultValue)
+			{
+				row.resize(paddedCount, defaultValue);
+				// Padding lanes may have been used before, start them with default values
+				for (size_t i = std::min(oldCount, count); i < paddedCount; ++i)
+					row[i] = defaultValue;
+			};
+
+		// Same defaults as a default constructed PID
+		PID defaultPID;
+		resizeRow(m_kp, defaultPID.getKp());
+		resizeRow(m_ki, defaultPID.getKi());
+		resizeRow(m_kd, defaultPID.getKd());
+		resizeRow(m_kn, defaultPID.getKn());
+		resizeRow(m_backCalculationConstant, defaultPID.getAntiWindupBackCalculationConstant());
+		resizeRow(m_iSaturationLimit, defaultPID.getIntegralSatturationLimit());
+		resizeRow(m_outputSaturationLimitLower, defaultPID.getOutputSaturationLimits().first);
+		resizeRow(m_outputSaturationLimitUpper, defaultPID.getOutputSaturationLimits().second);
+
+		resizeRow(m_integral, 0.0);
+		resizeRow(m_inputValue, 0.0);
+		resizeRow(m_lastInputValue, 0.0);
+		resizeRow(m_lastDerivativeValue, 0.0);
+		resizeRow(m_outputValue, 0.0);
+		resizeRow(m_outputValueBeforeSaturation, 0.0);
+		resizeRow(m_outputPositiveSaturated, 0.0);
+		resizeRow(m_outputNegativeSaturated, 0.0);
+		m_count = count;
+	}
+
+	void PIDBatch::reset()
+	{
+		std::fill(m_integral.begin(), m_integral.end(), 0.0);
+		std::fill(m_inputValue.begin(), m_inputValue.end(), 0.0);
+		std::fill(m_lastInputValue.begin(), m_lastInputValue.end(), 0.0);
+		std::fill(m_lastDerivativeValue.begin(), m_lastDerivativeValue.end(), 0.0);
+		std::fill(m_outputValue.begin(), m_outputValue.end(), 0.0);
+		std::fill(m_outputValueBeforeSaturation.begin(), m_outputValueBeforeSaturation.end(), 0.0);
+		std::fill(m_outputPositiveSaturated.begin(), m_outputPositiveSaturated.end(), 0.0);
+		std::fill(m_outputNegativeSaturated.begin(), m_outputNegativeSaturated.end(), 0.0);
+	}
+
+	void PIDBatch::setConfiguration(const PID& pid)
+	{
+		m_antiWindupMethod = pid.getAntiWindupMethod();
+		m_derivativeType = pid.getDerivativeType();
+		m_integrationSolver = pid.getIntegrationSolver();
+		m_differentiationSolver = pid.getDifferentiationSolver();
+		for (size_t i = 0; i < m_count; ++i)
+			setController(i, pid);
+	}
+	void PIDBatch::setController(size_t index, const PID& pid)
+	{
+		setParameters(index, pid.getKp(), pid.getKi(), pid.getKd(), pid.getKn());
+		m_backCalculationConstant[index] = pid.getAntiWindupBackCalculationConstant();
+		m_iSaturationLimit[index] = pid.getIntegralSatturationLimit();
+		std::pair<double, double> limits = pid.getOutputSaturationLimits();
+		m_outputSaturationLimitLower[index] = limits.first;
+		m_outputSaturationLimitUpper[index] = limits.second;
+	}
+
+	void PIDBatch::setParameters(size_t index, double kp, double ki, double kd, double kn)
+	{
+		m_kp[index] = kp;
+		m_ki[index] = ki;
+		m_kd[index] = kd;
+		m_kn[index] = kn;
+	}
+	void PIDBatch::setOutputSaturationLimits(double lowerLimit, double upperLimit)
+	{
+		std::fill(m_outputSaturationLimitLower.begin(), m_outputSaturationLimitLower.end(), lowerLimit);
+		std::fill(m_outputSaturationLimitUpper.begin(), m_outputSaturationLimitUpper.end(), upperLimit);
+	}
+
+	void PIDBatch::update(double deltaTime)
+	{
+		if (m_precision == Precision::Strict)
+			updateLanes<true>(deltaTime);
+		else
+			updateLanes<false>(deltaTime);
+	}
+
+	template<bool strict>
+	void PIDBatch::updateLanes(double deltaTime)
+	{
+		typedef SimdDouble V;
+		using IntegrationSolver = TimeBasedSystem::IntegrationSolver;
+
+		// The configuration is the same for all lanes, the switches below are taken the same way in every iteration
+		const bool filtered = m_derivativeType == PID::DerivativeType::Filtered;
+		const bool differentiate = filtered || m_differentiationSolver == TimeBasedSystem::DifferentiationSolver::BackwardEuler;
+		const PID::AntiWindupMethod antiWindup = m_antiWindupMethod;
+		const IntegrationSolver solver = m_integrationSolver;
+
+		const V dt = V::broadcast(deltaTime);
+		const V inverseDt = V::broadcast(1.0 / deltaTime);
+		const V halfDt = V::broadcast(deltaTime / 2.0);
+		const V zero = V::broadcast(0.0);
+		const V one = V::broadcast(1.0);
+
+		size_t paddedCount = SimdDouble::getPaddedCount(m_count);
+		for (size_t i = 0; i < paddedCount; i += V::s_laneCount)
+		{
+			V input = V::load(m_inputValue.data() + i);
+			V lastInput = V::load(m_lastInputValue.data() + i);
+			V integral = V::load(m_integral.data() + i);
+			V ki = V::load(m_ki.data() + i);
+
+			V proportional = V::load(m_kp.data() + i) * input;
+			V derivative = zero;
+			if (filtered)
+			{
+				V kn = V::load(m_kn.data() + i);
+				V lastDerivative = V::load(m_lastDerivativeValue.data() + i);
+				derivative = V::load(m_kd.data() + i) * kn * (input - lastInput) - lastDerivative * (kn * dt - one);
+			}
+			else if (differentiate)
+			{
+				if constexpr (strict)
+					derivative = ((input - lastInput) / dt) * V::load(m_kd.data() + i);
+				else
+					derivative = ((input - lastInput) * inverseDt) * V::load(m_kd.data() + i);
+			}
+
+			V toIntegrateSignal = input * ki;
+			V toIntegrateLastSignal = lastInput * ki;
+
+			V skipIntegration = zero;
+			if (antiWindup == PID::AntiWindupMethod::Clamping)
+			{
+				V integralSignEqual = V::maskOr(
+					V::maskAnd(V::greaterThan(integral, zero), V::greaterThan(toIntegrateSignal, zero)),
+					V::maskAnd(V::lessThan(integral, zero), V::lessThan(toIntegrateSignal, zero)));
+				V saturated = V::greaterThan(V::load(m_outputPositiveSaturated.data() + i) + V::load(m_outputNegativeSaturated.data() + i), zero);
+				skipIntegration = V::maskAnd(saturated, integralSignEqual);
+			}
+			else if (antiWindup == PID::AntiWindupMethod::BackCalculation)
+			{
+				V antiWindupSignal = (V::load(m_outputValue.data() + i) - V::load(m_outputValueBeforeSaturation.data() + i)) *
+					V::load(m_backCalculationConstant.data() + i);
+				toIntegrateSignal += antiWindupSignal;
+				toIntegrateLastSignal += antiWindupSignal;
+			}
+
+			V integrated = integral;
+			switch (solver)
+			{
+				case IntegrationSolver::ForwardEuler:
+					integrated = integral + dt * toIntegrateSignal;
+					break;
+				case IntegrationSolver::BackwardEuler:
+					integrated = integral + dt * toIntegrateLastSignal;
+					break;
+				case IntegrationSolver::Bilinear:
+					integrated = integral + halfDt * (toIntegrateSignal + toIntegrateLastSignal);
+					break;
+				default:
+					break;
+			}
+			integral = V::select(skipIntegration, integral, integrated);
+
+			// Integral saturation
+			V iLimit = V::load(m_iSaturationLimit.data() + i);
+			V iLimitNegative = -iLimit;
+			if constexpr (strict)
+			{
+				integral = V::select(V::lessThan(integral, iLimitNegative), iLimitNegative, integral);
+				integral = V::select(V::greaterThan(integral, iLimit), iLimit, integral);
+			}
+			else
+			{
+				integral = V::max(V::min(integral, iLimit), iLimitNegative);
+			}
+
+			V outputBeforeSaturation = proportional + integral + derivative;
+
+			// Output saturation, the lower limit wins if both limits are violated
+			V lower = V::load(m_outputSaturationLimitLower.data() + i);
+			V upper = V::load(m_outputSaturationLimitUpper.data() + i);
+			V negativeSaturated = V::lessThan(outputBeforeSaturation, lower);
+			V positiveSaturated = V::maskAndNot(negativeSaturated, V::greaterThan(outputBeforeSaturation, upper));
+			V output = V::select(negativeSaturated, lower, V::select(positiveSaturated, upper, outputBeforeSaturation));
+
+			integral.store(m_integral.data() + i);
+			outputBeforeSaturation.store(m_outputValueBeforeSaturation.data() + i);
+			output.store(m_outputValue.data() + i);
+			V::maskToOne(positiveSaturated).store(m_outputPositiveSaturated.data() + i);
+			V::maskToOne(negativeSaturated).store(m_outputNegativeSaturated.data() + i);
+			input.store(m_lastInputValue.data() + i);
+			derivative.store(m_lastDerivativeValue.data() + i);
+		}
+	}
+}
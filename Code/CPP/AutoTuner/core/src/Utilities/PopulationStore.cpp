@@ -0,0 +1,149 @@
+#include "Utilities/PopulationStore.h"
+
+namespace AutoTuner
+{
+	PopulationStore::PopulationStore()
+	{
+
+	}
+	PopulationStore::PopulationStore(size_t agentCount, size_t parameterCount, size_t scorePartCount)
+	{
+		resize(agentCount, parameterCount, scorePartCount);
+	}
+
+	void PopulationStore::resize(size_t agentCount, size_t parameterCount, size_t scorePartCount)
+	{
+		m_generations[0].resize(agentCount, parameterCount, scorePartCount);
+		m_generations[1].resize(agentCount, parameterCount, scorePartCount);
+		m_currentIndex = 0;
+	}
+	void PopulationStore::setScorePartCount(size_t scorePartCount)
+	{
+		for (Generation& generation : m_generations)
+		{
+			generation.m_scorePartCount = scorePartCount;
+			generation.m_scoreParts.assign(scorePartCount * generation.m_agentCount, 0.0);
+		}
+	}
+
+
+	//
+	// PopulationStore::Generation
+	//
+
+	void PopulationStore::Generation::resize(size_t agentCount, size_t parameterCount, size_t scorePartCount)
+	{
+		m_agentCount = agentCount;
+		m_parameterCount = parameterCount;
+		m_scorePartCount = scorePartCount;
+
+		m_parameters.assign(agentCount * parameterCount, 0.0);
+		m_mutationFactors.assign(agentCount * parameterCount, 0.0);
+		m_scoreParts.assign(agentCount * scorePartCount, 0.0);
+		m_scores.assign(agentCount, 0.0);
+	}
+
+	void PopulationStore::Generation::getParameters(size_t agent, std::vector<double>& parameters) const
+	{
+		parameters.resize(m_parameterCount);
+		for (size_t p = 0; p < m_parameterCount; ++p)
+			parameters[p] = m_parameters[p * m_agentCount + agent];
+	}
+	void PopulationStore::Generation::setParameters(size_t agent, const std::vector<double>& parameters)
+	{
+		size_t count = std::min(parameters.size(), m_parameterCount);
+		for (size_t p = 0; p < count; ++p)
+			m_parameters[p * m_agentCount + agent] = parameters[p];
+	}
+	void PopulationStore::Generation::getMutationFactors(size_t agent, std::vector<double>& factors) const
+	{
+		factors.resize(m_parameterCount);
+		for (size_t p = 0; p < m_parameterCount; ++p)
+			factors[p] = m_mutationFactors[p * m_agentCount + agent];
+	}
+	void PopulationStore::Generation::getScoreParts(size_t agent, std::vector<double>& scoreParts) const
+	{
+		scoreParts.resize(m_scorePartCount);
+		for (size_t s = 0; s < m_scorePartCount; ++s)
+			scoreParts[s] = m_scoreParts[s * m_agentCount + agent];
+	}
+	void PopulationStore::Generation::setScoreParts(size_t agent, const std::vector<double>& scoreParts)
+	{
+		double score = 0;
+		for (size_t s = 0; s < scoreParts.size(); ++s)
+		{
+			if (s < m_scorePartCount)
+				m_scoreParts[s * m_agentCount + agent] = scoreParts[s];
+			score += scoreParts[s];
+		}
+		m_scores[agent] = score;
+	}
+	void PopulationStore::Generation::sumScoreParts(size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+			m_scores[i] = 0;
+		for (size_t s = 0; s < m_scorePartCount; ++s)
+		{
+			const double* row = getScorePartRow(s);
+			for (size_t i = begin; i < end; ++i)
+				m_scores[i] += row[i];
+		}
+	}
+
+	void PopulationStore::Generation::copyAgent(const Generation& source, size_t sourceAgent, size_t targetAgent)
+	{
+		for (size_t p = 0; p < m_parameterCount; ++p)
+		{
+			m_parameters[p * m_agentCount + targetAgent] = source.m_parameters[p * source.m_agentCount + sourceAgent];
+			m_mutationFactors[p * m_agentCount + targetAgent] = source.m_mutationFactors[p * source.m_agentCount + sourceAgent];
+		}
+		for (size_t s = 0; s < m_scorePartCount; ++s)
+			m_scoreParts[s * m_agentCount + targetAgent] = source.m_scoreParts[s * source.m_agentCount + sourceAgent];
+		m_scores[targetAgent] = source.m_scores[sourceAgent];
+	}
+
+	void PopulationStore::Generation::gather(const Generation& source, const std::vector<size_t>& order)
+	{
+		if (m_agentCount != source.m_agentCount ||
+			m_parameterCount != source.m_parameterCount ||
+			m_scorePartCount != source.m_scorePartCount)
+		{
+			resize(source.m_agentCount, source.m_parameterCount, source.m_scorePartCount);
+		}
+		size_t count = std::min(order.size(), m_agentCount);
+		for (size_t p = 0; p < m_parameterCount; ++p)
+		{
+			double* paramsDst = getParameterRow(p);
+			double* factorsDst = getMutationFactorRow(p);
+			const double* paramsSrc = source.getParameterRow(p);
+			const double* factorsSrc = source.getMutationFactorRow(p);
+			for (size_t i = 0; i < count; ++i)
+			{
+				paramsDst[i] = paramsSrc[order[i]];
+				factorsDst[i] = factorsSrc[order[i]];
+			}
+		}
+		for (size_t s = 0; s < m_scorePartCount; ++s)
+		{
+			double* dst = getScorePartRow(s);
+			const double* src = source.getScorePartRow(s);
+			for (size_t i = 0; i < count; ++i)
+				dst[i] = src[order[i]];
+		}
+		for (size_t i = 0; i < count; ++i)
+			m_scores[i] = source.m_scores[order[i]];
+	}
+
+	PopulationStore::AgentBlock PopulationStore::Generation::getBlock(size_t begin, size_t count)
+	{
+		AgentBlock block;
+		block.parameters = m_parameters.data();
+		block.scoreParts = m_scoreParts.data();
+		block.stride = m_agentCount;
+		block.begin = begin;
+		block.count = std::min(count, m_agentCount - std::min(begin, m_agentCount));
+		block.parameterCount = m_parameterCount;
+		block.scorePartCount = m_scorePartCount;
+		return block;
+	}
+}
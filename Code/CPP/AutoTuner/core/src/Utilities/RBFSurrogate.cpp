@@ -0,0 +1,204 @@
+#include "Utilities/RBFSurrogate.h"
+#include <cmath>
+#include <algorithm>
+
+namespace AutoTuner
+{
+	namespace
+	{
+		// Four independent sums, the substitutions are bound by the latency of a single sum otherwise
+		inline double dot(const double* a, const double* b, size_t count)
+		{
+			double sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				sum0 += a[i] * b[i];
+				sum1 += a[i + 1] * b[i + 1];
+				sum2 += a[i + 2] * b[i + 2];
+				sum3 += a[i + 3] * b[i + 3];
+			}
+			for (; i < count; ++i)
+				sum0 += a[i] * b[i];
+			return (sum0 + sum1) + (sum2 + sum3);
+		}
+	}
+
+	RBFSurrogate::RBFSurrogate(size_t capacity)
+	{
+		setCapacity(capacity);
+	}
+
+	void RBFSurrogate::setCapacity(size_t capacity)
+	{
+		m_capacity = std::max<size_t>(capacity, 4);
+		clear();
+	}
+	void RBFSurrogate::clear()
+	{
+		m_parameterCount = 0;
+		m_pointCount = 0;
+		m_points.clear();
+		m_scores.clear();
+		m_inverseLengths.clear();
+		m_factor.clear();
+		m_weights.clear();
+		m_mean = 0;
+		m_scaled = false;
+		m_fitted = false;
+	}
+
+	void RBFSurrogate::add(const std::vector<double>& parameters, double score)
+	{
+		if (!std::isfinite(score) || parameters.empty())
+			return;
+		if (m_pointCount == 0)
+		{
+			m_parameterCount = parameters.size();
+			m_points.resize(m_capacity * m_parameterCount);
+			m_scores.resize(m_capacity);
+		}
+		else if (parameters.size() != m_parameterCount)
+		{
+			return;
+		}
+
+		if (m_pointCount == m_capacity)
+		{
+			// Keep the newest half, the rebuild is amortised over the next capacity / 2 points
+			size_t keep = m_capacity / 2;
+			size_t first = m_pointCount - keep;
+			std::copy(m_points.begin() + first * m_parameterCount, m_points.begin() + m_pointCount * m_parameterCount, m_points.begin());
+			std::copy(m_scores.begin() + first, m_scores.begin() + m_pointCount, m_scores.begin());
+			m_pointCount = keep;
+			m_scaled = false;
+		}
+
+		std::copy(parameters.begin(), parameters.end(), m_points.begin() + m_pointCount * m_parameterCount);
+		m_scores[m_pointCount] = score;
+		++m_pointCount;
+		m_fitted = false;
+
+		if (!m_scaled)
+		{
+			// The scaling needs a few points to estimate the spread
+			if (m_pointCount >= m_parameterCount + 2)
+				rebuild();
+			return;
+		}
+		if (!extendFactor())
+			--m_pointCount;
+	}
+
+	void RBFSurrogate::fit()
+	{
+		if (!m_scaled)
+		{
+			m_fitted = false;
+			return;
+		}
+		// L * L^T * w = s - mean
+		const size_t n = m_pointCount;
+		m_weights.resize(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			const double* row = m_factor.data() + i * m_capacity;
+			m_weights[i] = (m_scores[i] - m_mean - dot(row, m_weights.data(), i)) / row[i];
+		}
+		// L^T is solved row by row of L, which keeps the memory access contiguous
+		for (size_t j = n; j-- > 0;)
+		{
+			const double* row = m_factor.data() + j * m_capacity;
+			m_weights[j] /= row[j];
+			const double weight = m_weights[j];
+			for (size_t i = 0; i < j; ++i)
+				m_weights[i] -= row[i] * weight;
+		}
+		m_fitted = true;
+	}
+
+	double RBFSurrogate::predict(const double* parameters, size_t stride) const
+	{
+		if (!m_fitted)
+			return m_mean;
+		double value = m_mean;
+		for (size_t i = 0; i < m_pointCount; ++i)
+			value += m_weights[i] * kernel(m_points.data() + i * m_parameterCount, parameters, stride);
+		return value;
+	}
+
+	double RBFSurrogate::kernel(const double* a, const double* b, size_t bStride) const
+	{
+		double distance = 0;
+		for (size_t p = 0; p < m_parameterCount; ++p)
+		{
+			double d = (a[p] - b[p * bStride]) * m_inverseLengths[p];
+			distance += d * d;
+		}
+		return std::exp(-0.5 * distance);
+	}
+
+	bool RBFSurrogate::extendFactor()
+	{
+		// Bordered Cholesky: the new row l solves L * l = k, the diagonal is sqrt(k(x, x) - l * l)
+		const size_t n = m_pointCount - 1;
+		const double* point = m_points.data() + n * m_parameterCount;
+		double* row = m_factor.data() + n * m_capacity;
+		double sumSquares = 0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			const double* rowI = m_factor.data() + i * m_capacity;
+			double sum = kernel(m_points.data() + i * m_parameterCount, point, 1) - dot(rowI, row, i);
+			row[i] = sum / rowI[i];
+			sumSquares += row[i] * row[i];
+		}
+		double diagonal = 1.0 + m_regularization - sumSquares;
+		if (diagonal <= m_regularization * 0.5)
+			return false;
+		row[n] = std::sqrt(diagonal);
+		return true;
+	}
+
+	void RBFSurrogate::rebuild()
+	{
+		++m_rebuildCount;
+		const size_t n = m_pointCount;
+		m_inverseLengths.assign(m_parameterCount, 1.0);
+		for (size_t p = 0; p < m_parameterCount; ++p)
+		{
+			double mean = 0;
+			for (size_t i = 0; i < n; ++i)
+				mean += m_points[i * m_parameterCount + p];
+			mean /= static_cast<double>(n);
+			double variance = 0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				double d = m_points[i * m_parameterCount + p] - mean;
+				variance += d * d;
+			}
+			double spread = std::sqrt(variance / static_cast<double>(n));
+			if (spread > 0 && std::isfinite(spread))
+				m_inverseLengths[p] = 1.0 / (m_lengthScale * spread);
+		}
+		m_mean = 0;
+		for (size_t i = 0; i < n; ++i)
+			m_mean += m_scores[i];
+		m_mean /= static_cast<double>(n);
+
+		// Adds the points one by one, duplicates get dropped on the way
+		m_factor.assign(m_capacity * m_capacity, 0.0);
+		m_scaled = true;
+		m_pointCount = 0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			if (i != m_pointCount)
+			{
+				std::copy(m_points.begin() + i * m_parameterCount, m_points.begin() + (i + 1) * m_parameterCount, m_points.begin() + m_pointCount * m_parameterCount);
+				m_scores[m_pointCount] = m_scores[i];
+			}
+			++m_pointCount;
+			if (!extendFactor())
+				--m_pointCount;
+		}
+	}
+}
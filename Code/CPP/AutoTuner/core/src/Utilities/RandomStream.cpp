@@ -0,0 +1,98 @@
+#include "Utilities/RandomStream.h"
+#include <atomic>
+
+namespace AutoTuner
+{
+	namespace
+	{
+		std::atomic<uint64_t> s_threadStreamSeed{ RandomStream::s_defaultSeed };
+		std::atomic<uint32_t> s_threadStreamSeedVersion{ 0 };
+		std::atomic<uint32_t> s_threadStreamCounter{ 0 };
+	}
+
+	double RandomStream::getGaussDouble(double min, double max)
+	{
+		// Using Box-Muller transform, 1 - u keeps the logarithm finite
+		double u1 = 1.0 - nextDouble();
+		double u2 = nextDouble();
+		double z0 = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+		// Scale and shift to desired range
+		double mean = (min + max) / 2.0;
+		double stddev = (max - min) / 6.0; // 99.7% of values within [min, max]
+		double value = z0 * stddev + mean;
+		// Clamp to [min, max]
+		if (value < min) value = min;
+		if (value > max) value = max;
+		return value;
+	}
+
+	void RandomStream::fillUniform(double* values, size_t count, double min, double max)
+	{
+		// A partly used block is consumed with the scalar path first.
+		// With an odd buffer position a double always spans two blocks, so everything stays scalar.
+		size_t i = 0;
+		while (i < count && m_bufferIndex != 4)
+		{
+			if (m_bufferIndex % 2 != 0)
+			{
+				for (; i < count; ++i)
+					values[i] = getDouble(min, max);
+				return;
+			}
+			values[i++] = getDouble(min, max);
+		}
+
+		const double range = max - min;
+		const size_t blockCount = (count - i) / 2;
+		double* out = values + i;
+		for (size_t b = 0; b < blockCount; ++b)
+		{
+			uint32_t words[4];
+			getBlock(m_block + b, words);
+			uint64_t value0 = ((static_cast<uint64_t>(words[0]) << 32) | words[1]) >> 11;
+			uint64_t value1 = ((static_cast<uint64_t>(words[2]) << 32) | words[3]) >> 11;
+			out[2 * b] = min + static_cast<double>(value0) * s_toUnitDouble * range;
+			out[2 * b + 1] = min + static_cast<double>(value1) * s_toUnitDouble * range;
+		}
+		m_block += blockCount;
+		i += blockCount * 2;
+
+		for (; i < count; ++i)
+			values[i] = getDouble(min, max);
+	}
+
+	void RandomStream::fillGaussian(double* values, size_t count)
+	{
+		// Box-Muller transform, both values of a pair are used
+		for (size_t i = 0; i < count; i += 2)
+		{
+			double u1 = 1.0 - nextDouble();
+			double u2 = nextDouble();
+			double radius = std::sqrt(-2.0 * std::log(u1));
+			double angle = 2.0 * M_PI * u2;
+			values[i] = radius * std::cos(angle);
+			if (i + 1 < count)
+				values[i + 1] = radius * std::sin(angle);
+		}
+	}
+
+	RandomStream& RandomStream::getThreadStream()
+	{
+		thread_local uint32_t streamId = s_threadStreamCounter.fetch_add(1);
+		thread_local uint32_t seedVersion = s_threadStreamSeedVersion.load();
+		thread_local RandomStream stream(s_threadStreamSeed.load(), streamId, 0xFFFFFFFF);
+
+		uint32_t currentVersion = s_threadStreamSeedVersion.load(std::memory_order_acquire);
+		if (seedVersion != currentVersion)
+		{
+			seedVersion = currentVersion;
+			stream.setSeed(s_threadStreamSeed.load(), streamId, 0xFFFFFFFF);
+		}
+		return stream;
+	}
+	void RandomStream::setThreadStreamSeed(uint64_t seed)
+	{
+		s_threadStreamSeed.store(seed);
+		s_threadStreamSeedVersion.fetch_add(1, std::memory_order_release);
+	}
+}
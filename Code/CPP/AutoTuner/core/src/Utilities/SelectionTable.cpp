@@ -0,0 +1,179 @@
+#include "Utilities/SelectionTable.h"
+#include <algorithm>
+
+namespace AutoTuner
+{
+	std::string SelectionTable::methodToString(Method method)
+	{
+		switch (method)
+		{
+			case Method::PrefixSum: return "Prefix sum";
+			case Method::Alias: return "Alias";
+			case Method::Tournament: return "Tournament";
+			case Method::StochasticUniversal: return "Stochastic universal sampling";
+		}
+		return "Unknown";
+	}
+
+	void SelectionTable::build(const double* scores, size_t count, size_t drawCount, RandomStream& random)
+	{
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_3);
+		m_scores.assign(scores, scores + count);
+		m_sampled.clear();
+		if (count == 0)
+			return;
+
+		switch (m_method)
+		{
+			case Method::PrefixSum:
+				buildPrefixSum(scores, count);
+				break;
+			case Method::Alias:
+				buildAlias(count);
+				break;
+			case Method::Tournament:
+				break;
+			case Method::StochasticUniversal:
+				// The prefix sum is also used for the retries
+				buildPrefixSum(scores, count);
+				sampleUniversal(drawCount, random);
+				break;
+		}
+	}
+
+	size_t SelectionTable::draw(size_t drawIndex, RandomStream& random, size_t attempt) const
+	{
+		if (m_scores.empty())
+			return 0;
+		switch (m_method)
+		{
+			case Method::PrefixSum:
+				return drawPrefixSum(random);
+			case Method::Alias:
+				return drawAlias(random);
+			case Method::Tournament:
+				return drawTournament(random);
+			case Method::StochasticUniversal:
+				if (attempt == 0 && drawIndex < m_sampled.size())
+					return m_sampled[drawIndex];
+				return drawPrefixSum(random);
+		}
+		return 0;
+	}
+
+	size_t SelectionTable::drawPrefixSum(RandomStream& random) const
+	{
+		// First agent whose cumulative score reaches the random value, like a linear scan would find
+		double value = random.getDouble(0, m_prefixSum.back());
+		size_t index = std::lower_bound(m_prefixSum.begin(), m_prefixSum.end(), value) - m_prefixSum.begin();
+		return std::min(index, m_prefixSum.size() - 1);
+	}
+	size_t SelectionTable::drawAlias(RandomStream& random) const
+	{
+		size_t column = random.getSizeT(0, m_aliasPropability.size() - 1);
+		if (random.nextDouble() < m_aliasPropability[column])
+			return column;
+		return m_alias[column];
+	}
+	size_t SelectionTable::drawTournament(RandomStream& random) const
+	{
+		const size_t count = m_scores.size();
+		size_t best = random.getSizeT(0, count - 1);
+		for (size_t i = 1; i < m_tournamentSize; ++i)
+		{
+			size_t contender = random.getSizeT(0, count - 1);
+			if (m_scores[contender] > m_scores[best])
+				best = contender;
+		}
+		return best;
+	}
+
+	void SelectionTable::buildPrefixSum(const double* scores, size_t count)
+	{
+		m_prefixSum.resize(count);
+		double sum = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			sum += scores[i];
+			m_prefixSum[i] = sum;
+		}
+	}
+	void SelectionTable::buildAlias(size_t count)
+	{
+		// Vose's variant of the alias method
+		m_aliasPropability.resize(count);
+		m_alias.resize(count);
+		double sum = 0;
+		for (size_t i = 0; i < count; ++i)
+			sum += m_scores[i];
+
+		if (!(sum > 0))
+		{
+			// No information in the scores, draw uniformly
+			std::fill(m_aliasPropability.begin(), m_aliasPropability.end(), 1.0);
+			for (size_t i = 0; i < count; ++i)
+				m_alias[i] = i;
+			return;
+		}
+
+		std::vector<size_t> small;
+		std::vector<size_t> large;
+		small.reserve(count);
+		large.reserve(count);
+		const double scale = static_cast<double>(count) / sum;
+		for (size_t i = 0; i < count; ++i)
+		{
+			m_aliasPropability[i] = m_scores[i] * scale;
+			if (m_aliasPropability[i] < 1.0)
+				small.push_back(i);
+			else
+				large.push_back(i);
+		}
+		while (!small.empty() && !large.empty())
+		{
+			size_t less = small.back();
+			small.pop_back();
+			size_t more = large.back();
+			m_alias[less] = more;
+			m_aliasPropability[more] -= 1.0 - m_aliasPropability[less];
+			if (m_aliasPropability[more] < 1.0)
+			{
+				large.pop_back();
+				small.push_back(more);
+			}
+		}
+		// Leftovers are only caused by rounding, they are full columns
+		for (size_t i : large)
+		{
+			m_aliasPropability[i] = 1.0;
+			m_alias[i] = i;
+		}
+		for (size_t i : small)
+		{
+			m_aliasPropability[i] = 1.0;
+			m_alias[i] = i;
+		}
+	}
+	void SelectionTable::sampleUniversal(size_t drawCount, RandomStream& random)
+	{
+		m_sampled.resize(drawCount);
+		if (drawCount == 0)
+			return;
+		const double sum = m_prefixSum.back();
+		const size_t count = m_prefixSum.size();
+		const double step = sum / static_cast<double>(drawCount);
+		double pointer = random.getDouble(0, step);
+		size_t index = 0;
+		for (size_t i = 0; i < drawCount; ++i)
+		{
+			while (index + 1 < count && m_prefixSum[index] < pointer)
+				++index;
+			m_sampled[i] = index;
+			pointer += step;
+		}
+
+		// The samples are sorted by agent, shuffle them so consecutive draws are independent
+		for (size_t i = drawCount - 1; i > 0; --i)
+			std::swap(m_sampled[i], m_sampled[random.getSizeT(0, i)]);
+	}
+}
@@ -19,9 +19,20 @@ namespace AutoTuner
 		, m_x(other.m_x)
 		, m_u(other.m_u)
 		, m_lastXdot(other.m_lastXdot)
-
+		, m_timeStep(other.m_timeStep)
+		, m_discretizedA(other.m_discretizedA)
+		, m_discretizedB(other.m_discretizedB)
+		, m_nextState(other.m_nextState)
+		, m_discretizedTimeStep(other.m_discretizedTimeStep)
+		, m_isDiscretizationValid(other.m_isDiscretizationValid)
+		, m_isDiscretizationSingular(other.m_isDiscretizationSingular)
+		, m_hessenbergA(other.m_hessenbergA)
+		, m_hessenbergB(other.m_hessenbergB)
+		, m_hessenbergC(other.m_hessenbergC)
+		, m_isHessenbergValid(other.m_isHessenbergValid)
 	{
 		setIntegrationSolver(other.getIntegrationSolver());
+		TimeBasedSystem::setC2DMethod(other.getC2DMethod());
 	}
 	StatespaceSystem::~StatespaceSystem()
 	{}
@@ -41,6 +52,8 @@ namespace AutoTuner
 		m_u = MatlabAPI::Matrix(B.getCols(), 1);
 		m_x = MatlabAPI::Matrix(A.getRows(), 1);
 		m_lastXdot = MatlabAPI::Matrix(A.getRows(), 1);
+		invalidateDiscretization();
+		m_isHessenbergValid = false;
 	}
 
 	void StatespaceSystem::setIntegrationSolver(IntegrationSolver solver)
@@ -157,10 +170,179 @@ namespace AutoTuner
 		return true;
 	}
 
+	bool StatespaceSystem::getDiscretizedMatrices(double deltaTime, MatlabAPI::Matrix& Ad, MatlabAPI::Matrix& Bd)
+	{
+		if (getC2DMethod() == C2DMethod::None)
+			return false;
+		updateDiscretization(deltaTime);
+		if (m_isDiscretizationSingular)
+			return false;
+		size_t stateCount = m_A.getRows();
+		size_t inputCount = m_B.getCols();
+		Ad = MatlabAPI::Matrix(stateCount, stateCount);
+		Bd = MatlabAPI::Matrix(stateCount, inputCount);
+		for (size_t i = 0; i < stateCount; ++i)
+		{
+			for (size_t j = 0; j < stateCount; ++j)
+				Ad(i, j) = m_discretizedA[i * stateCount + j];
+			for (size_t j = 0; j < inputCount; ++j)
+				Bd(i, j) = m_discretizedB[i * inputCount + j];
+		}
+		return true;
+	}
+
+	void StatespaceSystem::updateDiscretization(double deltaTime)
+	{
+		if (m_isDiscretizationValid && m_discretizedTimeStep == deltaTime)
+			return;
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_5);
+
+		size_t n = m_A.getRows();
+		size_t m = m_B.getCols();
+		m_discretizedA.assign(n * n, 0.0);
+		m_discretizedB.assign(n * m, 0.0);
+		m_nextState.assign(n, 0.0);
+		m_isDiscretizationSingular = false;
+
+		switch (getC2DMethod())
+		{
+			case C2DMethod::ZeroOrderHold:
+			{
+				// exp([A B; 0 0] * dt) = [Ad Bd; 0 I]
+				size_t size = n + m;
+				std::vector<double> augmented(size * size, 0.0);
+				for (size_t i = 0; i < n; ++i)
+				{
+					for (size_t j = 0; j < n; ++j)
+						augmented[i * size + j] = m_A(i, j) * deltaTime;
+					for (size_t j = 0; j < m; ++j)
+						augmented[i * size + n + j] = m_B(i, j) * deltaTime;
+				}
+				std::vector<double> exponential = LinearAlgebra::expm(augmented, size);
+				for (size_t i = 0; i < n; ++i)
+				{
+					for (size_t j = 0; j < n; ++j)
+						m_discretizedA[i * n + j] = exponential[i * size + j];
+					for (size_t j = 0; j < m; ++j)
+						m_discretizedB[i * m + j] = exponential[i * size + n + j];
+				}
+				break;
+			}
+			case C2DMethod::Tustin:
+			{
+				// (I - A*dt/2) * x(k+1) = (I + A*dt/2) * x(k) + B*dt * u(k)
+				std::vector<double> lhs = LinearAlgebra::identity(n);
+				std::vector<double> rhs(n * (n + m), 0.0);
+				double halfTimeStep = deltaTime / 2.0;
+				for (size_t i = 0; i < n; ++i)
+				{
+					for (size_t j = 0; j < n; ++j)
+					{
+						lhs[i * n + j] -= m_A(i, j) * halfTimeStep;
+						rhs[i * (n + m) + j] = (i == j ? 1.0 : 0.0) + m_A(i, j) * halfTimeStep;
+					}
+					for (size_t j = 0; j < m; ++j)
+						rhs[i * (n + m) + n + j] = m_B(i, j) * deltaTime;
+				}
+				// A singular (I - A*dt/2) leaves the zeroed matrices, so the states stop instead of diverging
+				if (!LinearAlgebra::solve(lhs, n, rhs, n + m))
+				{
+					m_isDiscretizationSingular = true;
+					break;
+				}
+				for (size_t i = 0; i < n; ++i)
+				{
+					for (size_t j = 0; j < n; ++j)
+						m_discretizedA[i * n + j] = rhs[i * (n + m) + j];
+					for (size_t j = 0; j < m; ++j)
+						m_discretizedB[i * m + j] = rhs[i * (n + m) + n + j];
+				}
+				break;
+			}
+			case C2DMethod::None:
+				break;
+		}
+		m_discretizedTimeStep = deltaTime;
+		m_isDiscretizationValid = true;
+	}
+
+	bool StatespaceSystem::getFrequencyResponse(double omega, size_t inputIndex, size_t outputIndex, std::complex<double>& response)
+	{
+		size_t n = m_A.getRows();
+		size_t m = m_B.getCols();
+		size_t p = m_C.getRows();
+		if (inputIndex >= m || outputIndex >= p)
+			return false;
+		updateHessenbergForm();
+
+		// (j*omega*I - H) * x = Q^T * B(:, input)
+		std::vector<std::complex<double>> x(n);
+		for (size_t i = 0; i < n; ++i)
+			x[i] = m_hessenbergB[i * m + inputIndex];
+		if (!LinearAlgebra::solveShiftedHessenberg(m_hessenbergA, n, std::complex<double>(0.0, omega), x))
+			return false;
+
+		response = m_D.getRows() > outputIndex && m_D.getCols() > inputIndex ? m_D(outputIndex, inputIndex) : 0.0;
+		for (size_t i = 0; i < n; ++i)
+			response += m_hessenbergC[outputIndex * n + i] * x[i];
+		return true;
+	}
+
+	void StatespaceSystem::updateHessenbergForm()
+	{
+		if (m_isHessenbergValid)
+			return;
+		AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_5);
+
+		size_t n = m_A.getRows();
+		size_t m = m_B.getCols();
+		size_t p = m_C.getRows();
+		m_hessenbergA.resize(n * n);
+		for (size_t i = 0; i < n; ++i)
+			for (size_t j = 0; j < n; ++j)
+				m_hessenbergA[i * n + j] = m_A(i, j);
+
+		std::vector<double> q;
+		LinearAlgebra::hessenbergReduce(m_hessenbergA, n, q);
+
+		m_hessenbergB.assign(n * m, 0.0);
+		for (size_t i = 0; i < n; ++i)
+			for (size_t k = 0; k < n; ++k)
+				for (size_t j = 0; j < m; ++j)
+					m_hessenbergB[i * m + j] += q[k * n + i] * m_B(k, j);
+
+		m_hessenbergC.assign(p * n, 0.0);
+		for (size_t i = 0; i < p; ++i)
+			for (size_t k = 0; k < n; ++k)
+				for (size_t j = 0; j < n; ++j)
+					m_hessenbergC[i * n + j] += m_C(i, k) * q[k * n + j];
+
+		m_isHessenbergValid = true;
+	}
+
 	void StatespaceSystem::processTimeStepDiscretized(const MatlabAPI::Matrix& u)
 	{
 		//AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_5);
-		m_x = m_A * m_x + m_B * u;
+		if (getC2DMethod() == C2DMethod::None)
+		{
+			m_x = m_A * m_x + m_B * u;
+			return;
+		}
+
+		updateDiscretization(m_timeStep);
+		size_t n = m_A.getRows();
+		size_t m = m_B.getCols();
+		for (size_t i = 0; i < n; ++i)
+		{
+			double sum = 0;
+			for (size_t j = 0; j < n; ++j)
+				sum += m_discretizedA[i * n + j] * m_x(j, 0);
+			for (size_t j = 0; j < m; ++j)
+				sum += m_discretizedB[i * m + j] * u(j, 0);
+			m_nextState[i] = sum;
+		}
+		for (size_t i = 0; i < n; ++i)
+			m_x(i, 0) = m_nextState[i];
 	}
 	void StatespaceSystem::processTimeStepForwardEuler(const MatlabAPI::Matrix& u)
 	{
@@ -0,0 +1,355 @@
+#include "Utilities/TaskScheduler.h"
+
+namespace AutoTuner
+{
+	namespace
+	{
+		// Identifies the scheduler and worker of the calling thread
+		thread_local const TaskScheduler* t_currentScheduler = nullptr;
+		thread_local size_t t_currentWorkerIndex = 0;
+
+		// Groups of the tasks the calling thread is executing, innermost last
+		thread_local std::vector<TaskScheduler::Group*> t_groupStack;
+
+		bool isExecutingGroup(const TaskScheduler::Group* group)
+		{
+			return std::find(t_groupStack.begin(), t_groupStack.end(), group) != t_groupStack.end();
+		}
+	}
+
+	bool TaskScheduler::Group::tryAcquire()
+	{
+		size_t maxConcurrency = m_maxConcurrency.load(std::memory_order_relaxed);
+		size_t active = m_activeWorkers.load(std::memory_order_relaxed);
+		do
+		{
+			if (maxConcurrency != 0 && active >= maxConcurrency)
+				return false;
+		} while (!m_activeWorkers.compare_exchange_weak(active, active + 1, std::memory_order_acquire, std::memory_order_relaxed));
+		return true;
+	}
+
+	TaskScheduler::TaskScheduler(size_t workerCount)
+	{
+		if (workerCount == 0)
+			workerCount = std::thread::hardware_concurrency();
+		if (workerCount == 0)
+			workerCount = 4;
+
+		m_statisticsStart = std::chrono::steady_clock::now();
+		m_workers.reserve(workerCount);
+		for (size_t i = 0; i < workerCount; ++i)
+			m_workers.push_back(new Worker());
+		for (size_t i = 0; i < workerCount; ++i)
+			m_workers[i]->thread = std::thread(&TaskScheduler::workerLoop, this, i);
+	}
+	TaskScheduler::~TaskScheduler()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_stop = true;
+		}
+		m_wakeUp.notify_all();
+		for (Worker* worker : m_workers)
+		{
+			if (worker->thread.joinable())
+				worker->thread.join();
+			delete worker;
+		}
+		m_workers.clear();
+	}
+
+	TaskScheduler& TaskScheduler::getDefault()
+	{
+		static TaskScheduler scheduler;
+		return scheduler;
+	}
+
+	size_t TaskScheduler::getConcurrency(const Group* group) const
+	{
+		size_t maxConcurrency = group ? group->getMaxConcurrency() : 0;
+		if (maxConcurrency == 0)
+			return m_workers.size();
+		return std::min(maxConcurrency, m_workers.size());
+	}
+
+	size_t TaskScheduler::getCurrentWorkerIndex() const
+	{
+		if (t_currentScheduler == this)
+			return t_currentWorkerIndex;
+		return m_workers.size();
+	}
+
+	void TaskScheduler::parallelFor(size_t count, size_t grainSize, const RangeFunc& func, Group* group)
+	{
+		if (count == 0)
+			return;
+		if (!group)
+		{
+			// A nested job without its own group stays within the limit of the task that submits it
+			group = t_groupStack.empty() ? &m_defaultGroup : t_groupStack.back();
+		}
+		if (grainSize == 0)
+			grainSize = std::max<size_t>(1, count / (getConcurrency(group) * 8));
+
+		size_t taskCount = (count + grainSize - 1) / grainSize;
+		Job job;
+		job.func = &func;
+		job.group = group;
+		job.remainingTasks = taskCount;
+
+		// Counted before the tasks become visible, so the counter never drops below zero
+		m_queuedTasks += taskCount;
+
+		size_t workerIndex = getCurrentWorkerIndex();
+		if (workerIndex < m_workers.size())
+		{
+			// Nested job: the tasks go to the own queue, other workers will steal them
+			Worker* worker = m_workers[workerIndex];
+			std::lock_guard<std::mutex> lock(worker->mutex);
+			for (size_t begin = 0; begin < count; begin += grainSize)
+				worker->tasks.push_back({ &job, begin, std::min(begin + grainSize, count) });
+		}
+		else
+		{
+			// The workers cut the tasks off the range when they take them
+			std::lock_guard<std::mutex> lock(m_injectMutex);
+			job.count = count;
+			job.grainSize = grainSize;
+			m_injectedJobs.push_back(&job);
+		}
+		wakeUpWorkers();
+
+		waitForJob(job, workerIndex);
+
+		if (job.exception)
+			std::rethrow_exception(job.exception);
+	}
+
+	std::vector<TaskScheduler::WorkerStatistics> TaskScheduler::getWorkerStatistics() const
+	{
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_statisticsStart).count();
+		std::vector<WorkerStatistics> statistics(m_workers.size());
+		for (size_t i = 0; i < m_workers.size(); ++i)
+		{
+			statistics[i].executedTasks = m_workers[i]->executedTasks.load();
+			statistics[i].stolenTasks = m_workers[i]->stolenTasks.load();
+			statistics[i].busyTime = static_cast<double>(m_workers[i]->busyNanoseconds.load()) * 1e-9;
+			if (elapsed > 0)
+				statistics[i].utilisation = statistics[i].busyTime / elapsed;
+		}
+		return statistics;
+	}
+	void TaskScheduler::resetStatistics()
+	{
+		for (Worker* worker : m_workers)
+		{
+			worker->executedTasks = 0;
+			worker->stolenTasks = 0;
+			worker->busyNanoseconds = 0;
+		}
+		m_statisticsStart = std::chrono::steady_clock::now();
+	}
+
+
+	void TaskScheduler::workerLoop(size_t workerIndex)
+	{
+		AT_PROFILING_THREAD("TaskScheduler Worker");
+		t_currentScheduler = this;
+		t_currentWorkerIndex = workerIndex;
+
+		Task task;
+		while (true)
+		{
+			// Read before looking for a task, so a task that gets queued or unblocked afterwards always wakes the worker
+			size_t wakeUpCount = m_wakeUpCount.load();
+			if (popTask(workerIndex, task))
+			{
+				executeTask(task, workerIndex);
+				continue;
+			}
+
+			// Queued tasks may all belong to groups at their concurrency limit, then the worker sleeps until a slot frees up
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_wakeUp.wait(lock, [this, wakeUpCount] {
+				return m_stop.load() || (m_queuedTasks.load() > 0 && m_wakeUpCount.load() != wakeUpCount);
+				});
+			if (m_stop)
+				return;
+		}
+	}
+
+	void TaskScheduler::wakeUpWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			++m_wakeUpCount;
+		}
+		m_wakeUp.notify_all();
+	}
+
+	bool TaskScheduler::popTask(size_t workerIndex, Task& task)
+	{
+		if (m_queuedTasks.load() == 0)
+			return false;
+
+		// Own queue, newest task first
+		if (workerIndex < m_workers.size())
+		{
+			Worker* worker = m_workers[workerIndex];
+			std::lock_guard<std::mutex> lock(worker->mutex);
+			for (size_t i = worker->tasks.size(); i > 0; --i)
+			{
+				task = worker->tasks[i - 1];
+				if (tryTakeTask(task))
+				{
+					worker->tasks.erase(worker->tasks.begin() + (i - 1));
+					--m_queuedTasks;
+					return true;
+				}
+			}
+		}
+
+		// Jobs from outside of the pool
+		if (popInjectedTask(task))
+			return true;
+
+		// Steal the oldest task of another worker
+		size_t workerCount = m_workers.size();
+		for (size_t i = 1; i < workerCount; ++i)
+		{
+			Worker* victim = m_workers[(workerIndex + i) % workerCount];
+			std::lock_guard<std::mutex> lock(victim->mutex);
+			for (size_t j = 0; j < victim->tasks.size(); ++j)
+			{
+				task = victim->tasks[j];
+				if (tryTakeTask(task))
+				{
+					victim->tasks.erase(victim->tasks.begin() + j);
+					--m_queuedTasks;
+					if (workerIndex < workerCount)
+						++m_workers[workerIndex]->stolenTasks;
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	bool TaskScheduler::popInjectedTask(Task& task)
+	{
+		std::lock_guard<std::mutex> lock(m_injectMutex);
+		const size_t jobCount = m_injectedJobs.size();
+		if (jobCount == 0)
+			return false;
+
+		// The highest priority wins, the search starts after the last served job so equal priorities take turns
+		size_t bestIndex = jobCount;
+		int bestPriority = 0;
+		for (size_t i = 0; i < jobCount; ++i)
+		{
+			size_t index = (m_nextInjectedJob + i) % jobCount;
+			const Group* group = m_injectedJobs[index]->group;
+			int priority = group->getPriority();
+			if (bestIndex < jobCount && priority <= bestPriority)
+				continue;
+			size_t maxConcurrency = group->getMaxConcurrency();
+			if (maxConcurrency != 0 && group->getActiveWorkerCount() >= maxConcurrency && !isExecutingGroup(group))
+				continue;
+			bestIndex = index;
+			bestPriority = priority;
+		}
+		if (bestIndex == jobCount)
+			return false;
+
+		Job* job = m_injectedJobs[bestIndex];
+		task.job = job;
+		task.begin = job->nextBegin;
+		task.end = std::min(job->nextBegin + job->grainSize, job->count);
+		if (!tryTakeTask(task))
+			return false;	// Another worker took the last free slot, its release wakes this worker up again
+
+		job->nextBegin = task.end;
+		m_nextInjectedJob = bestIndex + 1;
+		if (job->nextBegin >= job->count)
+		{
+			m_injectedJobs.erase(m_injectedJobs.begin() + bestIndex);
+			m_nextInjectedJob = bestIndex;
+		}
+		--m_queuedTasks;
+		return true;
+	}
+
+	bool TaskScheduler::tryTakeTask(Task& task)
+	{
+		// A thread that already executes a task of the group does not add concurrency,
+		// it has to run the nested tasks of its group or it would wait for itself
+		if (isExecutingGroup(task.job->group))
+		{
+			task.countsForGroup = false;
+			return true;
+		}
+		task.countsForGroup = task.job->group->tryAcquire();
+		return task.countsForGroup;
+	}
+
+	void TaskScheduler::executeTask(const Task& task, size_t workerIndex)
+	{
+		AT_GENERAL_PROFILING_BLOCK("TaskScheduler Task", AT_COLOR_STAGE_1);
+		Job* job = task.job;
+		Group* group = job->group;
+		auto start = std::chrono::steady_clock::now();
+		t_groupStack.push_back(group);
+		try
+		{
+			(*job->func)(task.begin, task.end, workerIndex);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(job->mutex);
+			if (!job->exception)
+				job->exception = std::current_exception();
+		}
+		t_groupStack.pop_back();
+		auto elapsed = std::chrono::steady_clock::now() - start;
+
+		// Released before the job can finish, the group must not be touched after its last job returned
+		if (task.countsForGroup)
+		{
+			group->release();
+			if (group->getMaxConcurrency() != 0 && m_queuedTasks.load() > 0)
+				wakeUpWorkers();
+		}
+
+		Worker* worker = m_workers[workerIndex];
+		worker->busyNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+		++worker->executedTasks;
+
+		if (job->remainingTasks.fetch_sub(1) == 1)
+		{
+			std::lock_guard<std::mutex> lock(job->mutex);
+			job->isFinished = true;
+			job->finished.notify_all();
+		}
+	}
+
+	void TaskScheduler::waitForJob(Job& job, size_t workerIndex)
+	{
+		if (workerIndex < m_workers.size())
+		{
+			// Help out instead of blocking a worker
+			Task task;
+			while (job.remainingTasks.load() > 0)
+			{
+				if (popTask(workerIndex, task))
+					executeTask(task, workerIndex);
+				else
+					std::this_thread::yield();
+			}
+		}
+
+		// Also makes sure the last task has released the job before it goes out of scope
+		std::unique_lock<std::mutex> lock(job.mutex);
+		job.finished.wait(lock, [&job] { return job.isFinished; });
+	}
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "AutoTuner.h"
+#include <memory>
+
+
+/**
+ * @brief
+ * Closed loop of a PID controller and an arbitrary plant.
+ * Inputs: (reference, disturbance), output 0 is the plant output.
+ * The plant gets (u, disturbance) as its inputs 0 and 1.
+ *
+ * getFrequencyResponse() returns the open loop response PID * plant,
+ * which is what FrequencyResponse needs for the gain and phase margins.
+ */
+class ControlLoop : public AutoTuner::TimeBasedSystem
+{
+public:
+	/**
+	 * @param plant gets owned by the loop
+	 */
+	ControlLoop(AutoTuner::TimeBasedSystem* plant)
+		: AutoTuner::TimeBasedSystem()
+		, m_plant(plant)
+	{
+	}
+	ControlLoop(const ControlLoop& other)
+		: AutoTuner::TimeBasedSystem(other)
+		, m_pid(other.m_pid)
+		, m_plant(other.m_plant ? other.m_plant->clone() : nullptr)
+		, m_referenceValue(other.m_referenceValue)
+		, m_disturbanceValue(other.m_disturbanceValue)
+		, m_errorValue(other.m_errorValue)
+		, m_pidOutputValue(other.m_pidOutputValue)
+	{
+	}
+	TimeBasedSystem* clone() override
+	{
+		return new ControlLoop(*this);
+	}
+
+	void reset() override
+	{
+		m_pid.reset();
+		m_plant->reset();
+		m_referenceValue = 0;
+		m_disturbanceValue = 0;
+		m_errorValue = 0;
+		m_pidOutputValue = 0;
+	}
+
+	void setInputSignals(double u) override
+	{
+		m_referenceValue = u;
+		m_disturbanceValue = 0;
+	}
+	void setInputSignal(size_t input, double value) override
+	{
+		if (input == 0)
+			m_referenceValue = value;
+		else if (input == 1)
+			m_disturbanceValue = value;
+	}
+	void setInputSignals(const std::vector<double>& u) override
+	{
+		if (u.size() >= 2)
+		{
+			m_referenceValue = u[0];
+			m_disturbanceValue = u[1];
+		}
+	}
+	void setInputSignals(double referenceValue, double disturbanceValue)
+	{
+		m_referenceValue = referenceValue;
+		m_disturbanceValue = disturbanceValue;
+	}
+
+	void update(double deltaTime) override
+	{
+		m_errorValue = m_referenceValue - m_plant->getOutput(0);	// e(t) = r(t) - y(t)
+		m_pid.setInput(m_errorValue);
+		m_pid.update(deltaTime);
+		m_pidOutputValue = m_pid.getOutput();						// u(t)
+
+		m_plant->setInputSignal(0, m_pidOutputValue);
+		m_plant->setInputSignal(1, m_disturbanceValue);
+		m_plant->update(deltaTime);
+	}
+
+	std::vector<double> getInputs() const override
+	{
+		return { m_referenceValue, m_disturbanceValue };
+	}
+	std::vector<double> getOutputs() const override
+	{
+		return { m_plant->getOutput(0) };
+	}
+	double getOutput(size_t index) const override
+	{
+		return m_plant->getOutput(index);
+	}
+	double getInput(size_t index) const override
+	{
+		if (index == 0)
+			return m_referenceValue;
+		else if (index == 1)
+			return m_disturbanceValue;
+		return 0.0;
+	}
+
+	bool getFrequencyResponse(double omega, size_t inputIndex, size_t outputIndex, std::complex<double>& response) override
+	{
+		std::complex<double> pidResponse;
+		std::complex<double> plantResponse;
+		if (inputIndex != 0 ||
+			!m_pid.getFrequencyResponse(omega, 0, 0, pidResponse) ||
+			!m_plant->getFrequencyResponse(omega, 0, outputIndex, plantResponse))
+			return false;
+		response = pidResponse * plantResponse;
+		return true;
+	}
+
+	AutoTuner::PID& getPID() { return m_pid; }
+	AutoTuner::TimeBasedSystem& getPlant() { return *m_plant; }
+
+	double getError() const { return m_errorValue; }
+	double getPIDOutput() const { return m_pidOutputValue; }
+
+private:
+	AutoTuner::PID m_pid;
+	std::unique_ptr<AutoTuner::TimeBasedSystem> m_plant;
+	double m_referenceValue = 0;
+	double m_disturbanceValue = 0;
+	double m_errorValue = 0;
+	double m_pidOutputValue = 0;
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "AutoTuner.h"
+
+
+/**
+ * @brief
+ * PID tuning job for the command line tuner.
+ * The job file contains one "key = value" pair per line, '#' starts a comment.
+ * The PID keys use the names of PIDTuningProblem::SetupSettings.
+ *
+ * Value formats:
+ *   bool:      true / false / 1 / 0
+ *   matrix:    rows separated by ';', elements by ',' or spaces.  A = -1 0; 0 -2
+ *   sequence:  time:value pairs separated by ','.                 steps = 0:0, 0.5:1, 1:0
+ */
+struct TuningJob
+{
+	enum class PlantType
+	{
+		DCMotor,	// DCMotorSystem of the SimpleMotorTuner example
+		StateSpace	// Inputs (u, disturbance), output 0 is controlled
+	};
+	enum class SolverType
+	{
+		GeneticAlgorithm,
+		DifferentialEvolution,
+		CMAES,
+		NSGA2
+	};
+	struct SignalPoint
+	{
+		double time = 0;
+		double value = 0;
+	};
+
+	// Plant
+	PlantType plantType = PlantType::DCMotor;
+	MatlabAPI::Matrix A;
+	MatlabAPI::Matrix B;
+	MatlabAPI::Matrix C;
+	MatlabAPI::Matrix D;
+	AutoTuner::TimeBasedSystem::IntegrationSolver plantIntegrationSolver = AutoTuner::TimeBasedSystem::IntegrationSolver::Bilinear;
+	double actuatorInputLimit = 10;
+	double systemInputLimit = 10;
+
+	// PID structure, see PIDTuningProblem::SetupSettings
+	bool useKn = true;
+	bool optimizeKp = true;
+	bool optimizeKi = true;
+	bool optimizeKd = true;
+	bool optimizeKn = true;
+	bool optimizeIntegralSaturation = false;
+	bool optimizeAntiWindupBackCalculationConstant = false;
+
+	double defaultKp = 1.0;
+	double defaultKi = 1.0;
+	double defaultKd = 1.0;
+	double defaultKn = 1.0;
+	double defaultPIDISaturation = 10;
+	double defaultPIDAntiWindupBackCalculationConstant = 0.1;
+
+	AutoTuner::PID::AntiWindupMethod defaultPIDAntiWindupMethod = AutoTuner::PID::AntiWindupMethod::Clamping;
+	AutoTuner::PID::IntegrationSolver defaultPIDIntegrationSolver = AutoTuner::PID::IntegrationSolver::ForwardEuler;
+	AutoTuner::PID::DerivativeType defaultPIDDerivativeType = AutoTuner::PID::DerivativeType::Filtered;
+	bool disableErrorIntegrationWhenSaturated = true;
+
+	// Simulation
+	double endTime = 20;
+	double deltaTime = 0.01;
+	std::vector<SignalPoint> steps;
+	std::vector<SignalPoint> disturbances;
+
+	// Tuning goal
+	double errorIntegralWeight = 3.8;
+	double actuatorEffortWeight = 0.038;
+	double overshootWeight = 111;
+	double gainMarginWeight = 0;
+	double phaseMarginWeight = 0;
+	double targetGainMargin = 2;
+	double targetPhaseMargin = M_PI / 2;
+	double nyquistBeginFreq = 0.1;
+	double nyquistEndFreq = 1000;
+
+	// Solver
+	SolverType solverType = SolverType::GeneticAlgorithm;
+	size_t agentCount = 30;
+	size_t targetEpochs = 5000;
+	double startAreaRange = 10;
+	double startLearningRate = 1;
+	uint64_t seed = AutoTuner::RandomStream::s_defaultSeed;
+	size_t threadCount = 0; // 0 uses the default scheduler with all cores
+	size_t fitnessCacheCapacity = 10000;
+	bool useRacing = true;
+	size_t surrogatePoolSize = 1;
+	bool useSteadyStateGenetic = false;
+
+	// Convergence: stops once the best score did not improve by more than the relative tolerance for convergenceEpochs epochs, 0 disables the check
+	size_t convergenceEpochs = 200;
+	double convergenceTolerance = 1e-6;
+
+	// Output
+	std::string outputFolder = "results";
+	std::string resultName = "tuning";
+
+	TuningJob();
+
+	/**
+	 * @brief
+	 * Reads the job from a file. Keys that are not in the file keep their current value.
+	 * @param error receives the file position and the reason if the file could not be read
+	 * @return true if the whole file was valid
+	 */
+	bool loadFromFile(const std::string& path, std::string& error);
+
+	/**
+	 * @brief
+	 * Sets a single key, the same way a line of the job file does
+	 */
+	bool setValue(const std::string& key, const std::string& value, std::string& error);
+
+	/**
+	 * @brief
+	 * Names of the optimized parameters, in the order of the solvers parameter vector
+	 */
+	std::vector<std::string> getParameterNames() const;
+};
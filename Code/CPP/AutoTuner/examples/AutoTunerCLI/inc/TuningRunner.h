@@ -0,0 +1,76 @@
+#pragma once
+
+#include "TuningJob.h"
+#include "ControlLoop.h"
+
+
+/**
+ * @brief
+ * Runs a TuningJob without a window or frame loop.
+ * The solver runs back to back epochs on all workers of its TaskScheduler
+ * until the target epoch count is reached or the best score converged.
+ *
+ * The agents are scored like DCMotorProblem::agentTestFunction, always as minimized error.
+ */
+class TuningRunner
+{
+public:
+	struct HistoryEntry
+	{
+		double bestScore = 0;
+		double averageScore = 0;
+		double worstScore = 0;
+		std::vector<double> bestParameters;
+	};
+
+	TuningRunner(const TuningJob& job);
+	~TuningRunner();
+
+	/**
+	 * @brief
+	 * Runs the solver until the target epoch count or the convergence is reached
+	 * @return number of run epochs
+	 */
+	size_t run();
+
+	/**
+	 * @brief
+	 * Writes best_parameters.csv and learning_history.csv to <outputFolder>/<resultName>
+	 * @return true if both files were written
+	 */
+	bool exportResults() const;
+
+	const std::vector<HistoryEntry>& getHistory() const { return m_history; }
+	std::vector<double> getBestParameters() const;
+	double getBestScore() const { return m_bestScore; }
+	bool hasConverged() const { return m_converged; }
+	AutoTuner::Solver* getSolver() const { return m_solver; }
+
+	/**
+	 * @brief
+	 * Scores the parameters of one agent, called in parallel by the solver
+	 */
+	std::vector<double> agentTestFunction(const std::vector<double>& parameters, size_t agent);
+
+private:
+	AutoTuner::Solver* createSolver() const;
+	AutoTuner::TimeBasedSystem* createPlant() const;
+	void setupPopulation();
+	void setPIDParameters(AutoTuner::PID& pid, const std::vector<double>& parameters) const;
+
+	/**
+	 * @return false once the run converged
+	 */
+	bool onEpoch(size_t epoch);
+
+	TuningJob m_job;
+	AutoTuner::Solver* m_solver = nullptr;
+	AutoTuner::TaskScheduler* m_taskScheduler = nullptr;
+	ControlLoop m_loopPrototype;
+	AutoTuner::FrequencyResponse m_frequencyResponse;
+
+	std::vector<HistoryEntry> m_history;
+	double m_bestScore = std::numeric_limits<double>::infinity();
+	size_t m_lastImprovementEpoch = 0;
+	bool m_converged = false;
+};
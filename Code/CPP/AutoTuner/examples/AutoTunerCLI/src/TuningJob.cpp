@@ -0,0 +1,354 @@
+#include "TuningJob.h"
+#include <fstream>
+#include <sstream>
+#include <cctype>
+#include <cstdlib>
+
+namespace
+{
+	std::string trim(const std::string& text)
+	{
+		const char* whitespace = " \t\r\n";
+		size_t begin = text.find_first_not_of(whitespace);
+		if (begin == std::string::npos)
+			return "";
+		size_t end = text.find_last_not_of(whitespace);
+		return text.substr(begin, end - begin + 1);
+	}
+
+	std::string toLower(std::string text)
+	{
+		std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return text;
+	}
+
+	std::vector<std::string> split(const std::string& text, char delimiter)
+	{
+		std::vector<std::string> parts;
+		std::stringstream stream(text);
+		std::string part;
+		while (std::getline(stream, part, delimiter))
+		{
+			part = trim(part);
+			if (!part.empty())
+				parts.push_back(part);
+		}
+		return parts;
+	}
+
+	bool parseDouble(const std::string& text, double& value)
+	{
+		std::string trimmed = trim(text);
+		char* end = nullptr;
+		value = std::strtod(trimmed.c_str(), &end);
+		return !trimmed.empty() && end == trimmed.c_str() + trimmed.size();
+	}
+
+	bool parseSize(const std::string& text, size_t& value)
+	{
+		double number;
+		if (!parseDouble(text, number) || number < 0)
+			return false;
+		value = static_cast<size_t>(number);
+		return true;
+	}
+
+	bool parseBool(const std::string& text, bool& value)
+	{
+		std::string lower = toLower(trim(text));
+		if (lower == "true" || lower == "1" || lower == "yes" || lower == "on")
+			value = true;
+		else if (lower == "false" || lower == "0" || lower == "no" || lower == "off")
+			value = false;
+		else
+			return false;
+		return true;
+	}
+
+	bool parseMatrix(const std::string& text, MatlabAPI::Matrix& matrix)
+	{
+		std::vector<std::vector<double>> rows;
+		for (const std::string& rowText : split(text, ';'))
+		{
+			std::string elements = rowText;
+			std::replace(elements.begin(), elements.end(), ',', ' ');
+			std::stringstream stream(elements);
+			std::vector<double> row;
+			std::string element;
+			while (stream >> element)
+			{
+				double value;
+				if (!parseDouble(element, value))
+					return false;
+				row.push_back(value);
+			}
+			if (!rows.empty() && rows[0].size() != row.size())
+				return false;
+			rows.push_back(row);
+		}
+		if (rows.empty() || rows[0].empty())
+			return false;
+
+		matrix = MatlabAPI::Matrix(rows.size(), rows[0].size());
+		for (size_t i = 0; i < rows.size(); ++i)
+			for (size_t j = 0; j < rows[i].size(); ++j)
+				matrix(i, j) = rows[i][j];
+		return true;
+	}
+
+	bool parseSequence(const std::string& text, std::vector<TuningJob::SignalPoint>& sequence)
+	{
+		sequence.clear();
+		for (const std::string& pointText : split(text, ','))
+		{
+			size_t separator = pointText.find(':');
+			TuningJob::SignalPoint point;
+			if (separator == std::string::npos ||
+				!parseDouble(pointText.substr(0, separator), point.time) ||
+				!parseDouble(pointText.substr(separator + 1), point.value))
+				return false;
+			if (!sequence.empty() && point.time < sequence.back().time)
+				return false;
+			sequence.push_back(point);
+		}
+		return true;
+	}
+}
+
+TuningJob::TuningJob()
+{
+	// Same sequences as the DCMotorProblem of the SimpleMotorTuner example
+	steps = { {0.0,0.0}, {0.5,1.0}, {1.0,0.0}, {1.5,5.0}, {2.5,0.0}, {3.5,8.0}, {4.5,0.0}, {5.5,9.0}, {6.25,0.0}, {6.5,2.0}, {7,0.0}, {7.5,2.0}, {8,0.0}, {8.5,2.0}, {9,0.0},
+		{10.0, 5.0}, {15, 7.0}, {20.5, 7.0}
+	};
+	disturbances = {
+		{0 , 0}, {11, 1}, {12, 2}, {13, 0}, {14, 2}, {14.5, 0}, {15, 2}, {15.5, 0},
+		{16, 2}, {16.5, 0}, {17, 2}, {17.5, 0}, {18, 2}, {18.5, 0}, {19, 2}, {19.5, 0},
+	};
+}
+
+bool TuningJob::loadFromFile(const std::string& path, std::string& error)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		error = "Can't open job file: " + path;
+		return false;
+	}
+
+	std::string line;
+	size_t lineNumber = 0;
+	while (std::getline(file, line))
+	{
+		++lineNumber;
+		size_t comment = line.find('#');
+		if (comment != std::string::npos)
+			line.erase(comment);
+		line = trim(line);
+		if (line.empty())
+			continue;
+
+		size_t separator = line.find('=');
+		if (separator == std::string::npos)
+		{
+			error = path + ":" + std::to_string(lineNumber) + ": expected \"key = value\"";
+			return false;
+		}
+		std::string valueError;
+		if (!setValue(trim(line.substr(0, separator)), trim(line.substr(separator + 1)), valueError))
+		{
+			error = path + ":" + std::to_string(lineNumber) + ": " + valueError;
+			return false;
+		}
+	}
+
+	if (plantType == PlantType::StateSpace)
+	{
+		if (A.getRows() == 0 || A.getRows() != A.getCols() ||
+			B.getRows() != A.getRows() || C.getCols() != A.getRows() ||
+			D.getRows() != C.getRows() || D.getCols() != B.getCols())
+		{
+			error = path + ": the state space matrices A, B, C, D have mismatching dimensions";
+			return false;
+		}
+	}
+	if (getParameterNames().empty())
+	{
+		error = path + ": no PID parameter is optimized";
+		return false;
+	}
+	if (deltaTime <= 0 || endTime <= deltaTime)
+	{
+		error = path + ": endTime has to be larger than deltaTime > 0";
+		return false;
+	}
+	return true;
+}
+
+bool TuningJob::setValue(const std::string& key, const std::string& value, std::string& error)
+{
+	bool valid = true;
+	std::string lowerValue = toLower(value);
+
+	// Plant
+	if (key == "plant")
+	{
+		if (lowerValue == "dcmotor" || lowerValue == "dcmotorsystem")
+			plantType = PlantType::DCMotor;
+		else if (lowerValue == "statespace")
+			plantType = PlantType::StateSpace;
+		else
+			valid = false;
+	}
+	else if (key == "A") valid = parseMatrix(value, A);
+	else if (key == "B") valid = parseMatrix(value, B);
+	else if (key == "C") valid = parseMatrix(value, C);
+	else if (key == "D") valid = parseMatrix(value, D);
+	else if (key == "plantIntegrationSolver")
+	{
+		if (lowerValue == "forwardeuler")
+			plantIntegrationSolver = AutoTuner::TimeBasedSystem::IntegrationSolver::ForwardEuler;
+		else if (lowerValue == "backwardeuler")
+			plantIntegrationSolver = AutoTuner::TimeBasedSystem::IntegrationSolver::BackwardEuler;
+		else if (lowerValue == "bilinear")
+			plantIntegrationSolver = AutoTuner::TimeBasedSystem::IntegrationSolver::Bilinear;
+		else if (lowerValue == "rk4")
+			plantIntegrationSolver = AutoTuner::TimeBasedSystem::IntegrationSolver::Rk4;
+		else if (lowerValue == "discretized")
+			plantIntegrationSolver = AutoTuner::TimeBasedSystem::IntegrationSolver::Discretized;
+		else
+			valid = false;
+	}
+	else if (key == "actuatorInputLimit") valid = parseDouble(value, actuatorInputLimit);
+	else if (key == "systemInputLimit") valid = parseDouble(value, systemInputLimit);
+
+	// PID structure
+	else if (key == "useKn") valid = parseBool(value, useKn);
+	else if (key == "optimizeKp") valid = parseBool(value, optimizeKp);
+	else if (key == "optimizeKi") valid = parseBool(value, optimizeKi);
+	else if (key == "optimizeKd") valid = parseBool(value, optimizeKd);
+	else if (key == "optimizeKn") valid = parseBool(value, optimizeKn);
+	else if (key == "optimizeIntegralSaturation") valid = parseBool(value, optimizeIntegralSaturation);
+	else if (key == "optimizeAntiWindupBackCalculationConstant") valid = parseBool(value, optimizeAntiWindupBackCalculationConstant);
+	else if (key == "defaultKp") valid = parseDouble(value, defaultKp);
+	else if (key == "defaultKi") valid = parseDouble(value, defaultKi);
+	else if (key == "defaultKd") valid = parseDouble(value, defaultKd);
+	else if (key == "defaultKn") valid = parseDouble(value, defaultKn);
+	else if (key == "defaultPIDISaturation") valid = parseDouble(value, defaultPIDISaturation);
+	else if (key == "defaultPIDAntiWindupBackCalculationConstant") valid = parseDouble(value, defaultPIDAntiWindupBackCalculationConstant);
+	else if (key == "defaultPIDAntiWindupMethod")
+	{
+		if (lowerValue == "none")
+			defaultPIDAntiWindupMethod = AutoTuner::PID::AntiWindupMethod::None;
+		else if (lowerValue == "clamping")
+			defaultPIDAntiWindupMethod = AutoTuner::PID::AntiWindupMethod::Clamping;
+		else if (lowerValue == "backcalculation")
+			defaultPIDAntiWindupMethod = AutoTuner::PID::AntiWindupMethod::BackCalculation;
+		else
+			valid = false;
+	}
+	else if (key == "defaultPIDIntegrationSolver")
+	{
+		if (lowerValue == "forwardeuler")
+			defaultPIDIntegrationSolver = AutoTuner::PID::IntegrationSolver::ForwardEuler;
+		else if (lowerValue == "backwardeuler")
+			defaultPIDIntegrationSolver = AutoTuner::PID::IntegrationSolver::BackwardEuler;
+		else if (lowerValue == "bilinear")
+			defaultPIDIntegrationSolver = AutoTuner::PID::IntegrationSolver::Bilinear;
+		else
+			valid = false;
+	}
+	else if (key == "defaultPIDDerivativeType")
+	{
+		if (lowerValue == "unfiltered")
+			defaultPIDDerivativeType = AutoTuner::PID::DerivativeType::Unfiltered;
+		else if (lowerValue == "filtered")
+			defaultPIDDerivativeType = AutoTuner::PID::DerivativeType::Filtered;
+		else
+			valid = false;
+	}
+	else if (key == "disableErrorIntegrationWhenSaturated") valid = parseBool(value, disableErrorIntegrationWhenSaturated);
+
+	// Simulation
+	else if (key == "endTime") valid = parseDouble(value, endTime);
+	else if (key == "deltaTime") valid = parseDouble(value, deltaTime);
+	else if (key == "steps") valid = parseSequence(value, steps);
+	else if (key == "disturbances") valid = parseSequence(value, disturbances);
+
+	// Tuning goal
+	else if (key == "errorIntegralWeight") valid = parseDouble(value, errorIntegralWeight);
+	else if (key == "actuatorEffortWeight") valid = parseDouble(value, actuatorEffortWeight);
+	else if (key == "overshootWeight") valid = parseDouble(value, overshootWeight);
+	else if (key == "gainMarginWeight") valid = parseDouble(value, gainMarginWeight);
+	else if (key == "phaseMarginWeight") valid = parseDouble(value, phaseMarginWeight);
+	else if (key == "targetGainMargin") valid = parseDouble(value, targetGainMargin);
+	else if (key == "targetPhaseMargin") valid = parseDouble(value, targetPhaseMargin);
+	else if (key == "nyquistBeginFreq") valid = parseDouble(value, nyquistBeginFreq);
+	else if (key == "nyquistEndFreq") valid = parseDouble(value, nyquistEndFreq);
+
+	// Solver
+	else if (key == "solverType")
+	{
+		if (lowerValue == "ga" || lowerValue == "genetic" || lowerValue == "geneticalgorithm")
+			solverType = SolverType::GeneticAlgorithm;
+		else if (lowerValue == "de" || lowerValue == "differentialevolution")
+			solverType = SolverType::DifferentialEvolution;
+		else if (lowerValue == "cmaes")
+			solverType = SolverType::CMAES;
+		else if (lowerValue == "nsga2")
+			solverType = SolverType::NSGA2;
+		else
+			valid = false;
+	}
+	else if (key == "agentCount") valid = parseSize(value, agentCount);
+	else if (key == "targetEpochs") valid = parseSize(value, targetEpochs);
+	else if (key == "startAreaRange") valid = parseDouble(value, startAreaRange);
+	else if (key == "startLearningRate") valid = parseDouble(value, startLearningRate);
+	else if (key == "seed")
+	{
+		size_t parsedSeed = 0;
+		valid = parseSize(value, parsedSeed);
+		seed = parsedSeed;
+	}
+	else if (key == "threadCount") valid = parseSize(value, threadCount);
+	else if (key == "fitnessCacheCapacity") valid = parseSize(value, fitnessCacheCapacity);
+	else if (key == "useRacing") valid = parseBool(value, useRacing);
+	else if (key == "surrogatePoolSize") valid = parseSize(value, surrogatePoolSize);
+	else if (key == "useSteadyStateGenetic") valid = parseBool(value, useSteadyStateGenetic);
+	else if (key == "convergenceEpochs") valid = parseSize(value, convergenceEpochs);
+	else if (key == "convergenceTolerance") valid = parseDouble(value, convergenceTolerance);
+
+	// Output
+	else if (key == "outputFolder") outputFolder = value;
+	else if (key == "resultName") resultName = value;
+	else
+	{
+		error = "unknown key \"" + key + "\"";
+		return false;
+	}
+
+	if (!valid)
+	{
+		error = "invalid value \"" + value + "\" for key \"" + key + "\"";
+		return false;
+	}
+	return true;
+}
+
+std::vector<std::string> TuningJob::getParameterNames() const
+{
+	std::vector<std::string> names;
+	if (optimizeKp)
+		names.push_back("Kp");
+	if (optimizeKi)
+		names.push_back("Ki");
+	if (optimizeKd)
+		names.push_back("Kd");
+	if (optimizeKn && useKn)
+		names.push_back("Kn");
+	if (optimizeIntegralSaturation)
+		names.push_back("IntegralSaturation");
+	if (optimizeAntiWindupBackCalculationConstant)
+		names.push_back("AntiWindupBackCalculationConstant");
+	return names;
+}
@@ -0,0 +1,353 @@
+#include "TuningRunner.h"
+#include "Systems/DCMotorSystem.h"
+#include <iostream>
+
+TuningRunner::TuningRunner(const TuningJob& job)
+	: m_job(job)
+	, m_loopPrototype(createPlant())
+{
+	AutoTuner::PID& pid = m_loopPrototype.getPID();
+	pid.setIntegrationSolver(m_job.defaultPIDIntegrationSolver);
+	pid.setOutputSaturationLimits(0, m_job.actuatorInputLimit);
+	pid.setAntiWindupMethod(m_job.defaultPIDAntiWindupMethod);
+	pid.setDerivativeType(m_job.defaultPIDDerivativeType);
+	m_loopPrototype.reset();
+
+	// The loop provides its open loop response, no simulation needed for the margins
+	m_frequencyResponse.setMethod(AutoTuner::FrequencyResponse::Method::Analytic);
+
+	if (m_job.threadCount > 0)
+		m_taskScheduler = new AutoTuner::TaskScheduler(m_job.threadCount);
+
+	m_solver = createSolver();
+	m_solver->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Minimize);
+	m_solver->setSeed(m_job.seed);
+	if (m_taskScheduler)
+		m_solver->setTaskScheduler(m_taskScheduler);
+	m_solver->setParametersTestFunc(std::bind(&TuningRunner::agentTestFunction, this, std::placeholders::_1, std::placeholders::_2));
+	m_solver->setFitnessCacheCapacity(m_job.fitnessCacheCapacity);
+	m_solver->setRacingEnabled(m_job.useRacing);
+	m_solver->setSurrogatePoolSize(m_job.surrogatePoolSize);
+	m_solver->setScorePartsLabels({ "error", "pidOutChange", "Overshoot", "GainMargin", "PhaseMargin" });
+
+	setupPopulation();
+}
+TuningRunner::~TuningRunner()
+{
+	delete m_solver;
+	delete m_taskScheduler;
+}
+
+size_t TuningRunner::run()
+{
+	m_history.clear();
+	m_history.reserve(m_job.targetEpochs);
+	m_bestScore = std::numeric_limits<double>::infinity();
+	m_lastImprovementEpoch = 0;
+	m_converged = false;
+	return m_solver->run(m_job.targetEpochs, [this](size_t epoch) { return onEpoch(epoch); });
+}
+
+bool TuningRunner::exportResults() const
+{
+	std::string folderPath = m_job.outputFolder + "/" + m_job.resultName;
+	std::vector<std::string> parameterNames = m_job.getParameterNames();
+	bool success = true;
+	{
+		AutoTuner::CSVExport bestParametersCSV;
+		std::vector<std::string> labels = parameterNames;
+		labels.push_back("Score");
+		bestParametersCSV.setHeader(labels);
+
+		std::vector<double> row = getBestParameters();
+		row.push_back(m_bestScore);
+		bestParametersCSV.addRow(row);
+		success &= bestParametersCSV.exportToFile(folderPath + "/best_parameters.csv", ';');
+	}
+
+	{
+		AutoTuner::CSVExport learningHistoryCSV;
+		std::vector<std::string> labels = { "Epoch", "Best", "Average", "Worst" };
+		std::vector<AutoTuner::CSVExport::LineStyle> lineStyles(3, AutoTuner::CSVExport::LineStyle::Solid);
+		std::vector<sf::Color> lineColors = { sf::Color(50, 200, 50), sf::Color(50, 50, 200), sf::Color(200, 50, 50) };
+		std::vector<int> lineThicknesses = { 2, 1, 1 };
+		for (const std::string& name : parameterNames)
+		{
+			labels.push_back(name);
+			lineStyles.push_back(AutoTuner::CSVExport::LineStyle::Dashed);
+			lineColors.push_back(sf::Color::Black);
+			lineThicknesses.push_back(1);
+		}
+
+		learningHistoryCSV.setHeader(labels);
+		learningHistoryCSV.setYAxisLabel("Error");
+		learningHistoryCSV.setLineStyles(lineStyles);
+		learningHistoryCSV.setLineColors(lineColors);
+		learningHistoryCSV.setLineThicknesses(lineThicknesses);
+
+		for (size_t i = 0; i < m_history.size(); ++i)
+		{
+			const HistoryEntry& entry = m_history[i];
+			std::vector<double> row = { static_cast<double>(i), entry.bestScore, entry.averageScore, entry.worstScore };
+			row.insert(row.end(), entry.bestParameters.begin(), entry.bestParameters.end());
+			learningHistoryCSV.addRow(row);
+		}
+		success &= learningHistoryCSV.exportToFile(folderPath + "/learning_history.csv", ';');
+	}
+	return success;
+}
+
+std::vector<double> TuningRunner::getBestParameters() const
+{
+	return m_solver->getAlltimeBestParameters();
+}
+
+std::vector<double> TuningRunner::agentTestFunction(const std::vector<double>& parameters, size_t agent)
+{
+	AT_UNUSED(agent);
+	AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_2);
+	const double dt = m_job.deltaTime;
+	const double endTime = m_job.endTime;
+	const double actuatorLimit = m_job.actuatorInputLimit;
+	const double systemInputLimit = m_job.systemInputLimit;
+
+	ControlLoop loop(m_loopPrototype);
+	setPIDParameters(loop.getPID(), parameters);
+
+	std::vector<double> losses = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+	if (m_job.gainMarginWeight != 0 || m_job.phaseMarginWeight != 0)
+	{
+		AutoTuner::FrequencyResponse::FrequencyResponseData responseData = m_frequencyResponse.getResponse(loop,
+			m_job.nyquistBeginFreq, m_job.nyquistEndFreq);
+		losses[3] = std::abs(m_job.targetGainMargin - responseData.gainMargin) * m_job.gainMarginWeight;
+		losses[4] = std::abs(m_job.targetPhaseMargin - responseData.phaseMargin) * m_job.phaseMarginWeight;
+	}
+
+	double r = 0;
+	double disturbance = 0;
+	double lastPIDOutput = 0.0;
+	double errorSum = 0.0;
+	double overshootSum = 0.0;
+	double pidOutChangeSum = 0.0;
+	double lastY = 0;
+	int rWasRising = 0;
+
+	// Racing: stop once the partial score is worse than the solvers threshold
+	const bool racing = m_solver->isRacingEnabled();
+	const size_t updateCount = static_cast<size_t>(std::ceil(endTime / dt));
+	const size_t racingCheckInterval = std::max<size_t>(1, updateCount / 100);
+	size_t step = 0;
+
+	size_t nextStepIndex = 0;
+	size_t nextDisturbanceIndex = 0;
+	for (double t = 0; t < endTime; t += dt)
+	{
+		if (nextStepIndex < m_job.steps.size() && t >= m_job.steps[nextStepIndex].time)
+		{
+			r = m_job.steps[nextStepIndex].value;
+			rWasRising = r > lastY ? 1 : 0;
+			nextStepIndex++;
+		}
+		if (nextDisturbanceIndex < m_job.disturbances.size() && t >= m_job.disturbances[nextDisturbanceIndex].time)
+		{
+			disturbance = m_job.disturbances[nextDisturbanceIndex].value;
+			nextDisturbanceIndex++;
+		}
+
+		loop.setInputSignals(r, disturbance);
+		loop.update(dt);
+
+		double pidOutput = loop.getPIDOutput();
+		double y = loop.getOutput(0);
+
+		// Penalize large control changes
+		pidOutChangeSum += std::abs(AutoTuner::TimeBasedSystem::getDifferentiated_backwardEuler(lastPIDOutput, pidOutput, dt));
+		lastPIDOutput = pidOutput;
+
+		// Skip the error while the actuator can't do more
+		double error = loop.getError() / systemInputLimit;
+		bool isPositiveSaturated = pidOutput > actuatorLimit - 0.01;
+		bool isLowerSaturated = pidOutput < 0.01;
+		if (!m_job.disableErrorIntegrationWhenSaturated ||
+			!((isPositiveSaturated && r > y) || (isLowerSaturated && r < y)))
+			errorSum += std::abs(error);
+
+		// Overshoot after a rising step
+		if ((lastY < y) && (r < y) && rWasRising)
+		{
+			overshootSum += std::abs((y - r) / systemInputLimit);
+			rWasRising = 2;
+		}
+		else if (rWasRising == 2)
+		{
+			rWasRising = 0;
+		}
+		lastY = y;
+
+		++step;
+		if (racing && step % racingCheckInterval == 0)
+		{
+			// The sums only grow, so the partial score is a lower bound of the final score
+			double partialScore = losses[3] + losses[4] + dt / endTime * (
+				errorSum * m_job.errorIntegralWeight +
+				pidOutChangeSum * m_job.actuatorEffortWeight / actuatorLimit +
+				overshootSum * m_job.overshootWeight);
+			if (m_solver->isRaceLost(partialScore))
+			{
+				// Extrapolate to the full horizon
+				double extrapolation = static_cast<double>(updateCount) / static_cast<double>(step);
+				errorSum *= extrapolation;
+				pidOutChangeSum *= extrapolation;
+				overshootSum *= extrapolation;
+				break;
+			}
+		}
+	}
+
+	double invUpdateCount = dt / endTime;
+	losses[0] = errorSum * invUpdateCount * m_job.errorIntegralWeight;
+	losses[1] = pidOutChangeSum * invUpdateCount * m_job.actuatorEffortWeight / actuatorLimit;
+	losses[2] = overshootSum * invUpdateCount * m_job.overshootWeight;
+	return losses;
+}
+
+AutoTuner::Solver* TuningRunner::createSolver() const
+{
+	switch (m_job.solverType)
+	{
+		case TuningJob::SolverType::DifferentialEvolution:
+		{
+			AutoTuner::DifferentialEvolutionSolver* ds = new AutoTuner::DifferentialEvolutionSolver();
+			ds->setMutationAmount(m_job.startLearningRate);
+			return ds;
+		}
+		case TuningJob::SolverType::CMAES:
+		{
+			// Adapts its own step size, the learning rate is not used
+			return new AutoTuner::CMAESSolver();
+		}
+		case TuningJob::SolverType::NSGA2:
+		{
+			AutoTuner::NSGA2Solver* ns = new AutoTuner::NSGA2Solver();
+			ns->setMutationAmount(m_job.startLearningRate);
+			return ns;
+		}
+		case TuningJob::SolverType::GeneticAlgorithm:
+		default:
+		{
+			AutoTuner::GeneticSolver* gs = new AutoTuner::GeneticSolver();
+			gs->setMutationAmount(m_job.startLearningRate);
+			gs->setSteadyStateEnabled(m_job.useSteadyStateGenetic);
+			return gs;
+		}
+	}
+}
+
+AutoTuner::TimeBasedSystem* TuningRunner::createPlant() const
+{
+	AutoTuner::TimeBasedSystem* plant = nullptr;
+	switch (m_job.plantType)
+	{
+		case TuningJob::PlantType::StateSpace:
+		{
+			AutoTuner::StatespaceSystem* stateSpace = new AutoTuner::StatespaceSystem();
+			stateSpace->setStateSpaceMatrices(m_job.A, m_job.B, m_job.C, m_job.D);
+			plant = stateSpace;
+			break;
+		}
+		case TuningJob::PlantType::DCMotor:
+		default:
+		{
+			plant = new DCMotorSystem();
+			break;
+		}
+	}
+	plant->setIntegrationSolver(m_job.plantIntegrationSolver);
+	return plant;
+}
+
+void TuningRunner::setupPopulation()
+{
+	// Same start area as DCMotorProblem::setupPopulation() around the default parameters
+	const double areaRange = m_job.startAreaRange;
+	std::vector<std::vector<double>> initialPopulation;
+	AutoTuner::RandomStream random = m_solver->createRandomStream(AutoTuner::Solver::s_populationStream);
+	for (size_t i = 0; i < m_job.agentCount; ++i)
+	{
+		std::vector<double> individual;
+		if (m_job.optimizeKp)
+			individual.push_back(m_job.defaultKp + random.getDouble(-areaRange, areaRange));
+		if (m_job.optimizeKi)
+			individual.push_back(m_job.defaultKi + random.getDouble(-areaRange, areaRange));
+		if (m_job.optimizeKd)
+			individual.push_back(m_job.defaultKd + random.getDouble(-areaRange, areaRange));
+		if (m_job.optimizeKn && m_job.useKn)
+			individual.push_back(m_job.defaultKn + random.getDouble(-areaRange, areaRange));
+		if (m_job.optimizeIntegralSaturation)
+			individual.push_back(m_job.defaultPIDISaturation * random.getDouble(0, 2 * areaRange));
+		if (m_job.optimizeAntiWindupBackCalculationConstant)
+			individual.push_back(m_job.defaultPIDAntiWindupBackCalculationConstant + random.getDouble(-areaRange, areaRange));
+		initialPopulation.push_back(individual);
+	}
+	m_solver->setInitialParameters(initialPopulation);
+	m_solver->clearAlltimeBestParameters();
+}
+
+void TuningRunner::setPIDParameters(AutoTuner::PID& pid, const std::vector<double>& parameters) const
+{
+	size_t counter = 0;
+	double p = m_job.optimizeKp ? parameters[counter++] : m_job.defaultKp;
+	double i = m_job.optimizeKi ? parameters[counter++] : m_job.defaultKi;
+	double d = m_job.optimizeKd ? parameters[counter++] : m_job.defaultKd;
+	if (m_job.useKn)
+	{
+		double n = m_job.optimizeKn ? parameters[counter++] : m_job.defaultKn;
+		pid.setParameters(p, i, d, n);
+	}
+	else
+		pid.setParameters(p, i, d);
+
+	if (m_job.optimizeIntegralSaturation)
+		pid.setIntegralSatturationLimit(parameters[counter++]);
+	else
+		pid.setIntegralSatturationLimit(m_job.defaultPIDISaturation);
+
+	if (m_job.optimizeAntiWindupBackCalculationConstant)
+		pid.setAntiWindupBackCalculationConstant(parameters[counter++]);
+	else
+		pid.setAntiWindupBackCalculationConstant(m_job.defaultPIDAntiWindupBackCalculationConstant);
+}
+
+bool TuningRunner::onEpoch(size_t epoch)
+{
+	std::vector<double> scores = m_solver->getScores();
+	HistoryEntry entry;
+	if (scores.size() > 0)
+	{
+		entry.bestScore = *std::min_element(scores.begin(), scores.end());
+		entry.worstScore = *std::max_element(scores.begin(), scores.end());
+		double sumScores = 0;
+		for (double score : scores)
+			sumScores += score;
+		entry.averageScore = sumScores / static_cast<double>(scores.size());
+	}
+	entry.bestParameters = m_solver->getBestParameters();
+	m_history.push_back(entry);
+
+	if (entry.bestScore < m_bestScore - m_job.convergenceTolerance * std::max(1.0, std::abs(m_bestScore)) ||
+		!std::isfinite(m_bestScore))
+	{
+		m_lastImprovementEpoch = epoch;
+	}
+	m_bestScore = std::min(m_bestScore, entry.bestScore);
+
+	if (epoch % 100 == 0)
+		std::cout << "Epoch " << epoch << ": best " << entry.bestScore << " average " << entry.averageScore << "\n";
+
+	if (m_job.convergenceEpochs > 0 && epoch - m_lastImprovementEpoch >= m_job.convergenceEpochs)
+	{
+		m_converged = true;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,60 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+
+#include "AutoTuner.h"
+#include "TuningRunner.h"
+
+/**
+ * Usage: AutoTunerCLI <job file> [key=value ...]
+ * The key=value arguments override the values of the job file.
+ */
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: " << argv[0] << " <job file> [key=value ...]\n";
+		return 1;
+	}
+
+	TuningJob job;
+	std::string error;
+	if (!job.loadFromFile(argv[1], error))
+	{
+		std::cerr << error << "\n";
+		return 1;
+	}
+	for (int i = 2; i < argc; ++i)
+	{
+		std::string argument = argv[i];
+		size_t separator = argument.find('=');
+		if (separator == std::string::npos || !job.setValue(argument.substr(0, separator), argument.substr(separator + 1), error))
+		{
+			std::cerr << "Invalid argument \"" << argument << "\" " << error << "\n";
+			return 1;
+		}
+	}
+
+	AutoTuner::Profiler::start();
+
+	TuningRunner runner(job);
+	auto startTime = std::chrono::steady_clock::now();
+	size_t epochs = runner.run();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	std::cout << (runner.hasConverged() ? "Converged" : "Reached the target epochs") << " after " << epochs << " epochs in " << seconds << " s\n";
+	std::cout << "Best score: " << runner.getBestScore() << "\n";
+	std::vector<std::string> parameterNames = job.getParameterNames();
+	std::vector<double> bestParameters = runner.getBestParameters();
+	for (size_t i = 0; i < parameterNames.size() && i < bestParameters.size(); ++i)
+		std::cout << "  " << parameterNames[i] << " = " << bestParameters[i] << "\n";
+
+	int ret = 0;
+	if (!runner.exportResults())
+	{
+		std::cerr << "Can't write the results to " << job.outputFolder << "/" << job.resultName << "\n";
+		ret = 1;
+	}
+	AutoTuner::Profiler::stop((std::string(AutoTuner::LibraryInfo::name) + "CLI.prof").c_str());
+	return ret;
+}
@@ -3,6 +3,7 @@
 
 #include "AutoTuner.h"
 #include "Systems/DCMotorSystem.h"
+#include "Systems/DCMotorBatchSystem.h"
 #include "scene/Objects/PIDTuningProblem.h"
 #include "scene/Objects/SystemOptimizer.h"
 #include <QObject>
@@ -78,6 +79,11 @@ public:
 	DCMotorProblem(const SetupSettings &setupSettings = SetupSettings(),
 				  const std::string& name = "DCMotorProblem",
 				  GameObject* parent = nullptr);
+	/**
+	 * @brief
+	 * Stops the worker, its test functions use the members of this object
+	 */
+	~DCMotorProblem();
 
 	void onAwake() override;
 	void precalculatePIDWithZieglerNichols() override;
@@ -124,29 +130,41 @@ public:
 		double actuatorEffortWeight,
 		double overshootWeight) override
 	{
+		stopSolver();
 		m_tuningGoalFactor_errorIntegral = errorIntegralWeight;
 		m_tuningGoalFactor_actuatorEffort = actuatorEffortWeight;
 		m_tuningGoalFactor_overshoot = overshootWeight;
+		invalidateFitnessCache();
 	}
 	void setTuningGoalParameter_ErrorIntegralWeight(double weight) override
 	{
+		stopSolver();
 		m_tuningGoalFactor_errorIntegral = weight;
+		invalidateFitnessCache();
 	}
 	void setTuningGoalParameter_ActuatorEffortWeight(double weight) override
 	{
+		stopSolver();
 		m_tuningGoalFactor_actuatorEffort = weight;
+		invalidateFitnessCache();
 	}
 	void setTuningGoalParameter_OvershootWeight(double weight) override
 	{
+		stopSolver();
 		m_tuningGoalFactor_overshoot = weight;
+		invalidateFitnessCache();
 	}
 	void setTuningGoalParameter_GainMarginWeight(double weight) override
 	{
+		stopSolver();
 		m_tuningGoalFactor_gainMargin = weight;
+		invalidateFitnessCache();
 	}
 	void setTuningGoalParameter_PhaseMarginWeight(double weight)
 	{
+		stopSolver();
 		m_tuningGoalFactor_phaseMargin = weight;
+		invalidateFitnessCache();
 	}
 	double getTuningGoalParameter_ErrorIntegralWeight() const override
 	{
@@ -170,6 +188,7 @@ public:
 	}
 	void enableLearningRateDecay(bool enable) override
 	{
+		stopSolver();
 		m_setupSettings.useGeneticMutationRateDecay = enable;
 		//m_useLearningRateDecay = enable;
 	}
@@ -184,10 +203,18 @@ public:
 
 	std::vector<double> agentTestFunction(const std::vector<double>& parameters, size_t agent) override;
 
+	/**
+	 * @brief
+	 * Scores a block of agents like agentTestFunction, but simulates all of them in lockstep
+	 * using PIDBatch and DCMotorBatchSystem. The score parts are identical to the ones of agentTestFunction.
+	 */
+	void agentBatchTestFunction(const AutoTuner::PopulationStore::AgentBlock& block);
+
 	void printSignalSequenceToConsole(const std::string &name, const std::vector<sf::Vector2<double>> &steps) const override;
 
 	void setTargetEpoch(size_t epoch) override
 	{
+		stopSolver();
 		m_setupSettings.targetEpochs = epoch;
 	}
 	signals:
@@ -266,6 +293,17 @@ private:
 					return m_pidController.getInput(0);
 				return m_dcMotorSystem.getInput(index);
 			}
+			bool getFrequencyResponse(double omega, size_t inputIndex, size_t outputIndex, std::complex<double>& response) override {
+				// Open loop: PID in series with the motor voltage input
+				std::complex<double> pidResponse;
+				std::complex<double> motorResponse;
+				if (inputIndex != 0 ||
+					!m_pidController.getFrequencyResponse(omega, 0, 0, pidResponse) ||
+					!m_dcMotorSystem.getFrequencyResponse(omega, 0, outputIndex, motorResponse))
+					return false;
+				response = pidResponse * motorResponse;
+				return true;
+			}
 
 
 			AutoTuner::PID m_pidController;
@@ -614,16 +652,41 @@ private:
 	std::vector<sf::Vector2<double>> generateRandomStepSequence(double stepAmplitude, double maxTime, double minStepDuration, double maxStepDuration, size_t stepCount) override;
 	
 	void setCSVHeader() override;
-	void logCSVData() override;
+	void logCSVData(const AutoTuner::PopulationStore::Generation& generation) override;
 	void testCustomPID() override;
 
+	/**
+	 * @brief
+	 * Called on the worker thread after each generation, logs the learning history and decays the learning rate
+	 */
+	bool onEpoch(size_t epoch, const AutoTuner::PopulationStore::Generation& generation);
+	/**
+	 * @brief
+	 * Starts the worker, a run stops at the target epoch so every logged run has the same length
+	 */
+	void startSolver();
+	/**
+	 * @brief
+	 * The epochs run on the worker thread. It must be stopped before the solver or the data of the
+	 * test functions change, the next update() starts it again.
+	 */
+	void stopSolver() const;
+
 
 	SetupSettings m_setupSettings;
 
+	/**
+	 * @brief
+	 * Cached scores are not valid anymore after the step sequence or the tuning goals changed
+	 */
+	void invalidateFitnessCache();
+	uint64_t m_fitnessContextVersion = 0;
+
 
 	AutoTuner::ZieglerNichols* m_zieglerNicholsComponent = nullptr;
 	AutoTuner::ChartViewComponent* m_chartViewComponent = nullptr;
-	AutoTuner::Solver* m_solverObject = nullptr;
+	AutoTuner::Solver* m_solver = nullptr;
+	AutoTuner::SolverObject* m_solverObject = nullptr;	// Shows m_solver in the scene
 	AutoTuner::NyquistPlotComponent* m_nyquistPlotComponent = nullptr;
 
 	//size_t m_populationSize = s_agentCount;
@@ -639,6 +702,7 @@ private:
 
 	std::vector<sf::Vector2<double>> m_learningStepData;
 	std::vector<sf::Vector2<double>> m_learningDisturbanceData;
+	size_t m_stepSequenceCount = 0;
 
 	double m_tuningGoalFactor_errorIntegral = 3.8;
 	double m_tuningGoalFactor_actuatorEffort = 0.038;
@@ -646,7 +710,7 @@ private:
 	double m_tuningGoalFactor_gainMargin = 0;
 	double m_tuningGoalFactor_phaseMargin = 0;
 	//bool m_useLearningRateDecay = true;
-	double m_learningRate;
+	std::atomic<double> m_learningRate;	// Decayed on the worker thread
 
 
 	
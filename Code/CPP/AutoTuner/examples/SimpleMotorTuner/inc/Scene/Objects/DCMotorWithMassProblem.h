@@ -78,6 +78,11 @@ public:
 	DCMotorWithMassProblem(const SetupSettings& setupSettings = SetupSettings(), 
 						   const std::string& name = "DCMotorWithMassProblem",
 						   GameObject* parent = nullptr);
+	/**
+	 * @brief
+	 * Stops the worker, its test functions use the members of this object
+	 */
+	~DCMotorWithMassProblem();
 
 	void onAwake() override;
 	void precalculatePIDWithZieglerNichols() override;
@@ -124,28 +129,34 @@ public:
 		double actuatorEffortWeight,
 		double overshootWeight) override
 	{
+		stopSolver();
 		m_tuningGoalFactor_errorIntegral = errorIntegralWeight;
 		m_tuningGoalFactor_actuatorEffort = actuatorEffortWeight;
 		m_tuningGoalFactor_overshoot = overshootWeight;
 	}
 	void setTuningGoalParameter_ErrorIntegralWeight(double weight) override
 	{
+		stopSolver();
 		m_tuningGoalFactor_errorIntegral = weight;
 	}
 	void setTuningGoalParameter_ActuatorEffortWeight(double weight) override
 	{
+		stopSolver();
 		m_tuningGoalFactor_actuatorEffort = weight;
 	}
 	void setTuningGoalParameter_OvershootWeight(double weight) override
 	{
+		stopSolver();
 		m_tuningGoalFactor_overshoot = weight;
 	}
 	void setTuningGoalParameter_GainMarginWeight(double weight) override 
 	{
+		stopSolver();
 		m_tuningGoalFactor_gainMargin = weight;
 	}
 	void setTuningGoalParameter_PhaseMarginWeight(double weight) 
 	{
+		stopSolver();
 		m_tuningGoalFactor_phaseMargin = weight;
 	}
 	double getTuningGoalParameter_ErrorIntegralWeight() const override
@@ -170,6 +181,7 @@ public:
 	}
 	void enableLearningRateDecay(bool enable) override
 	{
+		stopSolver();
 		m_setupSettings.useGeneticMutationRateDecay = enable;
 	}
 	bool isLearningRateDecayEnabled() const override
@@ -186,6 +198,7 @@ public:
 
 	void setTargetEpoch(size_t epoch) override
 	{
+		stopSolver();
 		m_setupSettings.targetEpochs = epoch;
 	}
 	signals:
@@ -281,6 +294,7 @@ private:
 			, m_referenceValue(other.m_referenceValue)
 			, m_disturbanceValue(other.m_disturbanceValue)
 			, m_errorValue(other.m_errorValue)
+			, m_measurementNoise(other.m_measurementNoise)
 			, m_feedForwardPart(other.m_feedForwardPart)
 			, m_systemInputLimit(other.m_systemInputLimit)
 			, m_actuatorInputLimit(other.m_actuatorInputLimit)
@@ -523,7 +537,7 @@ private:
 		void update(double deltaTime) override
 		{
 			double y = m_feedForwardPart.m_motorWithMass.getOutputs()[1];	// y(t)
-			double measurementNoise = AutoTuner::Solver::getRandomDouble(-1, 1) * 0.1;
+			double measurementNoise = m_measurementNoise.getDouble(-1, 1) * 0.1;
 			m_errorValue = m_referenceValue - y + measurementNoise;				// e(t) = r(t) - y(t)
 
 			m_feedForwardPart.setInputSignal(0, m_errorValue);
@@ -587,6 +601,16 @@ private:
 		{
 			return m_feedForwardPart;
 		}
+
+		/**
+		 * @brief
+		 * Sets the stream of the measurement noise.
+		 * A stream of the solver seed and the agent index gives the same noise, whatever worker tests the agent.
+		 */
+		void setMeasurementNoise(const AutoTuner::RandomStream& noise)
+		{
+			m_measurementNoise = noise;
+		}
 	private:
 
 		SetupSettings m_setupSettings;
@@ -595,7 +619,7 @@ private:
 		double m_disturbanceValue = 0.0;
 
 		double m_errorValue = 0.0;
-		
+		AutoTuner::RandomStream m_measurementNoise;
 
 		double m_actuatorInputLimit = 10;
 		double m_systemInputLimit = 10;
@@ -607,16 +631,34 @@ private:
 	std::vector<sf::Vector2<double>> generateRandomStepSequence(double stepAmplitude, double maxTime, double minStepDuration, double maxStepDuration, size_t stepCount) override;
 	
 	void setCSVHeader() override;
-	void logCSVData() override;
+	void logCSVData(const AutoTuner::PopulationStore::Generation& generation) override;
 	void testCustomPID() override;
 
+	/**
+	 * @brief
+	 * Called on the worker thread after each generation, logs the learning history and decays the learning rate
+	 */
+	bool onEpoch(size_t epoch, const AutoTuner::PopulationStore::Generation& generation);
+	/**
+	 * @brief
+	 * Starts the worker, a run stops at the target epoch so every logged run has the same length
+	 */
+	void startSolver();
+	/**
+	 * @brief
+	 * The epochs run on the worker thread. It must be stopped before the solver or the data of the
+	 * test functions change, the next update() starts it again.
+	 */
+	void stopSolver() const;
+
 
 	SetupSettings m_setupSettings;
 
 
 	AutoTuner::ZieglerNichols* m_zieglerNicholsComponent = nullptr;
 	AutoTuner::ChartViewComponent* m_chartViewComponent = nullptr;
-	AutoTuner::Solver* m_solverObject = nullptr;
+	AutoTuner::Solver* m_solver = nullptr;
+	AutoTuner::SolverObject* m_solverObject = nullptr;	// Shows m_solver in the scene
 	AutoTuner::NyquistPlotComponent* m_nyquistPlotComponent = nullptr;
 
 	//size_t m_populationSize = s_agentCount;
@@ -633,6 +675,9 @@ private:
 
 	std::vector<sf::Vector2<double>> m_learningStepData;
 	std::vector<sf::Vector2<double>> m_learningDisturbanceData;
+	size_t m_stepSequenceCount = 0;
+	static constexpr uint32_t s_stepSequenceStream = AutoTuner::Solver::s_problemStream;
+	static constexpr uint32_t s_measurementNoiseStream = AutoTuner::Solver::s_problemStream + 1;
 
 	double m_tuningGoalFactor_errorIntegral = 2.8;
 	double m_tuningGoalFactor_actuatorEffort = 0.1;
@@ -640,7 +685,7 @@ private:
 	double m_tuningGoalFactor_gainMargin = 0;
 	double m_tuningGoalFactor_phaseMargin = 99;
 	//bool m_useLearningRateDecay = true;
-	double m_learningRate;
+	std::atomic<double> m_learningRate;	// Decayed on the worker thread
 
 
 	
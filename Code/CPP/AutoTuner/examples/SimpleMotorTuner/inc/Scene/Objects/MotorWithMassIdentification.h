@@ -19,9 +19,9 @@ public:
 
 	void setLearningRate(double rate)
 	{
-		if (m_solverObject)
+		if (m_solver)
 		{
-			m_solverObject->setMutationAmount(rate);
+			m_solver->setMutationAmount(rate);
 		}
 	}
 
@@ -151,6 +151,6 @@ private:
 
 
 	SystemOptimizer* m_systemOptimizer = nullptr;
-	AutoTuner::Solver* m_solverObject = nullptr;
+	AutoTuner::Solver* m_solver = nullptr;
 	std::shared_ptr<System> m_systemModel;
 };
@@ -124,7 +124,9 @@ public:
 	enum SolverType
 	{
 		GeneticAlgorithm,
-		DifferentialEvolution
+		DifferentialEvolution,
+		CMAES,
+		NSGA2
 	};
 	struct SetupSettings
 	{
@@ -134,6 +136,11 @@ public:
 
 		SolverType solverType = SolverType::GeneticAlgorithm;
 		bool disableErrorIntegrationWhenSaturated = true;
+		bool useBatchSimulation = true; // Simulates all agents of a block in lockstep
+		size_t fitnessCacheCapacity = 10000; // Scored parameter vectors kept to skip repeated simulations, 0 disables the cache
+		bool useRacing = true; // Stops simulating agents which are already worse than the worst agent of the last generation
+		size_t surrogatePoolSize = 1; // Bred candidates per simulated agent, ranked by a surrogate model of the score, 1 disables the screening
+		bool useSteadyStateGenetic = false; // Genetic solver only: workers insert each simulated child at once instead of waiting for the whole generation
 
 		// Optimization parameters
 		bool optimizeKp = true;
@@ -254,7 +261,7 @@ protected:
 	virtual std::vector<sf::Vector2<double>> generateRandomStepSequence(double stepAmplitude, double maxTime, double minStepDuration, double maxStepDuration, size_t stepCount) = 0;
 
 	virtual void setCSVHeader() = 0;
-	virtual void logCSVData() = 0;
+	virtual void logCSVData(const AutoTuner::PopulationStore::Generation& generation) = 0;
 	virtual void testCustomPID() = 0;
 
 	virtual void saveResultDataToFile(const ResultData& resultData, std::string folderPath) const = 0;
@@ -15,6 +15,11 @@ public:
 
 	SystemOptimizer(const std::string& name = "SystemOptimizer",
 		GameObject* parent = nullptr);
+	/**
+	 * @brief
+	 * Stops the worker, its test function uses the agent systems of this object
+	 */
+	~SystemOptimizer();
 	
 	virtual void setModel(const std::shared_ptr<AutoTuner::TunableTimeBasedSystem>& model)
 	{
@@ -23,7 +28,10 @@ public:
 			m_initialParameters = m_systemPlotModel->getParameters();
 		if (m_optimizing)
 		{
+			// The agent systems are used by the worker thread
+			m_solverObject->getWorker().stop();
 			cloneSystems();
+			m_solverObject->getWorker().start();
 		}
 	}
 	virtual const std::vector<double>& getInitialParameters() const
@@ -34,7 +42,11 @@ public:
 	{
 		return m_bestParameters;
 	}
-	virtual void setSolverObject(AutoTuner::Solver* solver);
+	/**
+	 * @brief
+	 * Sets the solver, which gets deleted together with this object
+	 */
+	virtual void setSolver(AutoTuner::Solver* solver);
 	virtual void setStimulusResponseDataCollection(const std::vector<StimulusResponseData>& dataCollection)
 	{
 		m_stimulusResponseDataCollection = dataCollection;
@@ -82,7 +94,8 @@ private:
 	std::shared_ptr<AutoTuner::TunableTimeBasedSystem> m_systemPlotModel;
 	std::vector< std::shared_ptr<AutoTuner::TunableTimeBasedSystem>> m_agentsSystemModels;
 	std::vector<StimulusResponseData> m_stimulusResponseDataCollection;
-	AutoTuner::Solver* m_solverObject;
+	AutoTuner::Solver* m_solver;
+	AutoTuner::SolverObject* m_solverObject = nullptr;	// Owns m_solver
 
 	AutoTuner::ChartViewComponent* m_chartViewComponent = nullptr;
 
@@ -91,6 +104,7 @@ private:
 
 	bool m_optimizing = false;
 	size_t m_currentEpoch = 0;
+	size_t m_plottedVersion = 0;
 	size_t m_printBestCounter = 0;
 	//struct Agent
 	//{
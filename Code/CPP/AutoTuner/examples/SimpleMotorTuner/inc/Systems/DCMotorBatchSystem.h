@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Systems/DCMotorSystem.h"
+
+/**
+ * @brief
+ * Many DCMotorSystem instances advanced in lockstep.
+ * The state of every motor is stored in contiguous rows, one update processes
+ * AutoTuner::SimdDouble::s_laneCount motors per instruction.
+ * The arithmetic follows DCMotorSystem::update() in the same order, the results are bitwise identical.
+ */
+class DCMotorBatchSystem
+{
+public:
+	DCMotorBatchSystem(size_t count = 0)
+	{
+		DCMotorSystem motor;
+		m_integrationSolver = motor.getIntegrationSolver();
+		resize(count);
+	}
+
+	void resize(size_t count)
+	{
+		size_t paddedCount = AutoTuner::SimdDouble::getPaddedCount(count);
+		m_count = count;
+		m_inputVoltage.assign(paddedCount, 0.0);
+		m_disturbance.assign(paddedCount, 0.0);
+		m_integratorOutput.assign(paddedCount, 0.0);
+		m_outputAngularVelocity.assign(paddedCount, 0.0);
+		m_lastPreIntegratorSignal.assign(paddedCount, 0.0);
+	}
+	size_t size() const { return m_count; }
+
+	void reset()
+	{
+		resize(m_count);
+	}
+
+	void setIntegrationSolver(AutoTuner::TimeBasedSystem::IntegrationSolver solver) { m_integrationSolver = solver; }
+	AutoTuner::TimeBasedSystem::IntegrationSolver getIntegrationSolver() const { return m_integrationSolver; }
+
+	/**
+	 * @brief
+	 * Copies the model constants of a scalar motor, they are shared by all motors of the batch
+	 */
+	void setModel(const DCMotorSystem& motor)
+	{
+		m_k1 = motor.getK1();
+		m_k2 = motor.getK2();
+		m_k3 = motor.getK3();
+		m_invTimeConstant = motor.getInvTimeConstant();
+	}
+
+	void setInputs(size_t index, double voltage, double disturbance)
+	{
+		m_inputVoltage[index] = voltage;
+		m_disturbance[index] = disturbance;
+	}
+	/**
+	 * @brief
+	 * Sets the same disturbance for all motors
+	 */
+	void setDisturbance(double disturbance)
+	{
+		std::fill(m_disturbance.begin(), m_disturbance.end(), disturbance);
+	}
+	double* getInputVoltages() { return m_inputVoltage.data(); }
+	const double* getAngularVelocities() const { return m_outputAngularVelocity.data(); }
+	double getAngularVelocity(size_t index) const { return m_outputAngularVelocity[index]; }
+
+	void update(double deltaTime)
+	{
+		typedef AutoTuner::SimdDouble V;
+		using IntegrationSolver = AutoTuner::TimeBasedSystem::IntegrationSolver;
+
+		const V k1 = V::broadcast(m_k1);
+		const V k2k3 = V::broadcast(m_k2 * m_k3);
+		const V invT = V::broadcast(m_invTimeConstant);
+		const V one = V::broadcast(1.0);
+		const V dt = V::broadcast(deltaTime);
+		const V halfDt = V::broadcast(deltaTime / 2.0);
+
+		size_t paddedCount = V::getPaddedCount(m_count);
+		for (size_t i = 0; i < paddedCount; i += V::s_laneCount)
+		{
+			V y = V::load(m_outputAngularVelocity.data() + i);
+			V u = V::load(m_inputVoltage.data() + i);
+			V l = V::load(m_disturbance.data() + i);
+			V integrator = V::load(m_integratorOutput.data() + i);
+			V lastPreIntegratorSignal = V::load(m_lastPreIntegratorSignal.data() + i);
+#ifdef DCMOTOR_USE_SIMPLIFIED_MODEL
+			V preIntegratorSignal = (k1 * u - y * (one + k2k3 * l)) * invT;
+#else
+			V preIntegratorSignal = invT * (u - y) - (y * one * l);
+#endif
+			switch (m_integrationSolver)
+			{
+				case IntegrationSolver::ForwardEuler:
+					integrator = integrator + dt * lastPreIntegratorSignal;
+					break;
+				case IntegrationSolver::BackwardEuler:
+					integrator = integrator + dt * preIntegratorSignal;
+					break;
+				case IntegrationSolver::Bilinear:
+					integrator = integrator + halfDt * (preIntegratorSignal + lastPreIntegratorSignal);
+					break;
+				default:
+					break;
+			}
+#ifdef DCMOTOR_USE_SIMPLIFIED_MODEL
+			y = integrator;
+#else
+			y = V::select(V::lessThan(integrator, one),
+				(integrator * V::broadcast(0.43) + V::broadcast(0.21)) * integrator,
+				(integrator * V::broadcast(1.07)) - V::broadcast(0.43));
+#endif
+			integrator.store(m_integratorOutput.data() + i);
+			y.store(m_outputAngularVelocity.data() + i);
+			preIntegratorSignal.store(m_lastPreIntegratorSignal.data() + i);
+		}
+	}
+
+private:
+	size_t m_count = 0;
+	AutoTuner::TimeBasedSystem::IntegrationSolver m_integrationSolver;
+
+	std::vector<double> m_inputVoltage;
+	std::vector<double> m_disturbance;
+	std::vector<double> m_integratorOutput;
+	std::vector<double> m_outputAngularVelocity;
+	std::vector<double> m_lastPreIntegratorSignal;
+
+	double m_invTimeConstant = 1.0 / 0.14;
+	double m_k1 = 1;
+	double m_k2 = 0;
+	double m_k3 = 0;
+};
@@ -106,6 +106,11 @@ public:
 		return m_outputAngularVelocity;
 	}
 
+	double getK1() const { return m_k1; }
+	double getK2() const { return m_k2; }
+	double getK3() const { return m_k3; }
+	double getInvTimeConstant() const { return m_invTimeConstant; }
+
 	void setInputSignals(double u) override
 	{
 		m_inputVoltage = u;
@@ -186,6 +191,23 @@ public:
 		m_lastPreIntegratorSignal = preIntegratorSignal;
 	} 
 
+	/**
+	 * @brief
+	 * Voltage to angular velocity: K1 / (T*s + 1).
+	 * The disturbance acts multiplicatively, only the voltage input has a linear response.
+	 */
+	bool getFrequencyResponse(double omega, size_t inputIndex, size_t outputIndex, std::complex<double>& response) override
+	{
+#ifdef DCMOTOR_USE_SIMPLIFIED_MODEL
+		if (inputIndex != 0 || outputIndex != 0)
+			return false;
+		response = m_k1 * m_invTimeConstant / (std::complex<double>(0.0, omega) + m_invTimeConstant);
+		return true;
+#else
+		return false;
+#endif
+	}
+
 	std::vector<double> getInputs() const override
 	{
 		return { m_inputVoltage, m_disturbance };
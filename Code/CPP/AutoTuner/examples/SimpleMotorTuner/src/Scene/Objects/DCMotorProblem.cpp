@@ -43,14 +43,29 @@ DCMotorProblem::DCMotorProblem(const SetupSettings& setupSettings,
 		{
 			AutoTuner::GeneticSolver* gs = new AutoTuner::GeneticSolver();
 			gs->setMutationAmount(m_setupSettings.startLearningRate);
-			m_solverObject = gs;
+			gs->setSteadyStateEnabled(m_setupSettings.useSteadyStateGenetic);
+			m_solver = gs;
 			break;
 		}
 		case SolverType::DifferentialEvolution:
 		{
 			AutoTuner::DifferentialEvolutionSolver* ds = new AutoTuner::DifferentialEvolutionSolver();
 			ds->setMutationAmount(m_setupSettings.startLearningRate);
-			m_solverObject = ds;
+			m_solver = ds;
+			break;
+		}
+		case SolverType::CMAES:
+		{
+			// Adapts its own step size, the learning rate is not used
+			m_solver = new AutoTuner::CMAESSolver();
+			break;
+		}
+		case SolverType::NSGA2:
+		{
+			// Keeps the Pareto front of the score parts, the summed score still picks the tuned parameters
+			AutoTuner::NSGA2Solver* ns = new AutoTuner::NSGA2Solver();
+			ns->setMutationAmount(m_setupSettings.startLearningRate);
+			m_solver = ns;
 			break;
 		}
 		default:
@@ -62,24 +77,26 @@ DCMotorProblem::DCMotorProblem(const SetupSettings& setupSettings,
 //#ifdef USE_GENTIC_SOLVER
 //	AutoTuner::GeneticSolver *gs = new AutoTuner::GeneticSolver();
 //	gs->setMutationAmount(m_learningRate);
-//	m_solverObject = gs;
+//	m_solver = gs;
 //#endif
 //#ifdef USE_DIFFERENTIAL_EVOLUTION_SOLVER
 //	AutoTuner::DifferentialEvolutionSolver *ds = new AutoTuner::DifferentialEvolutionSolver();
 //	ds->setMutationAmount(s_startLearningRate);
-//	m_solverObject = ds;
+//	m_solver = ds;
 //#endif
 	if(m_setupSettings.useMinimizingScore)
-		m_solverObject->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Minimize);
+		m_solver->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Minimize);
 	else
-		m_solverObject->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Maximize);
+		m_solver->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Maximize);
 
 //#ifdef GENETIC_USE_MINIMIZING_SCORE
-//	m_solverObject->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Minimize);
+//	m_solver->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Minimize);
 //#else
-//	m_solverObject->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Maximize);
+//	m_solver->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Maximize);
 //#endif
+	m_solverObject = new AutoTuner::SolverObject(m_solver);
 	addChild(m_solverObject);
+	m_solverObject->getWorker().setEpochCallback(std::bind(&DCMotorProblem::onEpoch, this, std::placeholders::_1, std::placeholders::_2));
 
 	
 	m_solverObject->setParametersToColorFunc(
@@ -93,8 +110,13 @@ DCMotorProblem::DCMotorProblem(const SetupSettings& setupSettings,
 			return sf::Color(r, g, b);
 		}
 	);
-	m_solverObject->setParametersTestFunc(std::bind(&DCMotorProblem::agentTestFunction, this, std::placeholders::_1, std::placeholders::_2));
-	m_solverObject->setScorePartsLabels({ "error", "pidOutChange", "Overshoot", "GainMargin", "PhaseMargin" });
+	m_solver->setParametersTestFunc(std::bind(&DCMotorProblem::agentTestFunction, this, std::placeholders::_1, std::placeholders::_2));
+	if (m_setupSettings.useBatchSimulation)
+		m_solver->setParametersBatchTestFunc(std::bind(&DCMotorProblem::agentBatchTestFunction, this, std::placeholders::_1));
+	m_solver->setFitnessCacheCapacity(m_setupSettings.fitnessCacheCapacity);
+	m_solver->setRacingEnabled(m_setupSettings.useRacing);
+	m_solver->setSurrogatePoolSize(m_setupSettings.surrogatePoolSize);
+	m_solver->setScorePartsLabels({ "error", "pidOutChange", "Overshoot", "GainMargin", "PhaseMargin" });
 	
 	//geneticSolver->setTargetScore(AutoTuner::GeneticSolver::TargetScore::Minimize);
 	
@@ -153,6 +175,11 @@ DCMotorProblem::DCMotorProblem(const SetupSettings& setupSettings,
 	//);
 }
 
+DCMotorProblem::~DCMotorProblem()
+{
+	m_solverObject->getWorker().stop();
+}
+
 void DCMotorProblem::onAwake()
 {
 	testCustomPID();
@@ -192,28 +219,31 @@ void DCMotorProblem::precalculatePIDWithZieglerNichols()
 }
 void DCMotorProblem::setupPopulation(size_t populationSize, double kp, double ki, double kd, double integralSatturation, double areaRange)
 {
-	//AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solverObject);
-	if (m_solverObject)
+	//AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solver);
+	if (m_solver)
 	{
+		stopSolver();
 		m_setupSettings.agentCount = populationSize;
 		std::vector<std::vector<double>> initialPopulation;
+		// Own stream of the solver seed, so the whole run is reproducible from that seed
+		AutoTuner::RandomStream random = m_solver->createRandomStream(AutoTuner::Solver::s_populationStream);
 		for (size_t i = 0; i < populationSize; ++i)
 		{
 			std::vector<double> individual;
 			if(m_setupSettings.optimizeKp)
-				individual.push_back(kp + AutoTuner::Solver::getRandomDouble(-areaRange, areaRange)); // Kp
+				individual.push_back(kp + random.getDouble(-areaRange, areaRange)); // Kp
 
 			if (m_setupSettings.optimizeKi)
-				individual.push_back(ki + AutoTuner::Solver::getRandomDouble(-areaRange, areaRange)); // Ki
+				individual.push_back(ki + random.getDouble(-areaRange, areaRange)); // Ki
 
 			if (m_setupSettings.optimizeKd)
-				individual.push_back(kd + AutoTuner::Solver::getRandomDouble(-areaRange, areaRange));  // Kd
+				individual.push_back(kd + random.getDouble(-areaRange, areaRange));  // Kd
 			if (m_setupSettings.optimizeKn && m_setupSettings.useKn)
-				individual.push_back(m_setupSettings.defaultKn + AutoTuner::Solver::getRandomDouble(-areaRange, areaRange)); // Kn
+				individual.push_back(m_setupSettings.defaultKn + random.getDouble(-areaRange, areaRange)); // Kn
 			if (m_setupSettings.optimizeIntegralSaturation)
-				individual.push_back(m_setupSettings.defaultPIDISaturation * AutoTuner::Solver::getRandomDouble(0, 2 * areaRange));
+				individual.push_back(m_setupSettings.defaultPIDISaturation * random.getDouble(0, 2 * areaRange));
 			if (m_setupSettings.optimizeAntiWindupBackCalculationConstant)
-				individual.push_back(m_setupSettings.defaultPIDAntiWindupBackCalculationConstant + AutoTuner::Solver::getRandomDouble(-areaRange, areaRange));
+				individual.push_back(m_setupSettings.defaultPIDAntiWindupBackCalculationConstant + random.getDouble(-areaRange, areaRange));
 
 
 
@@ -238,7 +268,7 @@ void DCMotorProblem::setupPopulation(size_t populationSize, double kp, double ki
 //#endif
 			initialPopulation.push_back(individual);
 		}
-		AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solverObject);
+		AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solver);
 		if (geneticSolver)
 		{
 			if (geneticSolver->isThreadsBusy())
@@ -247,8 +277,8 @@ void DCMotorProblem::setupPopulation(size_t populationSize, double kp, double ki
 				return;
 			}
 		}
-		m_solverObject->setInitialParameters(initialPopulation);
-		m_solverObject->clearAlltimeBestParameters();
+		m_solver->setInitialParameters(initialPopulation);
+		m_solver->clearAlltimeBestParameters();
 		testPID(initialPopulation[0]);
 		//testPID({5,35.7,0,10});
 	}
@@ -256,11 +286,12 @@ void DCMotorProblem::setupPopulation(size_t populationSize, double kp, double ki
 
 void DCMotorProblem::update()
 {
-	if (m_solverObject)
+	if (m_solver)
 	{
 #ifdef DYNAMIC_STEP_SEQUENCE
 		if (m_learningStepData.size() == 0)
 		{
+			stopSolver();
 			m_learningStepData.clear();
 			m_learningStepData.resize(m_testRuns);
 			for (size_t i = 0; i < m_testRuns; ++i)
@@ -268,53 +299,65 @@ void DCMotorProblem::update()
 		}
 #endif
 
-		m_solverObject->test();
-		m_solverObject->iterate();
-
-		
-		logCSVData();
-		++m_epochCounter;
-		if(m_setupSettings.targetEpochs <= m_epochCounter)
+		// The epochs run on the worker, see onEpoch()
+		AutoTuner::SolverWorker& worker = m_solverObject->getWorker();
+		size_t epoch = worker.getEpoch();
+		if(m_setupSettings.targetEpochs <= epoch)
 		{
-			emit targetEpochReached(m_epochCounter);
+			emit targetEpochReached(epoch);
 		}
+		// Continues after the target epoch or after a change that stopped the worker
+		if (!worker.isRunning())
+			startSolver();
+	}
+}
+bool DCMotorProblem::onEpoch(size_t, const AutoTuner::PopulationStore::Generation& generation)
+{
+	logCSVData(generation);
+	++m_epochCounter;
 
-		AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solverObject);
-		if (geneticSolver)
-		{
-//#if defined(USE_GENTIC_SOLVER)
-			if (m_setupSettings.useGeneticMutationRateDecay)
-			{
-				//AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solverObject);
-				//if (geneticSolver)
-				//{
-					m_learningRate *= m_setupSettings.learningRateDecay;
-					geneticSolver->setMutationAmount(m_learningRate);
-				//}
-			}
-		}
-//#endif
+	AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solver);
+	if (geneticSolver && m_setupSettings.useGeneticMutationRateDecay)
+	{
+		m_learningRate = m_learningRate * m_setupSettings.learningRateDecay;
+		geneticSolver->setMutationAmount(m_learningRate);
 	}
+	return true;
+}
+void DCMotorProblem::startSolver()
+{
+	AutoTuner::SolverWorker& worker = m_solverObject->getWorker();
+	size_t epoch = worker.getEpoch();
+	worker.start(epoch < m_setupSettings.targetEpochs ? m_setupSettings.targetEpochs - epoch : 0);
+}
+void DCMotorProblem::stopSolver() const
+{
+	m_solverObject->getWorker().stop();
 }
 
 void DCMotorProblem::createNewStepSequence()
 {
+	stopSolver();
 	m_stepData = generateRandomStepSequence(m_testSystem.getSystemInputLimit() * 0.8, 10, 0.5, 3.0, 5);
-	
+	invalidateFitnessCache();
 
 }
+void DCMotorProblem::invalidateFitnessCache()
+{
+	++m_fitnessContextVersion;
+	if (m_solver)
+		m_solver->setFitnessContextVersion(m_fitnessContextVersion);
+}
 void DCMotorProblem::resetPopulation()
 {
-	if (m_solverObject)
+	if (m_solver)
 	{
+		stopSolver();
 		//createNewStepSequence();
 		if (m_learningStepData.size() > 0)
 			m_stepData = m_learningStepData;
+		invalidateFitnessCache();
 
-		double kp = (rand() % 20) - 10;
-		double ki = (rand() % 20) - 10;
-		double kd = (rand() % 20) - 10;
-		
 		//setupPopulation(kp, ki, kd,m_defaultPIDISatturation,  1);
 		//testPID(kp, ki, kd, m_defaultPIDISatturation);
 
@@ -327,37 +370,41 @@ void DCMotorProblem::resetPopulation()
 }
 void DCMotorProblem::testBestAgent()
 {
-	if (m_solverObject)
+	if (m_solver)
 	{
-		auto parameters = m_solverObject->getBestParameters();
+		auto parameters = getBestParameters();
 		testPID(parameters);
 	}
 }
 void DCMotorProblem::setLearningAmount(double learningAmount)
 {
-	if (m_solverObject)
+	if (m_solver)
 	{
-		m_solverObject->setMutationAmount(learningAmount);
+		stopSolver();
+		m_solver->setMutationAmount(learningAmount);
 	}
 }
 double DCMotorProblem::getLearningAmount() const
 {
-	if(m_solverObject)
+	if(m_solver)
 	{
-		return m_solverObject->getMutationAmount();
+		// The worker decays the mutation amount of the GeneticSolver
+		stopSolver();
+		return m_solver->getMutationAmount();
 	}
 	return 0.0;
 }
 void DCMotorProblem::setLearningRate(double learningRate)
 {
-	AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solverObject);
+	stopSolver();
+	AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solver);
 	m_learningRate = learningRate;
 	if (geneticSolver)
 	{
 		geneticSolver->setMutationAmount(learningRate);
 		return;
 	}
-	AutoTuner::DifferentialEvolutionSolver* deSolver = dynamic_cast<AutoTuner::DifferentialEvolutionSolver*>(m_solverObject);
+	AutoTuner::DifferentialEvolutionSolver* deSolver = dynamic_cast<AutoTuner::DifferentialEvolutionSolver*>(m_solver);
 	if (deSolver)
 	{
 		deSolver->setMutationAmount(learningRate);
@@ -369,7 +416,10 @@ double DCMotorProblem::getLearningRate() const
 }
 void DCMotorProblem::saveResultsToFile(const std::string& resultName)
 {
-	testPID(getBestParameters(), &m_resultData);
+	// Once stopped, the solver holds the best parameters of the last epoch, the snapshot may be older
+	stopSolver();
+	if (m_solver)
+		testPID(m_solver->getBestParameters(), &m_resultData);
 	m_resultData.resultName = resultName;
 	saveResultDataToFile(m_resultData, "Results");
 	//m_csvExport.exportToFile("Plots/"+filename);
@@ -403,11 +453,7 @@ void DCMotorProblem::setResultsParameterColors(const std::vector<sf::Color>& col
 }
 size_t DCMotorProblem::getParameterCount() const
 {
-	if (m_solverObject)
-	{
-		return m_solverObject->getBestParameters().size();
-	}
-	return 0;
+	return getParameterLabels().size();
 }
 void DCMotorProblem::setResultsParameterEnabled(size_t index, bool enabled)
 {
@@ -505,9 +551,11 @@ bool DCMotorProblem::isResultsStepResponseSignalEnabled(size_t index) const
 }
 std::vector<double> DCMotorProblem::getBestParameters() const
 {
-	if (m_solverObject)
+	// The solver runs on the worker thread, only its snapshot is safe to read here
+	const AutoTuner::SolverSnapshot::Handle& snapshot = m_solverObject->getSnapshot();
+	if (snapshot)
 	{
-		return m_solverObject->getBestParameters();
+		return snapshot->bestParameters;
 	}
 	return {};
 }
@@ -837,6 +885,12 @@ std::vector<double> DCMotorProblem::agentTestFunction(const std::vector<double>&
 	
 
 
+	// Racing: stop once the partial score is worse than the solvers threshold
+	const bool racing = m_setupSettings.useMinimizingScore && m_solver && m_solver->isRacingEnabled();
+	const size_t updateCount = static_cast<size_t>(std::ceil(endTime / dt));
+	const size_t racingCheckInterval = std::max<size_t>(1, updateCount / 100);
+	size_t step = 0;
+
 	size_t nextStepIndex = 0;
 	size_t nextDisturbanceIdex = 0;
 	for (double t = 0; t < endTime; t += dt)
@@ -903,6 +957,25 @@ std::vector<double> DCMotorProblem::agentTestFunction(const std::vector<double>&
 				rWasRising = 0;
 		}
 		lastR = angularSpeed;
+
+		++step;
+		if (racing && step % racingCheckInterval == 0)
+		{
+			// The sums only grow, so the partial score is a lower bound of the final score
+			double partialScore = losses[3] + losses[4] + dt / endTime * (
+				errorSum * m_tuningGoalFactor_errorIntegral +
+				pidOutChangeSum * m_tuningGoalFactor_actuatorEffort / actuatorLimit +
+				overshootSum * m_tuningGoalFactor_overshoot);
+			if (m_solver->isRaceLost(partialScore))
+			{
+				// Extrapolate to the full horizon
+				double extrapolation = static_cast<double>(updateCount) / static_cast<double>(step);
+				errorSum *= extrapolation;
+				pidOutChangeSum *= extrapolation;
+				overshootSum *= extrapolation;
+				break;
+			}
+		}
 	}
 	double invEndTime = 1 / endTime;
 	double invUpdateCount = dt / endTime;
@@ -927,6 +1000,244 @@ std::vector<double> DCMotorProblem::agentTestFunction(const std::vector<double>&
 	}
 }
 
+void DCMotorProblem::agentBatchTestFunction(const AutoTuner::PopulationStore::AgentBlock& block)
+{
+	AT_GENERAL_PROFILING_FUNCTION(AT_COLOR_STAGE_2);
+	typedef AutoTuner::SimdDouble V;
+	const size_t agentCount = block.count;
+	if (agentCount == 0)
+		return;
+	if (block.scorePartCount < 5)
+	{
+		// Score part labels not set, the rows are too small for the batch results
+		std::vector<double> parameters(block.parameterCount);
+		for (size_t i = 0; i < agentCount; ++i)
+		{
+			for (size_t p = 0; p < block.parameterCount; ++p)
+				parameters[p] = block.getParameter(i, p);
+			std::vector<double> scoreParts = agentTestFunction(parameters, block.getAgentIndex(i));
+			for (size_t s = 0; s < std::min(scoreParts.size(), block.scorePartCount); ++s)
+				block.setScorePart(i, s, scoreParts[s]);
+		}
+		return;
+	}
+	const double dt = m_setupSettings.deltaTime;
+	const double endTime = m_setupSettings.endTime;
+
+	// The TestSystem decodes the parameters exactly like the scalar test
+	TestSystem agentSystem(m_setupSettings);
+	const double actuatorLimit = agentSystem.getActuatorInputLimit();
+	const double systemInputLimit = agentSystem.getSystemInputLimit();
+	const bool testMargins = m_tuningGoalFactor_gainMargin != 0 || m_tuningGoalFactor_phaseMargin != 0;
+
+	AutoTuner::PIDBatch pids(agentCount);
+	pids.setConfiguration(agentSystem.getPIDController());
+	DCMotorBatchSystem motors(agentCount);
+	motors.setIntegrationSolver(agentSystem.getDCMotorSystem().getIntegrationSolver());
+	motors.setModel(agentSystem.getDCMotorSystem());
+
+	std::vector<double> gainMarginLosses(agentCount, 0.0);
+	std::vector<double> phaseMarginLosses(agentCount, 0.0);
+	std::vector<double> parameters;
+	for (size_t i = 0; i < agentCount; ++i)
+	{
+		parameters.resize(block.parameterCount);
+		for (size_t p = 0; p < block.parameterCount; ++p)
+			parameters[p] = block.getParameter(i, p);
+		agentSystem.reset();
+		agentSystem.setParameters(parameters);
+		pids.setController(i, agentSystem.getPIDController());
+
+		if (testMargins)
+		{
+			AutoTuner::FrequencyResponse::FrequencyResponseData responseData = m_frequencyResponse.getResponse(agentSystem.getFeedForwardPart(),
+				m_setupSettings.nyquistBeginFreq, m_setupSettings.nyquistEndFreq);
+			gainMarginLosses[i] = std::abs(m_setupSettings.targetGainMargin - responseData.gainMargin) * m_tuningGoalFactor_gainMargin;
+			phaseMarginLosses[i] = std::abs(m_setupSettings.targetPhaseMargin - responseData.phaseMargin) * m_tuningGoalFactor_phaseMargin;
+		}
+	}
+
+	// Score accumulators, one row per value, same meaning as in agentTestFunction
+	const size_t paddedCount = V::getPaddedCount(agentCount);
+	std::vector<double> errorSums(paddedCount, 0.0);
+	std::vector<double> overshootSums(paddedCount, 0.0);
+	std::vector<double> pidOutChangeSums(paddedCount, 0.0);
+	std::vector<double> lastPIDOutputs(paddedCount, 0.0);
+	std::vector<double> lastAngularSpeeds(paddedCount, 0.0);
+	std::vector<double> rWasRising(paddedCount, 0.0);
+
+	const std::vector<sf::Vector2<double>>& disturbanceData = m_learningDisturbanceData;
+	const std::vector<sf::Vector2<double>>& stepData = m_learningStepData;
+
+	const V dtV = V::broadcast(dt);
+	const V zero = V::broadcast(0.0);
+	const V half = V::broadcast(0.5);
+	const V onePointFive = V::broadcast(1.5);
+	const V two = V::broadcast(2.0);
+	const V systemInputLimitV = V::broadcast(systemInputLimit);
+	const V upperSaturationThreshold = V::broadcast(actuatorLimit - 0.01);
+	const V lowerSaturationThreshold = V::broadcast(0.01);
+	const bool disableErrorWhenSaturated = m_setupSettings.disableErrorIntegrationWhenSaturated;
+
+	// Racing: an agent whose partial score is worse than the solvers threshold keeps its sums of that moment.
+	// The block stops once all agents lost.
+	const bool racing = m_setupSettings.useMinimizingScore && m_solver && m_solver->isRacingEnabled();
+	const size_t updateCount = static_cast<size_t>(std::ceil(endTime / dt));
+	const size_t racingCheckInterval = std::max<size_t>(1, updateCount / 100);
+	const double racingErrorFactor = dt / endTime * m_tuningGoalFactor_errorIntegral;
+	const double racingPidOutChangeFactor = dt / endTime * m_tuningGoalFactor_actuatorEffort / actuatorLimit;
+	const double racingOvershootFactor = dt / endTime * m_tuningGoalFactor_overshoot;
+	std::vector<size_t> lostAtStep(agentCount, 0);
+	std::vector<double> lostErrorSums(agentCount, 0.0);
+	std::vector<double> lostOvershootSums(agentCount, 0.0);
+	std::vector<double> lostPidOutChangeSums(agentCount, 0.0);
+	size_t runningCount = agentCount;
+	size_t step = 0;
+
+	double r = 0;
+	double disturbance = 0;
+	size_t nextStepIndex = 0;
+	size_t nextDisturbanceIdex = 0;
+	for (double t = 0; t < endTime; t += dt)
+	{
+		// The reference and disturbance sequences are the same for all agents
+		bool stepChanged = false;
+		if (nextStepIndex < stepData.size())
+		{
+			if (t >= stepData[nextStepIndex].x)
+			{
+				r = stepData[nextStepIndex].y;
+				stepChanged = true;
+				nextStepIndex++;
+			}
+		}
+		if (nextDisturbanceIdex < disturbanceData.size())
+		{
+			if (t >= disturbanceData[nextDisturbanceIdex].x)
+			{
+				disturbance = disturbanceData[nextDisturbanceIdex].y;
+				nextDisturbanceIdex++;
+			}
+		}
+		const V rV = V::broadcast(r);
+
+		// e(t) = r(t) - y(t)
+		double* pidInputs = pids.getInputs();
+		const double* angularSpeeds = motors.getAngularVelocities();
+		for (size_t i = 0; i < paddedCount; i += V::s_laneCount)
+			(rV - V::load(angularSpeeds + i)).store(pidInputs + i);
+		pids.update(dt);
+
+		std::copy(pids.getOutputs(), pids.getOutputs() + paddedCount, motors.getInputVoltages());
+		motors.setDisturbance(disturbance);
+		motors.update(dt);
+
+		const double* pidOutputs = pids.getOutputs();
+		for (size_t i = 0; i < paddedCount; i += V::s_laneCount)
+		{
+			V pidOutput = V::load(pidOutputs + i);
+			V angularSpeed = V::load(angularSpeeds + i);
+			V lastAngularSpeed = V::load(lastAngularSpeeds.data() + i);
+			V rising = V::load(rWasRising.data() + i);
+			if (stepChanged)
+				rising = V::maskToOne(V::greaterThan(rV, lastAngularSpeed));
+
+			// Penalize large control changes
+			V lastPIDOutput = V::load(lastPIDOutputs.data() + i);
+			V pidOutChangeSum = V::load(pidOutChangeSums.data() + i) + V::abs((pidOutput - lastPIDOutput) / dtV);
+			pidOutChangeSum.store(pidOutChangeSums.data() + i);
+			pidOutput.store(lastPIDOutputs.data() + i);
+
+			// The error is taken before the motor update, the same as TestSystem::getError()
+			V error = V::abs(V::load(pidInputs + i) / systemInputLimitV);
+			if (disableErrorWhenSaturated)
+			{
+				V skip = V::maskOr(
+					V::maskAnd(V::greaterThan(pidOutput, upperSaturationThreshold), V::greaterThan(rV, angularSpeed)),
+					V::maskAnd(V::lessThan(pidOutput, lowerSaturationThreshold), V::lessThan(rV, angularSpeed)));
+				error = V::select(skip, zero, error);
+			}
+			(V::load(errorSums.data() + i) + error).store(errorSums.data() + i);
+
+			// Check overshoot
+			V overshooting = V::maskAnd(V::maskAnd(V::lessThan(lastAngularSpeed, angularSpeed), V::lessThan(rV, angularSpeed)),
+				V::greaterThan(rising, half));
+			V overshoot = V::abs((angularSpeed - rV) / systemInputLimitV);
+			(V::load(overshootSums.data() + i) + V::select(overshooting, overshoot, zero)).store(overshootSums.data() + i);
+			rising = V::select(overshooting, two, V::select(V::greaterThan(rising, onePointFive), zero, rising));
+			rising.store(rWasRising.data() + i);
+			angularSpeed.store(lastAngularSpeeds.data() + i);
+		}
+
+		++step;
+		if (racing && step % racingCheckInterval == 0)
+		{
+			for (size_t i = 0; i < agentCount; ++i)
+			{
+				if (lostAtStep[i] != 0)
+					continue;
+				double partialScore = gainMarginLosses[i] + phaseMarginLosses[i] +
+					errorSums[i] * racingErrorFactor +
+					pidOutChangeSums[i] * racingPidOutChangeFactor +
+					overshootSums[i] * racingOvershootFactor;
+				if (m_solver->isRaceLost(partialScore))
+				{
+					block.setRaceLost(i);
+					lostAtStep[i] = step;
+					lostErrorSums[i] = errorSums[i];
+					lostOvershootSums[i] = overshootSums[i];
+					lostPidOutChangeSums[i] = pidOutChangeSums[i];
+					--runningCount;
+				}
+			}
+			if (runningCount == 0)
+				break;
+		}
+	}
+
+	// Agents that lost the race get their sums extrapolated to the full horizon
+	for (size_t i = 0; i < agentCount; ++i)
+	{
+		if (lostAtStep[i] == 0)
+			continue;
+		double extrapolation = static_cast<double>(updateCount) / static_cast<double>(lostAtStep[i]);
+		errorSums[i] = lostErrorSums[i] * extrapolation;
+		overshootSums[i] = lostOvershootSums[i] * extrapolation;
+		pidOutChangeSums[i] = lostPidOutChangeSums[i] * extrapolation;
+	}
+
+	double invUpdateCount = dt / endTime;
+	double overshootFactor = invUpdateCount * m_tuningGoalFactor_overshoot;
+	double errorFactor = invUpdateCount * m_tuningGoalFactor_errorIntegral;
+	double pidOutChangeFactor = invUpdateCount * m_tuningGoalFactor_actuatorEffort / actuatorLimit;
+
+	double* errorRow = block.getScorePartRow(0);
+	double* pidOutChangeRow = block.getScorePartRow(1);
+	double* overshootRow = block.getScorePartRow(2);
+	double* gainMarginRow = block.getScorePartRow(3);
+	double* phaseMarginRow = block.getScorePartRow(4);
+	for (size_t i = 0; i < agentCount; ++i)
+	{
+		double errorSum = errorSums[i] * errorFactor;
+		double pidOutChangeSum = pidOutChangeSums[i] * pidOutChangeFactor;
+		double overshootSum = overshootSums[i] * overshootFactor;
+		if (m_setupSettings.useMinimizingScore)
+		{
+			errorRow[i] = errorSum;
+			pidOutChangeRow[i] = pidOutChangeSum;
+			overshootRow[i] = overshootSum;
+		}
+		else
+		{
+			errorRow[i] = 500.0 / (500 * (errorSum + pidOutChangeSum + overshootSum) + 0.1);
+			pidOutChangeRow[i] = 0.0;
+			overshootRow[i] = 0.0;
+		}
+		gainMarginRow[i] = gainMarginLosses[i];
+		phaseMarginRow[i] = phaseMarginLosses[i];
+	}
+}
+
 void DCMotorProblem::printSignalSequenceToConsole(const std::string& name, const std::vector<sf::Vector2<double>>& steps) const
 {
 	std::string stepSignalTimeData = name + "Time data = [";
@@ -959,11 +1270,13 @@ void DCMotorProblem::printSignalSequenceToConsole(const std::string& name, const
 std::vector<sf::Vector2<double>>  DCMotorProblem::generateRandomStepSequence(double stepAmplitude, double maxTime, double minStepDuration, double maxStepDuration, size_t stepCount)
 {
 	std::vector<sf::Vector2<double>> stepData;
+	// Each sequence draws from its own stream of the solver seed, like the initial population
+	AutoTuner::RandomStream random = m_solver->createRandomStream(AutoTuner::Solver::s_problemStream, static_cast<uint32_t>(m_stepSequenceCount++));
 	double currentTime = 0.0;
 	for (size_t i = 0; i < stepCount; ++i)
 	{
-		double stepTime = AutoTuner::Solver::getRandomDouble(currentTime + minStepDuration, std::min(currentTime + maxStepDuration, maxTime));
-		double stepValue = AutoTuner::Solver::getRandomDouble(0.0, stepAmplitude);
+		double stepTime = random.getDouble(currentTime + minStepDuration, std::min(currentTime + maxStepDuration, maxTime));
+		double stepValue = random.getDouble(0.0, stepAmplitude);
 		stepData.push_back({ stepTime, stepValue });
 		currentTime = stepTime;
 		if (currentTime >= maxTime)
@@ -1022,29 +1335,33 @@ void DCMotorProblem::setCSVHeader()
 	//};*/
 	//m_csvExport.setLineColors(csvLineColor);
 }
-void DCMotorProblem::logCSVData()
+void DCMotorProblem::logCSVData(const AutoTuner::PopulationStore::Generation& generation)
 {
-	if (m_solverObject)
+	if (m_solver && generation.getAgentCount() > 0)
 	{
-		std::vector<double> score = m_solverObject->getScores();
-		double minScore = 0.0;
-		double maxScore = 0.0;
-		double averageScore = 0.0;
-		if (score.size() > 0)
+		const bool minimizing = m_solver->getOptimizingDirection() == AutoTuner::Solver::OptimizingDirection::Minimize;
+		double minScore = generation.getScore(0);
+		double maxScore = generation.getScore(0);
+		double sumScores = 0.0;
+		size_t bestIndex = 0;
+		for (size_t i = 0; i < generation.getAgentCount(); ++i)
 		{
-			minScore = score[0];
-			maxScore = score[0];
-			double sumScores = 0.0;
-			for (double s : score)
+			double s = generation.getScore(i);
+			if (s < minScore)
+			{
+				minScore = s;
+				if (minimizing)
+					bestIndex = i;
+			}
+			if (s > maxScore)
 			{
-				if (s < minScore)
-					minScore = s;
-				if (s > maxScore)
-					maxScore = s;
-				sumScores += s;
+				maxScore = s;
+				if (!minimizing)
+					bestIndex = i;
 			}
-			averageScore = sumScores / static_cast<double>(score.size());
+			sumScores += s;
 		}
+		double averageScore = sumScores / static_cast<double>(generation.getAgentCount());
 
 		const double filterAlpha = 0.1;
 		static double averageScoreFiltered = averageScore;
@@ -1072,7 +1389,9 @@ void DCMotorProblem::logCSVData()
 		//	std::to_string(averageScoreFiltered),
 		//	std::to_string(minScoreFiltered),
 		//	std::to_string(maxScoreFiltered) });
-		const auto bestParameters = m_solverObject->getBestParameters();
+		// The solver updates its best parameters after the generation got reported
+		std::vector<double> bestParameters;
+		generation.getParameters(bestIndex, bestParameters);
 		std::vector<ResultData::ColumnData>& parameterChanges = m_resultData.parameterChanges.parameters;
 		/*for (size_t i = 0; i< bestParameters.size(); ++i)
 		{
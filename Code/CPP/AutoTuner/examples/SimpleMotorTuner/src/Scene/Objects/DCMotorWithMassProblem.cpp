@@ -47,7 +47,7 @@ DCMotorWithMassProblem::DCMotorWithMassProblem(const SetupSettings& setupSetting
 //#ifdef USE_GENTIC_SOLVER
 //	AutoTuner::GeneticSolver *gs = new AutoTuner::GeneticSolver();
 //	gs->setMutationAmount(m_learningRate);
-//	m_solverObject = gs;
+//	m_solver = gs;
 //#endif
 
 
@@ -58,14 +58,29 @@ DCMotorWithMassProblem::DCMotorWithMassProblem(const SetupSettings& setupSetting
 		{
 			AutoTuner::GeneticSolver* gs = new AutoTuner::GeneticSolver();
 			gs->setMutationAmount(m_setupSettings.startLearningRate);
-			m_solverObject = gs;
+			gs->setSteadyStateEnabled(m_setupSettings.useSteadyStateGenetic);
+			m_solver = gs;
 			break;
 		}
 		case SolverType::DifferentialEvolution:
 		{
 			AutoTuner::DifferentialEvolutionSolver* ds = new AutoTuner::DifferentialEvolutionSolver();
 			ds->setMutationAmount(m_setupSettings.startLearningRate);
-			m_solverObject = ds;
+			m_solver = ds;
+			break;
+		}
+		case SolverType::CMAES:
+		{
+			// Adapts its own step size, the learning rate is not used
+			m_solver = new AutoTuner::CMAESSolver();
+			break;
+		}
+		case SolverType::NSGA2:
+		{
+			// Keeps the Pareto front of the score parts, the summed score still picks the tuned parameters
+			AutoTuner::NSGA2Solver* ns = new AutoTuner::NSGA2Solver();
+			ns->setMutationAmount(m_setupSettings.startLearningRate);
+			m_solver = ns;
 			break;
 		}
 		default:
@@ -77,20 +92,22 @@ DCMotorWithMassProblem::DCMotorWithMassProblem(const SetupSettings& setupSetting
 #ifdef USE_DIFFERENTIAL_EVOLUTION_SOLVER
 	AutoTuner::DifferentialEvolutionSolver *ds = new AutoTuner::DifferentialEvolutionSolver();
 	ds->setMutationAmount(s_startLearningRate);
-	m_solverObject = ds;
+	m_solver = ds;
 #endif
 
 #ifdef GENETIC_USE_MINIMIZING_SCORE
-	m_solverObject->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Minimize);
+	m_solver->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Minimize);
 #else
-	m_solverObject->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Maximize);
+	m_solver->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Maximize);
 #endif
 	*/
 	if (m_setupSettings.useMinimizingScore)
-		m_solverObject->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Minimize);
+		m_solver->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Minimize);
 	else
-		m_solverObject->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Maximize);
+		m_solver->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Maximize);
+	m_solverObject = new AutoTuner::SolverObject(m_solver);
 	addChild(m_solverObject);
+	m_solverObject->getWorker().setEpochCallback(std::bind(&DCMotorWithMassProblem::onEpoch, this, std::placeholders::_1, std::placeholders::_2));
 
 	
 	m_solverObject->setParametersToColorFunc(
@@ -104,8 +121,8 @@ DCMotorWithMassProblem::DCMotorWithMassProblem(const SetupSettings& setupSetting
 			return sf::Color(r, g, b);
 		}
 	);
-	m_solverObject->setParametersTestFunc(std::bind(&DCMotorWithMassProblem::agentTestFunction, this, std::placeholders::_1, std::placeholders::_2));
-	m_solverObject->setScorePartsLabels({ "error", "pidOutChange", "Overshoot", "GainMargin", "PhaseMargin" });
+	m_solver->setParametersTestFunc(std::bind(&DCMotorWithMassProblem::agentTestFunction, this, std::placeholders::_1, std::placeholders::_2));
+	m_solver->setScorePartsLabels({ "error", "pidOutChange", "Overshoot", "GainMargin", "PhaseMargin" });
 	
 	//geneticSolver->setTargetScore(AutoTuner::GeneticSolver::TargetScore::Minimize);
 	
@@ -168,6 +185,11 @@ DCMotorWithMassProblem::DCMotorWithMassProblem(const SetupSettings& setupSetting
 	
 }
 
+DCMotorWithMassProblem::~DCMotorWithMassProblem()
+{
+	m_solverObject->getWorker().stop();
+}
+
 void DCMotorWithMassProblem::onAwake()
 {
 	testCustomPID();
@@ -207,30 +229,33 @@ void DCMotorWithMassProblem::precalculatePIDWithZieglerNichols()
 }
 void DCMotorWithMassProblem::setupPopulation(size_t populationSize, double kp, double ki, double kd, double integralSatturation, double areaRange)
 {
-	//AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solverObject);
-	if (m_solverObject)
+	//AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solver);
+	if (m_solver)
 	{
+		stopSolver();
 		m_setupSettings.agentCount = populationSize;
 		std::vector<std::vector<double>> initialPopulation;
+		// Own stream of the solver seed, so the whole run is reproducible from that seed
+		AutoTuner::RandomStream random = m_solver->createRandomStream(AutoTuner::Solver::s_populationStream);
 		for (size_t i = 0; i < populationSize; ++i)
 		{
 			std::vector<double> individual;
 			if (m_setupSettings.optimizeKp)
-				individual.push_back(kp + AutoTuner::Solver::getRandomDouble(-areaRange, areaRange)); // Kp
+				individual.push_back(kp + random.getDouble(-areaRange, areaRange)); // Kp
 
 			if (m_setupSettings.optimizeKi)
-				individual.push_back(ki + AutoTuner::Solver::getRandomDouble(-areaRange, areaRange)); // Ki
+				individual.push_back(ki + random.getDouble(-areaRange, areaRange)); // Ki
 
 			if (m_setupSettings.optimizeKd)
-				individual.push_back(kd + AutoTuner::Solver::getRandomDouble(-areaRange, areaRange));  // Kd
+				individual.push_back(kd + random.getDouble(-areaRange, areaRange));  // Kd
 
 			if (m_setupSettings.useKn &&m_setupSettings.optimizeKn)
-				individual.push_back(m_setupSettings.defaultKn + AutoTuner::Solver::getRandomDouble(-areaRange, areaRange)); // Kn
+				individual.push_back(m_setupSettings.defaultKn + random.getDouble(-areaRange, areaRange)); // Kn
 			
 			if (m_setupSettings.optimizeIntegralSaturation)
-				individual.push_back(m_setupSettings.defaultPIDISaturation * AutoTuner::Solver::getRandomDouble(0, 2 * areaRange));
+				individual.push_back(m_setupSettings.defaultPIDISaturation * random.getDouble(0, 2 * areaRange));
 			if (m_setupSettings.optimizeAntiWindupBackCalculationConstant)
-				individual.push_back(m_setupSettings.defaultPIDAntiWindupBackCalculationConstant + AutoTuner::Solver::getRandomDouble(-areaRange, areaRange));
+				individual.push_back(m_setupSettings.defaultPIDAntiWindupBackCalculationConstant + random.getDouble(-areaRange, areaRange));
 
 			/*
 #ifdef PARAMETERLIST_ENABLE_KP
@@ -254,7 +279,7 @@ void DCMotorWithMassProblem::setupPopulation(size_t populationSize, double kp, d
 			*/
 			initialPopulation.push_back(individual);
 		}
-		AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solverObject);
+		AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solver);
 		if (geneticSolver)
 		{
 			if (geneticSolver->isThreadsBusy())
@@ -263,8 +288,8 @@ void DCMotorWithMassProblem::setupPopulation(size_t populationSize, double kp, d
 				return;
 			}
 		}
-		m_solverObject->setInitialParameters(initialPopulation);
-		m_solverObject->clearAlltimeBestParameters();
+		m_solver->setInitialParameters(initialPopulation);
+		m_solver->clearAlltimeBestParameters();
 		testPID(initialPopulation[0]);
 		//testPID({5,35.7,0,10});
 	}
@@ -272,11 +297,12 @@ void DCMotorWithMassProblem::setupPopulation(size_t populationSize, double kp, d
 
 void DCMotorWithMassProblem::update()
 {
-	if (m_solverObject)
+	if (m_solver)
 	{
 #ifdef DYNAMIC_STEP_SEQUENCE
 		if (m_learningStepData.size() == 0)
 		{
+			stopSolver();
 			m_learningStepData.clear();
 			m_learningStepData.resize(m_testRuns);
 			for (size_t i = 0; i < m_testRuns; ++i)
@@ -284,33 +310,40 @@ void DCMotorWithMassProblem::update()
 		}
 #endif
 
-		m_solverObject->test();
-		m_solverObject->iterate();
-
-		
-		logCSVData();
-		++m_epochCounter;
-		if(m_setupSettings.targetEpochs <= m_epochCounter)
+		// The epochs run on the worker, see onEpoch()
+		AutoTuner::SolverWorker& worker = m_solverObject->getWorker();
+		size_t epoch = worker.getEpoch();
+		if(m_setupSettings.targetEpochs <= epoch)
 		{
-			emit targetEpochReached(m_epochCounter);
+			emit targetEpochReached(epoch);
 		}
+		// Continues after the target epoch or after a change that stopped the worker
+		if (!worker.isRunning())
+			startSolver();
+	}
+}
+bool DCMotorWithMassProblem::onEpoch(size_t, const AutoTuner::PopulationStore::Generation& generation)
+{
+	logCSVData(generation);
+	++m_epochCounter;
 
-		AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solverObject);
-		if (geneticSolver)
-		{
-			//#if defined(USE_GENTIC_SOLVER)
-			if (m_setupSettings.useGeneticMutationRateDecay)
-			{
-				//AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solverObject);
-				//if (geneticSolver)
-				//{
-				m_learningRate *= m_setupSettings.learningRateDecay;
-				geneticSolver->setMutationAmount(m_learningRate);
-				//}
-			}
-		}
-		//#endif
+	AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solver);
+	if (geneticSolver && m_setupSettings.useGeneticMutationRateDecay)
+	{
+		m_learningRate = m_learningRate * m_setupSettings.learningRateDecay;
+		geneticSolver->setMutationAmount(m_learningRate);
 	}
+	return true;
+}
+void DCMotorWithMassProblem::startSolver()
+{
+	AutoTuner::SolverWorker& worker = m_solverObject->getWorker();
+	size_t epoch = worker.getEpoch();
+	worker.start(epoch < m_setupSettings.targetEpochs ? m_setupSettings.targetEpochs - epoch : 0);
+}
+void DCMotorWithMassProblem::stopSolver() const
+{
+	m_solverObject->getWorker().stop();
 }
 
 void DCMotorWithMassProblem::createNewStepSequence()
@@ -321,17 +354,14 @@ void DCMotorWithMassProblem::createNewStepSequence()
 }
 void DCMotorWithMassProblem::resetPopulation()
 {
-	if (m_solverObject)
+	if (m_solver)
 	{
+		stopSolver();
 		
 		//createNewStepSequence();
 		if (m_learningStepData.size() > 0)
 			m_stepData = m_learningStepData;
 
-		double kp = (rand() % 20) - 10;
-		double ki = (rand() % 20) - 10;
-		double kd = (rand() % 20) - 10;
-		
 		//setupPopulation(kp, ki, kd,m_defaultPIDISatturation,  1);
 		//testPID(kp, ki, kd, m_defaultPIDISatturation);
 
@@ -344,37 +374,41 @@ void DCMotorWithMassProblem::resetPopulation()
 }
 void DCMotorWithMassProblem::testBestAgent()
 {
-	if (m_solverObject)
+	if (m_solver)
 	{
-		auto parameters = m_solverObject->getBestParameters();
+		auto parameters = getBestParameters();
 		testPID(parameters);
 	}
 }
 void DCMotorWithMassProblem::setLearningAmount(double learningAmount)
 {
-	if (m_solverObject)
+	if (m_solver)
 	{
-		m_solverObject->setMutationAmount(learningAmount);
+		stopSolver();
+		m_solver->setMutationAmount(learningAmount);
 	}
 }
 double DCMotorWithMassProblem::getLearningAmount() const
 {
-	if(m_solverObject)
+	if(m_solver)
 	{
-		return m_solverObject->getMutationAmount();
+		// The worker decays the mutation amount of the GeneticSolver
+		stopSolver();
+		return m_solver->getMutationAmount();
 	}
 	return 0.0;
 }
 void DCMotorWithMassProblem::setLearningRate(double learningRate)
 {
-	AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solverObject);
+	stopSolver();
+	AutoTuner::GeneticSolver* geneticSolver = dynamic_cast<AutoTuner::GeneticSolver*>(m_solver);
 	m_learningRate = learningRate;
 	if (geneticSolver)
 	{
 		geneticSolver->setMutationAmount(learningRate);
 		return;
 	}
-	AutoTuner::DifferentialEvolutionSolver* deSolver = dynamic_cast<AutoTuner::DifferentialEvolutionSolver*>(m_solverObject);
+	AutoTuner::DifferentialEvolutionSolver* deSolver = dynamic_cast<AutoTuner::DifferentialEvolutionSolver*>(m_solver);
 	if (deSolver)
 	{
 		deSolver->setMutationAmount(learningRate);
@@ -386,7 +420,10 @@ double DCMotorWithMassProblem::getLearningRate() const
 }
 void DCMotorWithMassProblem::saveResultsToFile(const std::string& resultName)
 {
-	testPID(getBestParameters(), &m_resultData);
+	// Once stopped, the solver holds the best parameters of the last epoch, the snapshot may be older
+	stopSolver();
+	if (m_solver)
+		testPID(m_solver->getBestParameters(), &m_resultData);
 	m_resultData.resultName = resultName;
 	saveResultDataToFile(m_resultData, "Results");
 	//m_csvExport.exportToFile("Plots/"+filename);
@@ -420,11 +457,7 @@ void DCMotorWithMassProblem::setResultsParameterColors(const std::vector<sf::Col
 }
 size_t DCMotorWithMassProblem::getParameterCount() const
 {
-	if (m_solverObject)
-	{
-		return m_solverObject->getBestParameters().size();
-	}
-	return 0;
+	return getParameterLabels().size();
 }
 void DCMotorWithMassProblem::setResultsParameterEnabled(size_t index, bool enabled)
 {
@@ -522,9 +555,11 @@ bool DCMotorWithMassProblem::isResultsStepResponseSignalEnabled(size_t index) co
 }
 std::vector<double> DCMotorWithMassProblem::getBestParameters() const
 {
-	if (m_solverObject)
+	// The solver runs on the worker thread, only its snapshot is safe to read here
+	const AutoTuner::SolverSnapshot::Handle& snapshot = m_solverObject->getSnapshot();
+	if (snapshot)
 	{
-		return m_solverObject->getBestParameters();
+		return snapshot->bestParameters;
 	}
 	return {};
 }
@@ -558,6 +593,8 @@ void DCMotorWithMassProblem::testPID(const std::vector<double>& params, ResultDa
 
 	m_testSystem.reset();
 	m_testSystem.setParameters(params);
+	if (m_solver)
+		m_testSystem.setMeasurementNoise(m_solver->createRandomStream(s_measurementNoiseStream));
 	m_chartViewComponent->clearPlotData();
 
 	AutoTuner::ChartViewComponent::PlotData rPlotData("r");
@@ -817,6 +854,7 @@ std::vector<double> DCMotorWithMassProblem::agentTestFunction(const std::vector<
 	TestSystem agentSystem(m_setupSettings);
 	agentSystem.reset();
 	agentSystem.setParameters(parameters);
+	agentSystem.setMeasurementNoise(m_solver->createRandomStream(s_measurementNoiseStream, static_cast<uint32_t>(agent)));
 
 	double r = 0;
 	double disturbance = 0;
@@ -993,11 +1031,13 @@ void DCMotorWithMassProblem::printSignalSequenceToConsole(const std::string& nam
 std::vector<sf::Vector2<double>>  DCMotorWithMassProblem::generateRandomStepSequence(double stepAmplitude, double maxTime, double minStepDuration, double maxStepDuration, size_t stepCount)
 {
 	std::vector<sf::Vector2<double>> stepData;
+	// Each sequence draws from its own stream of the solver seed, like the initial population
+	AutoTuner::RandomStream random = m_solver->createRandomStream(s_stepSequenceStream, static_cast<uint32_t>(m_stepSequenceCount++));
 	double currentTime = 0.0;
 	for (size_t i = 0; i < stepCount; ++i)
 	{
-		double stepTime = AutoTuner::Solver::getRandomDouble(currentTime + minStepDuration, std::min(currentTime + maxStepDuration, maxTime));
-		double stepValue = AutoTuner::Solver::getRandomDouble(0.0, stepAmplitude);
+		double stepTime = random.getDouble(currentTime + minStepDuration, std::min(currentTime + maxStepDuration, maxTime));
+		double stepValue = random.getDouble(0.0, stepAmplitude);
 		stepData.push_back({ stepTime, stepValue });
 		currentTime = stepTime;
 		if (currentTime >= maxTime)
@@ -1056,29 +1096,33 @@ void DCMotorWithMassProblem::setCSVHeader()
 	//};*/
 	//m_csvExport.setLineColors(csvLineColor);
 }
-void DCMotorWithMassProblem::logCSVData()
+void DCMotorWithMassProblem::logCSVData(const AutoTuner::PopulationStore::Generation& generation)
 {
-	if (m_solverObject)
+	if (m_solver && generation.getAgentCount() > 0)
 	{
-		std::vector<double> score = m_solverObject->getScores();
-		double minScore = 0.0;
-		double maxScore = 0.0;
-		double averageScore = 0.0;
-		if (score.size() > 0)
+		const bool minimizing = m_solver->getOptimizingDirection() == AutoTuner::Solver::OptimizingDirection::Minimize;
+		double minScore = generation.getScore(0);
+		double maxScore = generation.getScore(0);
+		double sumScores = 0.0;
+		size_t bestIndex = 0;
+		for (size_t i = 0; i < generation.getAgentCount(); ++i)
 		{
-			minScore = score[0];
-			maxScore = score[0];
-			double sumScores = 0.0;
-			for (double s : score)
+			double s = generation.getScore(i);
+			if (s < minScore)
+			{
+				minScore = s;
+				if (minimizing)
+					bestIndex = i;
+			}
+			if (s > maxScore)
 			{
-				if (s < minScore)
-					minScore = s;
-				if (s > maxScore)
-					maxScore = s;
-				sumScores += s;
+				maxScore = s;
+				if (!minimizing)
+					bestIndex = i;
 			}
-			averageScore = sumScores / static_cast<double>(score.size());
+			sumScores += s;
 		}
+		double averageScore = sumScores / static_cast<double>(generation.getAgentCount());
 
 		const double filterAlpha = 0.1;
 		static double averageScoreFiltered = averageScore;
@@ -1106,7 +1150,9 @@ void DCMotorWithMassProblem::logCSVData()
 		//	std::to_string(averageScoreFiltered),
 		//	std::to_string(minScoreFiltered),
 		//	std::to_string(maxScoreFiltered) });
-		const auto bestParameters = m_solverObject->getBestParameters();
+		// The solver updates its best parameters after the generation got reported
+		std::vector<double> bestParameters;
+		generation.getParameters(bestIndex, bestParameters);
 		std::vector<ResultData::ColumnData>& parameterChanges = m_resultData.parameterChanges.parameters;
 		/*for (size_t i = 0; i< bestParameters.size(); ++i)
 		{
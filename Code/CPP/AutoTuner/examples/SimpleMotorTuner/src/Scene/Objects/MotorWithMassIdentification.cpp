@@ -11,10 +11,10 @@ MotorWithMassIdentification::MotorWithMassIdentification()
 	m_systemOptimizer = new SystemOptimizer("SystemOptimizer");
 	addChild(m_systemOptimizer);
 
-	//m_solverObject = new AutoTuner::DifferentialEvolutionSolver();
-	m_solverObject = new AutoTuner::GeneticSolver();
-	m_solverObject->setMutationAmount(0.1);
-	m_systemOptimizer->setSolverObject(m_solverObject);
+	//m_solver = new AutoTuner::DifferentialEvolutionSolver();
+	m_solver = new AutoTuner::GeneticSolver();
+	m_solver->setMutationAmount(0.1);
+	m_systemOptimizer->setSolver(m_solver);
 
 	//std::vector<SystemOptimizer::StimulusResponseData> data = loadStimulusResponseDataFromCSV("simoutData4_filtered.csv");
 	//std::vector<SystemOptimizer::StimulusResponseData> data = loadStimulusResponseDataFromCSV("simoutData4_filtered.csv");
@@ -5,30 +5,40 @@ SystemOptimizer::SystemOptimizer(const std::string& name,
 	GameObject* parent)
 	: QSFML::Objects::GameObject(name, parent)
 	, m_systemPlotModel(nullptr)
-	, m_solverObject(nullptr)
+	, m_solver(nullptr)
 {
 
 	m_chartViewComponent = new AutoTuner::ChartViewComponent("ChartViewComponent");
 	addComponent(m_chartViewComponent);
 }
+SystemOptimizer::~SystemOptimizer()
+{
+	if (m_solverObject)
+		m_solverObject->getWorker().stop();
+}
 
 
 
 
 
-void SystemOptimizer::setSolverObject(AutoTuner::Solver* solver)
+void SystemOptimizer::setSolver(AutoTuner::Solver* solver)
 {
-	if (m_solverObject)
+	if (m_solver)
 	{
-		m_solverObject->setParametersTestFunc(nullptr);
+		m_solverObject->getWorker().stop();
+		m_optimizing = false;
+		m_solver->setParametersTestFunc(nullptr);
 		removeChild(m_solverObject);
+		m_solverObject = nullptr;
 	}
-	m_solverObject = solver;
-	if (m_solverObject)
+	m_solver = solver;
+	if (m_solver)
 	{
-		m_solverObject->setParametersTestFunc(std::bind(&SystemOptimizer::agentTestFunction, this, std::placeholders::_1, std::placeholders::_2));
-		m_solverObject->setScorePartsLabels({ "rmse" });
-		m_solverObject->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Minimize);
+		m_solver->setParametersTestFunc(std::bind(&SystemOptimizer::agentTestFunction, this, std::placeholders::_1, std::placeholders::_2));
+		m_solver->setScorePartsLabels({ "rmse" });
+		m_solver->setOptimizingDirection(AutoTuner::Solver::OptimizingDirection::Minimize);
+		m_solver->setRacingEnabled(true);
+		m_solverObject = new AutoTuner::SolverObject(m_solver);
 		addChild(m_solverObject);
 	}
 }
@@ -56,50 +66,55 @@ void SystemOptimizer::startOptimization()
 }
 void SystemOptimizer::startOptimization(const std::vector<std::vector<double>>& startParams)
 {
-	if (m_optimizing || !m_solverObject || !m_systemPlotModel)
+	if (m_optimizing || !m_solver || !m_systemPlotModel)
 		return;
 	m_optimizing = true;
 	m_currentEpoch = 0;
-	m_solverObject->clearAlltimeBestParameters();
-	m_solverObject->setInitialParameters(startParams);
+	m_solver->clearAlltimeBestParameters();
+	m_solver->setInitialParameters(startParams);
 
 	cloneSystems();
+	m_solverObject->getWorker().start();
 }
 void SystemOptimizer::stopOptimization()
 {
 	if(!m_optimizing)
 		return;
+	m_solverObject->getWorker().stop();
 	m_optimizing = false;
 }
 
 
 void SystemOptimizer::updateBestParametersChartView(double dtResolution)
 {
-	if (m_solverObject && m_systemPlotModel && m_chartViewComponent && m_stimulusResponseDataCollection.size() > 2)
+	if (m_solver && m_systemPlotModel && m_chartViewComponent && m_stimulusResponseDataCollection.size() > 2)
 	{
+		// The solver runs on the worker thread, only its snapshot is safe to read here
+		const AutoTuner::SolverSnapshot::Handle& handle = m_solverObject->getSnapshot();
+		if (!handle || handle->bestParameters.empty())
+			return;
+		const AutoTuner::SolverSnapshot& snapshot = *handle;
 		++m_printBestCounter;
 		if (m_printBestCounter >= 1000)
 		{
 			m_printBestCounter = 0;
-			auto bestParams = m_solverObject->getBestParameters();
-			std::cout << "Epoch " << m_currentEpoch << " Best Parameters: [";
-			for (const auto& p : bestParams)
+			std::cout << "Epoch " << snapshot.epoch << " Best Parameters: [";
+			for (const auto& p : snapshot.bestParameters)
 			{
 				std::cout << p << " ";
 			}
-			auto scores = m_solverObject->getScores();
 			std::cout << "] Score: ";
 			double scoreSum = 0;
-			for (const auto& s : scores)
+			for (size_t i = 0; i < snapshot.generation.getAgentCount(); ++i)
 			{
-				scoreSum += s;
+				scoreSum += snapshot.generation.getScore(i);
 			}
 			std::cout << scoreSum;
 			std::cout << std::endl;
 		}
 
-		//m_bestParameters = m_solverObject->getAlltimeBestParameters();
-		m_bestParameters = m_solverObject->getBestParameters();
+		//m_bestParameters = snapshot.alltimeBestParameters;
+		m_bestParameters = snapshot.bestParameters;
 		m_chartViewComponent->clearPlotData();
 
 		std::vector<AutoTuner::ChartViewComponent::PlotData> inputSingals;
@@ -170,11 +185,14 @@ void SystemOptimizer::update()
 {
 	if (m_optimizing)
 	{
-		if (m_solverObject && m_systemPlotModel)
+		if (m_solver && m_systemPlotModel)
 		{
-			m_solverObject->test();
-			m_solverObject->iterate();
-			m_currentEpoch++;
+			// The worker runs the epochs, replot at most once per frame when a new one finished
+			m_currentEpoch = m_solverObject->getWorker().getEpoch();
+			const AutoTuner::SolverSnapshot::Handle& snapshot = m_solverObject->getSnapshot();
+			if (!snapshot || snapshot->version == m_plottedVersion)
+				return;
+			m_plottedVersion = snapshot->version;
 
 			double plotDt = 0.1;
 			if (m_stimulusResponseDataCollection.size() > 0)
@@ -194,6 +212,19 @@ std::vector<double> SystemOptimizer::agentTestFunction(const std::vector<double>
 	std::shared_ptr<AutoTuner::TunableTimeBasedSystem> systemModel = m_agentsSystemModels[index];
 	systemModel->reset();
 	systemModel->setParameters(parameters);
+	const double outputCount = static_cast<double>(systemModel->getOutputs().size());
+
+	// Racing: the error sum only grows, divided by the full duration it is a lower bound of the final score
+	const bool racing = m_solver && m_solver->isRacingEnabled();
+	double totalTime = 0;
+	if (racing)
+	{
+		for (const auto& data : m_stimulusResponseDataCollection)
+			totalTime += data.deltaTime;
+	}
+	const size_t racingCheckInterval = std::max<size_t>(1, m_stimulusResponseDataCollection.size() / 100);
+	size_t sample = 0;
+
 	for (const auto& data : m_stimulusResponseDataCollection)
 	{
 		systemModel->setInputSignals(data.inputSignal);
@@ -206,6 +237,13 @@ std::vector<double> SystemOptimizer::agentTestFunction(const std::vector<double>
 			errorSum += error * error;
 		}
 		time += data.deltaTime;
+
+		++sample;
+		if (racing && sample % racingCheckInterval == 0 && m_solver->isRaceLost(errorSum / (totalTime * outputCount)))
+		{
+			// Assume the same mean error for the rest of the data
+			return { errorSum / (time * outputCount) };
+		}
 	}
 	double rmse = (errorSum / (time * systemModel->getOutputs().size()));
 	return { rmse };
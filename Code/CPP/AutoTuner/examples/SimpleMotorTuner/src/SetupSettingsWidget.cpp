@@ -119,6 +119,8 @@ void SetupSettingsWidget::populateComboBoxes()
 {
 	ui.solverType_comboBox->addItem("Genetic Algorithm", QVariant::fromValue(static_cast<int>(PIDTuningProblem::SolverType::GeneticAlgorithm)));
 	ui.solverType_comboBox->addItem("Differential Evolution", QVariant::fromValue(static_cast<int>(PIDTuningProblem::SolverType::DifferentialEvolution)));
+	ui.solverType_comboBox->addItem("CMA-ES", QVariant::fromValue(static_cast<int>(PIDTuningProblem::SolverType::CMAES)));
+	ui.solverType_comboBox->addItem("NSGA-II", QVariant::fromValue(static_cast<int>(PIDTuningProblem::SolverType::NSGA2)));
 
 	ui.useMinimizingScore_comboBox->addItem("Minimieren", QVariant::fromValue(true));
 	ui.useMinimizingScore_comboBox->addItem("Maximieren", QVariant::fromValue(false));
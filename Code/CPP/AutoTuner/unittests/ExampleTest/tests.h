@@ -2,4 +2,9 @@
 
 #include "test.h"
 #include "tests/TST_simple.h"
+#include "tests/TST_PIDBatch.h"
+#include "tests/TST_RandomStream.h"
+#include "tests/TST_GeneticSolver.h"
+#include "tests/TST_DCMotorWithMassNoise.h"
+#include "tests/TST_RacingCache.h"
 //#include "test_nasted.h"
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "UnitTest.h"
+#include "AutoTuner.h"
+#include "Systems/DCMotorWithMassSystem.h"
+#include <cstring>
+
+
+class TST_DCMotorWithMassNoise : public UnitTest::Test
+{
+	TEST_CLASS(TST_DCMotorWithMassNoise)
+public:
+	TST_DCMotorWithMassNoise()
+		: Test("TST_DCMotorWithMassNoise")
+	{
+		ADD_TEST(TST_DCMotorWithMassNoise::workerCountIndependent);
+
+	}
+
+private:
+	/**
+	 * @brief
+	 * Closed loop of DCMotorWithMassProblem: a PID drives the motor with mass, the measured angle carries
+	 * uniform noise. The noise stream is derived from the solver seed and the agent index, like the problem does.
+	 */
+	static std::vector<double> testAgent(const AutoTuner::Solver& solver, const std::vector<double>& parameters, size_t agent)
+	{
+		using namespace AutoTuner;
+		const double dt = 0.01;
+		PID pid(parameters[0], parameters[1], parameters[2]);
+		pid.setOutputSaturationLimits(-10, 10);
+		DCMotorWithMassSystem motor;
+		motor.setIntegrationSolver(TimeBasedSystem::IntegrationSolver::Bilinear);
+		RandomStream noise = solver.createRandomStream(Solver::s_problemStream + 1, static_cast<uint32_t>(agent));
+
+		double errorSum = 0;
+		for (double t = 0; t < 2; t += dt)
+		{
+			double reference = t < 0.5 ? 0 : 1;
+			double error = reference - motor.getOutput(1) + noise.getDouble(-1, 1) * 0.1;
+			pid.setInput(error);
+			pid.update(dt);
+			motor.setInputs(pid.getOutput(), 0);
+			motor.update(dt);
+			errorSum += std::abs(error) * dt;
+		}
+		return { errorSum };
+	}
+
+	static void setupSolver(AutoTuner::DifferentialEvolutionSolver& solver, AutoTuner::TaskScheduler& scheduler)
+	{
+		using namespace AutoTuner;
+		solver.setTaskScheduler(&scheduler);
+		solver.setSeed(1234);
+		solver.setScorePartsLabels({ "error" });
+		solver.setOptimizingDirection(Solver::OptimizingDirection::Minimize);
+		solver.setParametersTestFunc([&solver](const std::vector<double>& parameters, size_t agent)
+			{
+				return testAgent(solver, parameters, agent);
+			});
+
+		RandomStream random = solver.createRandomStream(Solver::s_populationStream);
+		std::vector<std::vector<double>> initialParameters;
+		for (size_t i = 0; i < 32; ++i)
+			initialParameters.push_back({ random.getDouble(0, 2), random.getDouble(0, 2), random.getDouble(0, 0.1) });
+		solver.setInitialParameters(initialParameters);
+	}
+
+	// Tests
+	TEST_FUNCTION(workerCountIndependent)
+	{
+		TEST_START;
+
+		using namespace AutoTuner;
+		TaskScheduler singleWorker(1);
+		TaskScheduler multipleWorkers(4);
+
+		DifferentialEvolutionSolver reference;
+		DifferentialEvolutionSolver solver;
+		setupSolver(reference, singleWorker);
+		setupSolver(solver, multipleWorkers);
+		reference.run(10);
+		solver.run(10);
+
+		const PopulationStore::Generation& expected = reference.getPopulation().getCurrent();
+		const PopulationStore::Generation& actual = solver.getPopulation().getCurrent();
+		TEST_COMPARE(actual.getAgentCount(), expected.getAgentCount());
+		if (actual.getAgentCount() != expected.getAgentCount())
+			return;
+		for (size_t parameter = 0; parameter < expected.getParameterCount(); ++parameter)
+		{
+			TEST_ASSERT_M(std::memcmp(expected.getParameterRow(parameter), actual.getParameterRow(parameter),
+				expected.getAgentCount() * sizeof(double)) == 0, "population differs between 1 and 4 workers");
+		}
+		TEST_ASSERT_M(std::memcmp(expected.getScores(), actual.getScores(),
+			expected.getAgentCount() * sizeof(double)) == 0, "scores differ between 1 and 4 workers");
+	}
+};
+
+TEST_INSTANTIATE(TST_DCMotorWithMassNoise);
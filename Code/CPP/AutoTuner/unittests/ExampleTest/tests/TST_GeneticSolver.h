@@ -0,0 +1,75 @@
+#pragma once
+
+#include "UnitTest.h"
+#include "AutoTuner.h"
+#include <cstring>
+
+
+class TST_GeneticSolver : public UnitTest::Test
+{
+	TEST_CLASS(TST_GeneticSolver)
+public:
+	TST_GeneticSolver()
+		: Test("TST_GeneticSolver")
+	{
+		ADD_TEST(TST_GeneticSolver::workerCountIndependent);
+
+	}
+
+private:
+	static void setupSolver(AutoTuner::GeneticSolver& solver, AutoTuner::TaskScheduler& scheduler, size_t islandCount)
+	{
+		using namespace AutoTuner;
+		solver.setTaskScheduler(&scheduler);
+		solver.setSeed(1234);
+		solver.setIslandCount(islandCount);
+		solver.setScorePartsLabels({ "x", "y" });
+		solver.setOptimizingDirection(Solver::OptimizingDirection::Minimize);
+		solver.setParametersTestFunc([](const std::vector<double>& parameters, size_t)
+			{
+				return std::vector<double>{ parameters[0] * parameters[0], (parameters[1] - 1) * (parameters[1] - 1) };
+			});
+
+		RandomStream random(1, 2, 3);
+		std::vector<std::vector<double>> initialParameters;
+		for (size_t i = 0; i < 64; ++i)
+			initialParameters.push_back({ random.getDouble(-5, 5), random.getDouble(-5, 5) });
+		solver.setInitialParameters(initialParameters);
+	}
+
+	// Tests
+	TEST_FUNCTION(workerCountIndependent)
+	{
+		TEST_START;
+
+		using namespace AutoTuner;
+		TaskScheduler singleWorker(1);
+		TaskScheduler multipleWorkers(4);
+
+		for (size_t islandCount : { 1, 4 })
+		{
+			GeneticSolver reference;
+			GeneticSolver solver;
+			setupSolver(reference, singleWorker, islandCount);
+			setupSolver(solver, multipleWorkers, islandCount);
+			reference.run(30);
+			solver.run(30);
+
+			const PopulationStore::Generation& expected = reference.getPopulation().getCurrent();
+			const PopulationStore::Generation& actual = solver.getPopulation().getCurrent();
+			TEST_COMPARE(actual.getAgentCount(), expected.getAgentCount());
+			TEST_COMPARE(actual.getParameterCount(), expected.getParameterCount());
+			if (actual.getAgentCount() != expected.getAgentCount() || actual.getParameterCount() != expected.getParameterCount())
+				continue;
+			for (size_t parameter = 0; parameter < expected.getParameterCount(); ++parameter)
+			{
+				TEST_ASSERT_M(std::memcmp(expected.getParameterRow(parameter), actual.getParameterRow(parameter),
+					expected.getAgentCount() * sizeof(double)) == 0, "population differs between 1 and 4 workers");
+			}
+			TEST_ASSERT_M(std::memcmp(expected.getScores(), actual.getScores(),
+				expected.getAgentCount() * sizeof(double)) == 0, "scores differ between 1 and 4 workers");
+		}
+	}
+};
+
+TEST_INSTANTIATE(TST_GeneticSolver);
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "UnitTest.h"
+#include "AutoTuner.h"
+#include <cstring>
+#include <memory>
+#include <random>
+
+
+class TST_PIDBatch : public UnitTest::Test
+{
+	TEST_CLASS(TST_PIDBatch)
+public:
+	TST_PIDBatch()
+		: Test("TST_PIDBatch")
+	{
+		ADD_TEST(TST_PIDBatch::strictMatchesScalar);
+
+	}
+
+private:
+
+	// Tests
+	TEST_FUNCTION(strictMatchesScalar)
+	{
+		TEST_START;
+
+		using namespace AutoTuner;
+		const size_t count = 7;
+		const double deltaTime = 0.01;
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<double> dist(-3, 3);
+
+		for (int antiWindup = 0; antiWindup < 3; ++antiWindup)
+		for (int derivativeType = 0; derivativeType < 2; ++derivativeType)
+		for (int solver = 0; solver < 3; ++solver)
+		{
+			PIDBatch batch(count);
+			batch.setPrecision(PIDBatch::Precision::Strict);
+			batch.setAntiWindupMethod(static_cast<PID::AntiWindupMethod>(antiWindup));
+			batch.setDerivativeType(static_cast<PID::DerivativeType>(derivativeType));
+			batch.setIntegrationSolver(static_cast<TimeBasedSystem::IntegrationSolver>(solver));
+
+			// The PID copy constructor does not copy the configuration, so no vector<PID>
+			std::vector<std::unique_ptr<PID>> pids;
+			for (size_t i = 0; i < count; ++i)
+			{
+				PID* pid = new PID(dist(rng), dist(rng) * 5, dist(rng) * 0.1, std::abs(dist(rng)) * 10);
+				pid->setAntiWindupMethod(batch.getAntiWindupMethod());
+				pid->setDerivativeType(batch.getDerivativeType());
+				pid->setIntegrationSolver(batch.getIntegrationSolver());
+				pid->setOutputSaturationLimits(-2, 2);
+				pid->setIntegralSatturationLimit(1.5);
+				pid->setAntiWindupBackCalculationConstant(dist(rng));
+				batch.setController(i, *pid);
+				pids.emplace_back(pid);
+			}
+
+			for (int step = 0; step < 500; ++step)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					double input = dist(rng);
+					batch.setInput(i, input);
+					pids[i]->setInput(input);
+					pids[i]->update(deltaTime);
+				}
+				batch.update(deltaTime);
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					double expected = pids[i]->getOutput();
+					double actual = batch.getOutput(i);
+					TEST_ASSERT_M(std::memcmp(&expected, &actual, sizeof(double)) == 0, "output differs from scalar PID");
+					TEST_COMPARE(batch.isOutputSaturated(i), pids[i]->isOutputSaturated());
+				}
+			}
+		}
+	}
+
+};
+
+TEST_INSTANTIATE(TST_PIDBatch);
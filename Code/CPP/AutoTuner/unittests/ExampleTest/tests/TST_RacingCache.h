@@ -0,0 +1,169 @@
+#pragma once
+
+#include "UnitTest.h"
+#include "AutoTuner.h"
+#include <mutex>
+
+
+class TST_RacingCache : public UnitTest::Test
+{
+	TEST_CLASS(TST_RacingCache)
+public:
+	TST_RacingCache()
+		: Test("TST_RacingCache")
+	{
+		ADD_TEST(TST_RacingCache::boundedScoresNotCached);
+		ADD_TEST(TST_RacingCache::boundedBatchScoresNotCached);
+
+	}
+
+private:
+	static constexpr size_t s_stepCount = 200;
+
+	/**
+	 * @brief
+	 * Accumulates the score over the steps of a simulation, like the motor problems do.
+	 * Once the race is lost the partial score gets extrapolated to the full horizon, which is only a bound.
+	 */
+	static double simulate(const AutoTuner::Solver& solver, const std::vector<double>& parameters, bool& raceLost)
+	{
+		double distance = 0;
+		for (double parameter : parameters)
+			distance += (parameter - 1) * (parameter - 1);
+		double score = 0;
+		raceLost = false;
+		for (size_t step = 1; step <= s_stepCount; ++step)
+		{
+			score += distance * (1 + 0.5 * std::sin(static_cast<double>(step) * 0.1)) / s_stepCount;
+			if (step % 10 == 0 && solver.isRaceLost(score))
+			{
+				raceLost = true;
+				return score * s_stepCount / static_cast<double>(step);
+			}
+		}
+		return score;
+	}
+	static double fullScore(const std::vector<double>& parameters)
+	{
+		double distance = 0;
+		for (double parameter : parameters)
+			distance += (parameter - 1) * (parameter - 1);
+		double score = 0;
+		for (size_t step = 1; step <= s_stepCount; ++step)
+			score += distance * (1 + 0.5 * std::sin(static_cast<double>(step) * 0.1)) / s_stepCount;
+		return score;
+	}
+
+	struct LostAgents
+	{
+		std::mutex mutex;
+		std::vector<std::vector<double>> parameters;
+
+		void add(const std::vector<double>& agentParameters)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			parameters.push_back(agentParameters);
+		}
+	};
+
+	static void setupSolver(AutoTuner::DifferentialEvolutionSolver& solver, AutoTuner::TaskScheduler& scheduler)
+	{
+		using namespace AutoTuner;
+		solver.setTaskScheduler(&scheduler);
+		solver.setSeed(1234);
+		solver.setScorePartsLabels({ "error" });
+		solver.setOptimizingDirection(Solver::OptimizingDirection::Minimize);
+		solver.setRacingEnabled(true);
+		solver.setRacingQuantile(0.5);
+		solver.setFitnessCacheCapacity(4096);
+
+		RandomStream random = solver.createRandomStream(Solver::s_populationStream);
+		std::vector<std::vector<double>> initialParameters;
+		for (size_t i = 0; i < 32; ++i)
+			initialParameters.push_back({ random.getDouble(-5, 5), random.getDouble(-5, 5) });
+		solver.setInitialParameters(initialParameters);
+	}
+
+	/**
+	 * @brief
+	 * Every aborted agent that is still found in the cache must have been tested to the end later on.
+	 * The best agent must carry its true score, a bound never wins the selection.
+	 */
+	static void checkCache(AutoTuner::DifferentialEvolutionSolver& solver, const LostAgents& lostAgents)
+	{
+		using namespace AutoTuner;
+		TEST_ASSERT_M(solver.getRacingAbortCount() > 0, "no agent lost the race");
+		TEST_ASSERT_M(!lostAgents.parameters.empty(), "no agent was marked as lost");
+
+		FitnessCache& cache = solver.getFitnessCache();
+		std::vector<double> scoreParts;
+		for (const std::vector<double>& parameters : lostAgents.parameters)
+		{
+			if (!cache.lookup(parameters, scoreParts))
+				continue;
+			TEST_COMPARE(scoreParts.size(), size_t(1));
+			if (scoreParts.size() == 1)
+				TEST_ASSERT_M(scoreParts[0] == fullScore(parameters), "bounded score of a lost agent got cached");
+		}
+
+		std::vector<double> best = solver.getBestParameters();
+		const PopulationStore::Generation& population = solver.getPopulation().getCurrent();
+		double bestScore = population.getScore(0);
+		for (size_t i = 1; i < population.getAgentCount(); ++i)
+			bestScore = std::min(bestScore, population.getScore(i));
+		TEST_ASSERT_M(bestScore == fullScore(best), "best agent carries a bounded score");
+	}
+
+	// Tests
+	TEST_FUNCTION(boundedScoresNotCached)
+	{
+		TEST_START;
+
+		using namespace AutoTuner;
+		TaskScheduler scheduler(4);
+		DifferentialEvolutionSolver solver;
+		setupSolver(solver, scheduler);
+		LostAgents lostAgents;
+		solver.setParametersTestFunc([&solver, &lostAgents](const std::vector<double>& parameters, size_t)
+			{
+				bool raceLost;
+				double score = simulate(solver, parameters, raceLost);
+				if (raceLost)
+					lostAgents.add(parameters);
+				return std::vector<double>{ score };
+			});
+		solver.run(20);
+		checkCache(solver, lostAgents);
+	}
+
+	TEST_FUNCTION(boundedBatchScoresNotCached)
+	{
+		TEST_START;
+
+		using namespace AutoTuner;
+		TaskScheduler scheduler(4);
+		DifferentialEvolutionSolver solver;
+		setupSolver(solver, scheduler);
+		LostAgents lostAgents;
+		solver.setParametersBatchTestFunc([&solver, &lostAgents](const PopulationStore::AgentBlock& block)
+			{
+				std::vector<double> parameters(block.parameterCount);
+				for (size_t agent = 0; agent < block.count; ++agent)
+				{
+					for (size_t parameter = 0; parameter < block.parameterCount; ++parameter)
+						parameters[parameter] = block.getParameter(agent, parameter);
+					bool raceLost;
+					block.setScorePart(agent, 0, simulate(solver, parameters, raceLost));
+					if (raceLost)
+					{
+						block.setRaceLost(agent);
+						lostAgents.add(parameters);
+					}
+				}
+			});
+		solver.run(20);
+		checkCache(solver, lostAgents);
+	}
+};
+
+TEST_INSTANTIATE(TST_RacingCache);
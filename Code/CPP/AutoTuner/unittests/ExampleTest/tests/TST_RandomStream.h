@@ -0,0 +1,81 @@
+#pragma once
+
+#include "UnitTest.h"
+#include "AutoTuner.h"
+#include <cstring>
+
+
+class TST_RandomStream : public UnitTest::Test
+{
+	TEST_CLASS(TST_RandomStream)
+public:
+	TST_RandomStream()
+		: Test("TST_RandomStream")
+	{
+		ADD_TEST(TST_RandomStream::philoxKnownAnswers);
+		ADD_TEST(TST_RandomStream::streamReadsBlocksInOrder);
+
+	}
+
+private:
+
+	// Tests
+	TEST_FUNCTION(philoxKnownAnswers)
+	{
+		TEST_START;
+
+		// Known answers of Philox4x32-10 from the Random123 reference.
+		// The block is counter word 0 and 1, the streams are word 2 and 3, the seed is the key.
+		struct KnownAnswer
+		{
+			uint64_t seed;
+			uint32_t streamA;
+			uint32_t streamB;
+			uint64_t block;
+			uint32_t expected[4];
+		};
+		const KnownAnswer answers[] = {
+			{ 0, 0, 0, 0, { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } },
+			{ 0xffffffffffffffff, 0xffffffff, 0xffffffff, 0xffffffffffffffff, { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd } },
+			{ 0x299f31d0a4093822, 0x13198a2e, 0x03707344, 0x85a308d3243f6a88, { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } },
+		};
+
+		for (const KnownAnswer& answer : answers)
+		{
+			AutoTuner::RandomStream random(answer.seed, answer.streamA, answer.streamB);
+			uint32_t block[4];
+			random.getBlock(answer.block, block);
+			for (size_t i = 0; i < 4; ++i)
+				TEST_COMPARE(block[i], answer.expected[i]);
+		}
+	}
+
+	TEST_FUNCTION(streamReadsBlocksInOrder)
+	{
+		TEST_START;
+
+		AutoTuner::RandomStream random(42, 1, 2);
+		for (uint64_t blockIndex = 0; blockIndex < 8; ++blockIndex)
+		{
+			uint32_t block[4];
+			random.getBlock(blockIndex, block);
+			for (size_t i = 0; i < 4; ++i)
+			{
+				uint32_t value = random.nextUInt32();
+				TEST_COMPARE(value, block[i]);
+			}
+		}
+
+		// The same seed and streams restart the same sequence
+		random.setSeed(42, 1, 2);
+		AutoTuner::RandomStream copy(42, 1, 2);
+		for (size_t i = 0; i < 100; ++i)
+		{
+			double expected = copy.nextDouble();
+			double actual = random.nextDouble();
+			TEST_ASSERT_M(std::memcmp(&expected, &actual, sizeof(double)) == 0, "restarted stream differs");
+		}
+	}
+};
+
+TEST_INSTANTIATE(TST_RandomStream);